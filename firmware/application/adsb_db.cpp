@@ -0,0 +1,217 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "adsb_db.hpp"
+
+#include <cstring>
+#include <array>
+
+namespace adsb {
+
+bool SortedDatabase::open(const std::filesystem::path& path) {
+	if (file.open(path).is_valid())
+		return false;
+	
+	struct {
+		char magic[4];
+		uint16_t version;
+		uint16_t key_size;
+		uint16_t record_size;
+		uint16_t reserved;
+		uint32_t count;
+	} header;
+	static_assert(sizeof(header) == 16, "Database header packing");
+	
+	const auto read = file.read(&header, sizeof(header));
+	if (read.is_error() || (read.value() != sizeof(header)))
+		return false;
+	
+	if (memcmp(header.magic, "PPDB", 4) == 0) {
+		if ((header.version != 1) || (header.key_size > key_size_max))
+			return false;
+		
+		key_size = header.key_size;
+		record_size = header.record_size;
+		count = header.count;
+		keys_offset = sizeof(header);
+		records_offset = keys_offset + count * key_size;
+		zero_key_is_end = false;
+	} else {
+		// Original airlines.db
+		key_size = 4;
+		record_size = 64;
+		count = 0x2000 / 4;
+		keys_offset = 0;
+		records_offset = 0x2000;
+		zero_key_is_end = true;
+	}
+	
+	return true;
+}
+
+bool SortedDatabase::find(const void* const key, const size_t key_size, void* const record, const size_t record_size) {
+	if ((key_size != this->key_size) || (record_size > this->record_size))
+		return false;
+	
+	uint8_t file_key[key_size_max];
+	uint32_t low = 0;
+	uint32_t high = count;
+	
+	while (low < high) {
+		const uint32_t mid = (low + high) / 2;
+		file.seek(keys_offset + mid * key_size);
+		const auto read = file.read(file_key, key_size);
+		if (read.is_error() || (read.value() != key_size))
+			return false;
+		
+		int compare = memcmp(file_key, key, key_size);
+		if (zero_key_is_end && !file_key[0])
+			compare = 1;
+		
+		if (compare < 0) {
+			low = mid + 1;
+		} else if (compare > 0) {
+			high = mid;
+		} else {
+			file.seek(records_offset + mid * this->record_size);
+			const auto read_record = file.read(record, record_size);
+			return !read_record.is_error() && (read_record.value() == record_size);
+		}
+	}
+	
+	return false;
+}
+
+namespace {
+
+template<typename Key, typename Info, size_t N>
+class LookupCache {
+public:
+	const Info* find(const Key& key) {
+		for (auto& entry : entries) {
+			if (entry.used && (entry.key == key)) {
+				entry.last_used = ++clock;
+				return &entry.info;
+			}
+		}
+		return nullptr;
+	}
+	
+	void insert(const Key& key, const Info& info) {
+		auto lru = &entries[0];
+		for (auto& entry : entries) {
+			if (!entry.used) {
+				lru = &entry;
+				break;
+			}
+			if (entry.last_used < lru->last_used)
+				lru = &entry;
+		}
+		*lru = { true, key, info, ++clock };
+	}
+
+private:
+	struct Entry {
+		bool used;
+		Key key;
+		Info info;
+		uint32_t last_used;
+	};
+	
+	std::array<Entry, N> entries { };
+	uint32_t clock { 0 };
+};
+
+LookupCache<std::string, AirlineInfo, 8> airline_cache { };
+LookupCache<uint32_t, AircraftInfo, 16> aircraft_cache { };
+
+std::string field_string(const char* const field, const size_t size) {
+	return std::string(field, strnlen(field, size));
+}
+
+} /* namespace */
+
+AirlineInfo lookup_airline(const std::string& callsign) {
+	const auto code = callsign.substr(0, 3);
+	const auto cached = airline_cache.find(code);
+	if (cached)
+		return *cached;
+	
+	AirlineInfo info { };
+	SortedDatabase db { };
+	if (!db.open("ADSB/airlines.db"))
+		return info;
+	
+	char key[4] { 0 };
+	memcpy(key, code.data(), code.size());
+	
+	struct {
+		char name[32];
+		char country[32];
+	} record;
+	
+	if (db.find(key, sizeof(key), &record, sizeof(record))) {
+		info.status = LookupStatus::Found;
+		info.name = field_string(record.name, sizeof(record.name));
+		info.country = field_string(record.country, sizeof(record.country));
+	} else {
+		info.status = LookupStatus::Unknown;
+	}
+	
+	airline_cache.insert(code, info);
+	return info;
+}
+
+AircraftInfo lookup_aircraft(const uint32_t icao_address) {
+	const auto cached = aircraft_cache.find(icao_address);
+	if (cached)
+		return *cached;
+	
+	AircraftInfo info { };
+	SortedDatabase db { };
+	if (!db.open("ADSB/icao24.db"))
+		return info;
+	
+	// Big-endian, so the byte order sorts like the address
+	const uint8_t key[3] {
+		static_cast<uint8_t>(icao_address >> 16),
+		static_cast<uint8_t>(icao_address >> 8),
+		static_cast<uint8_t>(icao_address)
+	};
+	
+	struct {
+		char registration[8];
+		char type[8];
+		char owner[16];
+	} record;
+	
+	if (db.find(key, sizeof(key), &record, sizeof(record))) {
+		info.status = LookupStatus::Found;
+		info.registration = field_string(record.registration, sizeof(record.registration));
+		info.type = field_string(record.type, sizeof(record.type));
+		info.owner = field_string(record.owner, sizeof(record.owner));
+	} else {
+		info.status = LookupStatus::Unknown;
+	}
+	
+	aircraft_cache.insert(icao_address, info);
+	return info;
+}
+
+} /* namespace adsb */
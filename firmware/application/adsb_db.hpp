@@ -0,0 +1,90 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __ADSB_DB_H__
+#define __ADSB_DB_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "file.hpp"
+
+namespace adsb {
+
+/* Fixed-size records behind a sorted key table, searched in place on the SD
+ * card. Generated by tools/adsb_db.py, all values little-endian:
+ *	char[4]		"PPDB"
+ *	u16			version (1)
+ *	u16			key size
+ *	u16			record size
+ *	u16			reserved
+ *	u32			record count
+ *	keys		count * key size, sorted, zero padded
+ *	records		count * record size, same order
+ *
+ * The original airlines.db (4 byte codes up to 0x2000, zero terminated,
+ * then 64 byte records) is read as well.
+ */
+class SortedDatabase {
+public:
+	static constexpr size_t key_size_max = 8;
+
+	bool open(const std::filesystem::path& path);
+	bool find(const void* const key, const size_t key_size, void* const record, const size_t record_size);
+
+private:
+	File file { };
+	uint32_t count { 0 };
+	uint32_t keys_offset { 0 };
+	uint32_t records_offset { 0 };
+	uint16_t key_size { 0 };
+	uint16_t record_size { 0 };
+	// Legacy airlines.db pads its index with zero keys
+	bool zero_key_is_end { false };
+};
+
+enum class LookupStatus {
+	Found,
+	Unknown,
+	NoDatabase
+};
+
+struct AirlineInfo {
+	LookupStatus status { LookupStatus::NoDatabase };
+	std::string name { };
+	std::string country { };
+};
+
+struct AircraftInfo {
+	LookupStatus status { LookupStatus::NoDatabase };
+	std::string registration { };
+	std::string type { };
+	std::string owner { };
+};
+
+/* Both keep the last few answers in RAM, so repeated lookups for the same
+ * traffic don't touch the card.
+ */
+AirlineInfo lookup_airline(const std::string& callsign);
+AircraftInfo lookup_aircraft(const uint32_t icao_address);
+
+} /* namespace adsb */
+
+#endif/*__ADSB_DB_H__*/
@@ -65,9 +65,9 @@ struct AISRecentEntry {
 	static constexpr Key invalid_key = 0xffffffff;
 
 	ais::MMSI mmsi;
-	std::string name;
-	std::string call_sign;
-	std::string destination;
+	RecentEntryString<20> name;
+	RecentEntryString<7> call_sign;
+	RecentEntryString<20> destination;
 	AISPosition last_position;
 	size_t received_count;
 	int8_t navigational_status;
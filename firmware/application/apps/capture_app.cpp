@@ -42,6 +42,8 @@ CaptureAppView::CaptureAppView(NavigationView& nav) {
 		&field_lna,
 		&field_vga,
 		&option_bandwidth,
+		&option_format,
+		&option_filter,
 		&record_view,
 		&waterfall,
 	});
@@ -72,13 +74,16 @@ CaptureAppView::CaptureAppView(NavigationView& nav) {
 		this->field_frequency.set_step(v);
 	};
 	
-	option_bandwidth.on_change = [this](size_t, uint32_t base_rate) {
-		sampling_rate = 8 * base_rate;	// Decimation by 8 done on baseband side
-		
-		waterfall.on_hide();
-		record_view.set_sampling_rate(sampling_rate);
-		receiver_model.set_sampling_rate(sampling_rate);
-		waterfall.on_show();
+	option_bandwidth.on_change = [this](size_t, OptionsField::value_t) {
+		this->update_capture_chain();
+	};
+	
+	option_filter.on_change = [this](size_t, OptionsField::value_t) {
+		this->update_capture_chain();
+	};
+	
+	option_format.on_change = [this](size_t, OptionsField::value_t v) {
+		record_view.set_file_type(static_cast<RecordView::FileType>(v));
 	};
 	
 	option_bandwidth.set_selected_index(7);		// 500k
@@ -92,6 +97,24 @@ CaptureAppView::CaptureAppView(NavigationView& nav) {
 	};
 }
 
+void CaptureAppView::update_capture_chain() {
+	const uint32_t base_rate = option_bandwidth.selected_index_value();
+	
+	// Decimate by 8 on the baseband side when the rate allows, less for wide captures
+	size_t decimation = 8;
+	while ((decimation > 2) && (base_rate * decimation > baseband_rate_max))
+		decimation /= 2;
+	
+	sampling_rate = base_rate * decimation;
+	
+	waterfall.on_hide();
+	record_view.set_decimation(decimation);
+	record_view.set_sampling_rate(sampling_rate);
+	baseband::set_capture_chain(decimation, option_filter.selected_index_value() != 0);
+	receiver_model.set_sampling_rate(sampling_rate);
+	waterfall.on_show();
+}
+
 CaptureAppView::~CaptureAppView() {
 
 	// Hack for preventing halting other apps
@@ -49,11 +49,15 @@ private:
 
 	uint32_t sampling_rate = 0;
 	static constexpr uint32_t baseband_bandwidth = 2500000;
+	static constexpr uint32_t baseband_rate_max = 4000000;
 
 	void on_tuning_frequency_changed(rf::Frequency f);
+	void update_capture_chain();
 
 	Labels labels {
 		{ { 0 * 8, 1 * 16 }, "Rate:", Color::light_grey() },
+		{ { 11 * 8, 1 * 16 }, "Fmt:", Color::light_grey() },
+		{ { 19 * 8, 1 * 16 }, "Filt:", Color::light_grey() },
 	};
 	
 	RSSI rssi {
@@ -95,7 +99,27 @@ private:
 			{ " 50k ", 50000 },
 			{ "100k ", 100000 },
 			{ "250k ", 250000 },
-			{ "500k ", 500000 }
+			{ "500k ", 500000 },
+			{ "  1M ", 1000000 },
+			{ "  2M ", 2000000 }
+		}
+	};
+
+	OptionsField option_format {
+		{ 15 * 8, 1 * 16 },
+		3,
+		{
+			{ "C16", RecordView::FileType::RawS16 },
+			{ " C8", RecordView::FileType::RawS8 }
+		}
+	};
+
+	OptionsField option_filter {
+		{ 24 * 8, 1 * 16 },
+		6,
+		{
+			{ "Wide  ", 0 },
+			{ "Narrow", 1 }
 		}
 	};
 	
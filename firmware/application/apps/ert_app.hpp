@@ -61,6 +61,10 @@ struct ERTKey {
 	}
 };
 
+inline uint32_t recent_entries_hash(const ERTKey& key) {
+	return key.id * 31 + key.commodity_type;
+}
+
 struct ERTRecentEntry {
 	using Key = ERTKey;
 
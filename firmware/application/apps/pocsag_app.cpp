@@ -33,7 +33,9 @@ using namespace pocsag;
 
 void POCSAGLogger::log_raw_data(const pocsag::POCSAGPacket& packet, const uint32_t frequency) {
 	std::string entry = "Raw: F:" + to_string_dec_uint(frequency) + "Hz " +
-						pocsag::bitrate_str(packet.bitrate()) + " Codewords:";
+						pocsag::bitrate_str(packet.bitrate()) +
+						" Fixed:" + to_string_dec_uint(packet.corrected()) +
+						" Bad:" + to_string_dec_uint(packet.uncorrectable()) + " Codewords:";
 	
 	// Raw hex dump of all the codewords
 	for (size_t c = 0; c < 16; c++)
@@ -161,6 +163,8 @@ void POCSAGAppView::on_packet(const POCSAGPacketMessage * message) {
 		console_info += " " + pocsag::bitrate_str(message->packet.bitrate());
 		console_info += " ADDR:" + to_string_dec_uint(pocsag_state.address);
 		console_info += " F" + to_string_dec_uint(pocsag_state.function);
+		if (message->packet.uncorrectable())
+			console_info += " BAD:" + to_string_dec_uint(message->packet.uncorrectable());
 
 		// Store last received address for POCSAG TX
 		persistent_memory::set_pocsag_last_address(pocsag_state.address);
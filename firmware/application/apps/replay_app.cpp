@@ -127,11 +127,18 @@ void ReplayAppView::start() {
 
 	if( reader ) {
 		button_play.set_bitmap(&bitmap_stop);
-		baseband::set_sample_rate(sample_rate * 8);
+		// Interpolate as far as the baseband rate allows, moving the DAC images
+		// further out of the baseband filter for low rate files
+		interpolation = 16;
+		while ((interpolation > 4) && (sample_rate * interpolation > baseband_rate_max))
+			interpolation /= 2;
+		
+		baseband::set_sample_rate(sample_rate * interpolation);
 		
 		replay_thread = std::make_unique<ReplayThread>(
 			std::move(reader),
 			read_size, buffer_count,
+			interpolation,
 			&ready_signal,
 			[](uint32_t return_code) {
 				ReplayThreadDoneMessage message { return_code };
@@ -142,7 +149,7 @@ void ReplayAppView::start() {
 	
 	radio::enable({
 		receiver_model.tuning_frequency(),
-		sample_rate * 8 ,
+		sample_rate * interpolation,
 		baseband_bandwidth,
 		rf::Direction::Transmit,
 		receiver_model.rf_amp(),
@@ -51,7 +51,9 @@ private:
 	static constexpr ui::Dim header_height = 3 * 16;
 	
 	uint32_t sample_rate = 0;
+	size_t interpolation = 8;
 	static constexpr uint32_t baseband_bandwidth = 2500000;
+	static constexpr uint32_t baseband_rate_max = 4000000;
 	const size_t read_size { 16384 };
 	const size_t buffer_count { 3 };
 
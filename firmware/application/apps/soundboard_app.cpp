@@ -80,6 +80,7 @@ void SoundBoardView::start_tx(const uint32_t id) {
 	auto reader = std::make_unique<WAVFileReader>();
 	uint32_t tone_key_index = options_tone_key.selected_index();
 	uint32_t sample_rate;
+	uint32_t bits_per_sample;
 	
 	stop();
 
@@ -95,10 +96,12 @@ void SoundBoardView::start_tx(const uint32_t id) {
 	//button_play.set_bitmap(&bitmap_stop);
 	
 	sample_rate = reader->sample_rate();
+	bits_per_sample = reader->bits_per_sample();
 	
 	replay_thread = std::make_unique<ReplayThread>(
 		std::move(reader),
 		read_size, buffer_count,
+		1,		// Audio samples go out at the file rate
 		&ready_signal,
 		[](uint32_t return_code) {
 			ReplayThreadDoneMessage message { return_code };
@@ -110,7 +113,8 @@ void SoundBoardView::start_tx(const uint32_t id) {
 		1536000 / 20,		// Update vu-meter at 20Hz
 		transmitter_model.channel_bandwidth(),
 		0,	// Gain is unused
-		TONES_F2D(tone_key_frequency(tone_key_index), 1536000)
+		TONES_F2D(tone_key_frequency(tone_key_index), 1536000),
+		bits_per_sample
 	);
 	baseband::set_sample_rate(sample_rate);
 	
@@ -155,7 +159,7 @@ void SoundBoardView::refresh_list() {
 				if (entry_extension == ".WAV") {
 					
 					if (reader->open(u"/WAV/" + entry.path().native())) {
-						if ((reader->channels() == 1) && (reader->bits_per_sample() == 8)) {
+						if ((reader->channels() == 1) && ((reader->bits_per_sample() == 8) || (reader->bits_per_sample() == 16))) {
 							//sounds[c].ms_duration = reader->ms_duration();
 							//sounds[c].path = u"WAV/" + entry.path().native();
 							file_list.push_back(entry.path());
@@ -22,6 +22,7 @@
 
 #include "ui_adsb_rx.hpp"
 #include "ui_alphanum.hpp"
+#include "adsb_db.hpp"
 
 #include "rtc_time.hpp"
 #include "string_format.hpp"
@@ -58,9 +59,9 @@ void RecentEntriesTable<AircraftRecentEntries>::draw(
 	std::string entry_string = "\x1B";
 	entry_string += aged_color;
 	entry_string += to_string_hex(entry.ICAO_address, 6) + " " +
-		entry.callsign + "  " +
+		entry.callsign.str() + "  " +
 		(entry.hits <= 999 ? to_string_dec_uint(entry.hits, 4) : "999+") + " " + 
-		entry.time_string;
+		entry.time_string.str();
 	
 	painter.draw_string(
 		target_rect.location(),
@@ -111,11 +112,6 @@ ADSBRxDetailsView::ADSBRxDetailsView(
 ) : entry_copy(entry),
 	on_close_(on_close)
 {
-	char file_buffer[32] { 0 };
-	bool found = false;
-	std::string airline_code;
-	size_t c;
-	
 	add_children({
 		&labels,
 		&text_callsign,
@@ -123,6 +119,7 @@ ADSBRxDetailsView::ADSBRxDetailsView(
 		&text_airline,
 		&text_country,
 		&text_infos,
+		&text_registration,
 		&text_frame_pos_even,
 		&text_frame_pos_odd,
 		&button_see_map
@@ -132,37 +129,26 @@ ADSBRxDetailsView::ADSBRxDetailsView(
 	update(entry_copy);
 
 	// The following won't (shouldn't !) change for a given airborne aircraft
-	// Try getting the airline's name from airlines.db
-	auto result = db_file.open("ADSB/airlines.db");
-	if (!result.is_valid()) {
-		// Search for 3-letter code in 0x0000~0x2000
-		airline_code = entry_copy.callsign.substr(0, 3);
-		c = 0;
-		do {
-			db_file.read(file_buffer, 4);
-			if (!file_buffer[0])
-				break;
-			if (!airline_code.compare(0, 4, file_buffer))
-				found = true;
-			else
-				c++;
-		} while (!found);
-		
-		if (found) {
-			db_file.seek(0x2000 + (c << 6));
-			db_file.read(file_buffer, 32);
-			text_airline.set(file_buffer);
-			db_file.read(file_buffer, 32);
-			text_country.set(file_buffer);
-		} else {
-			text_airline.set("Unknown");
-			text_country.set("Unknown");
-		}
+	const auto airline = adsb::lookup_airline(entry_copy.callsign);
+	if (airline.status == adsb::LookupStatus::Found) {
+		text_airline.set(airline.name);
+		text_country.set(airline.country);
+	} else if (airline.status == adsb::LookupStatus::Unknown) {
+		text_airline.set("Unknown");
+		text_country.set("Unknown");
 	} else {
 		text_airline.set("No airlines.db file");
 		text_country.set("No airlines.db file");
 	}
 	
+	const auto aircraft = adsb::lookup_aircraft(entry_copy.ICAO_address);
+	if (aircraft.status == adsb::LookupStatus::Found)
+		text_registration.set(aircraft.registration + " " + aircraft.type + " " + aircraft.owner);
+	else if (aircraft.status == adsb::LookupStatus::Unknown)
+		text_registration.set("Unknown");
+	else
+		text_registration.set("No icao24.db file");
+	
 	text_callsign.set(entry_copy.callsign);
 	
 	button_see_map.on_select = [this, &nav](Button&) {
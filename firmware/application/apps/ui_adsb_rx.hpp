@@ -53,9 +53,9 @@ struct AircraftRecentEntry {
 	ADSBFrame frame_pos_even { };
 	ADSBFrame frame_pos_odd { };
 	
-	std::string callsign { "        " };
-	std::string time_string { "" };
-	std::string info_string { "" };
+	RecentEntryString<8> callsign { "        " };
+	RecentEntryString<8> time_string { };
+	RecentEntryString<32> info_string { };
 	
 	AircraftRecentEntry(
 		const uint32_t ICAO_address
@@ -139,13 +139,13 @@ private:
 	std::function<void(void)> on_close_ { };
 	GeoMapView* geomap_view { nullptr };
 	bool send_updates { false };
-	File db_file { };
 	
 	Labels labels {
 		{ { 0 * 8, 1 * 16 }, "Callsign:", Color::light_grey() },
 		{ { 0 * 8, 2 * 16 }, "Last seen:", Color::light_grey() },
 		{ { 0 * 8, 3 * 16 }, "Airline:", Color::light_grey() },
 		{ { 0 * 8, 5 * 16 }, "Country:", Color::light_grey() },
+		{ { 0 * 8, 7 * 16 }, "Reg:", Color::light_grey() },
 		{ { 0 * 8, 12 * 16 }, "Even position frame:", Color::light_grey() },
 		{ { 0 * 8, 14 * 16 }, "Odd position frame:", Color::light_grey() }
 	};
@@ -174,6 +174,12 @@ private:
 		{ 0 * 8, 6 * 16, 30 * 8, 16 },
 		"-"
 	};
+	
+	Text text_registration {
+		{ 4 * 8, 7 * 16, 26 * 8, 16 },
+		"-"
+	};
+	
 	Text text_frame_pos_even {
 		{ 0 * 8, 13 * 16, 30 * 8, 16 },
 		"-"
@@ -24,6 +24,7 @@
 #include "ui_modemsetup.hpp"
 
 #include "modems.hpp"
+#include "aprs.hpp"
 #include "audio.hpp"
 #include "rtc_time.hpp"
 #include "baseband_api.hpp"
@@ -33,6 +34,18 @@
 using namespace portapack;
 using namespace modems;
 
+// Non-printable bytes (Mic-E info fields carry some) as [hh], like on_data()
+static std::string printable_string(const std::string& s) {
+	std::string result;
+	for (const auto c : s) {
+		if ((c >= 32) && (c < 127))
+			result += c;
+		else
+			result += "[" + to_string_hex((uint8_t)c, 2) + "]";
+	}
+	return result;
+}
+
 void AFSKLogger::log_raw_data(const std::string& data) {
 	rtc::RTC datetime;
 	rtcGetTime(&RTCD1, &datetime);
@@ -62,6 +75,7 @@ AFSKRxView::AFSKRxView(NavigationView& nav) {
 		&field_frequency,
 		&text_debug,
 		&button_modem_setup,
+		&options_mode,
 		&record_view,
 		&console
 	});
@@ -104,8 +118,10 @@ AFSKRxView::AFSKRxView(NavigationView& nav) {
 	if (logger)
 		logger->append("AFSK_LOG.TXT");
 	
-	// Auto-configure modem for LCR RX (will be removed later)
-	baseband::set_afsk(persistent_memory::modem_baudrate(), 8, 0, false);
+	options_mode.on_change = [this](size_t mode, OptionsField::value_t) {
+		set_mode(mode);
+	};
+	set_mode(options_mode.selected_index());
 	
 	audio::set_rate(audio::Rate::Hz_24000);
 	audio::output::start();
@@ -116,6 +132,34 @@ AFSKRxView::AFSKRxView(NavigationView& nav) {
 	receiver_model.enable();
 }
 
+void AFSKRxView::set_mode(const size_t mode) {
+	if (mode == 1) {
+		// AX.25 frames are deframed and checked in the baseband
+		baseband::set_afsk(1200, 8, 0, true);
+	} else {
+		// Auto-configure modem for LCR RX (will be removed later)
+		baseband::set_afsk(persistent_memory::modem_baudrate(), 8, 0, false);
+	}
+}
+
+void AFSKRxView::on_packet(const AX25PacketMessage& message) {
+	const ax25::Packet packet { message.frame.data(), message.length };
+	if (!packet.is_valid())
+		return;
+	
+	std::string str_console = "\x1B";
+	str_console += (char)((console_color++ & 3) + 9);
+	str_console += packet.path_string() + ":";
+	
+	if (packet.is_ui())
+		str_console += aprs::APRSPacket(packet).to_string();
+	
+	console.writeln(str_console);
+	
+	if (logger)
+		logger->log_raw_data(packet.path_string() + ":" + printable_string(packet.info()));
+}
+
 void AFSKRxView::on_data(uint32_t value, bool is_data) {
 	std::string str_console = "\x1B";
 	std::string str_byte = "";
@@ -56,6 +56,8 @@ public:
 	
 private:
 	void on_data(uint32_t value, bool is_data);
+	void on_packet(const AX25PacketMessage& message);
+	void set_mode(const size_t mode);
 	
 	uint8_t console_color { 0 };
 	uint32_t prev_value { 0 };
@@ -92,6 +94,15 @@ private:
 		"Modem setup"
 	};
 	
+	OptionsField options_mode {
+		{ 0 * 8, 2 * 16 },
+		6,
+		{
+			{ "Serial", 0 },
+			{ "APRS", 1 }
+		}
+	};
+	
 	// DEBUG
 	RecordView record_view {
 		{ 0 * 8, 3 * 16, 30 * 8, 1 * 16 },
@@ -114,6 +125,13 @@ private:
 			this->on_data(message->value, message->is_data);
 		}
 	};
+	
+	MessageHandlerRegistration message_handler_ax25 {
+		Message::ID::AX25Packet,
+		[this](const Message* const p) {
+			this->on_packet(*reinterpret_cast<const AX25PacketMessage*>(p));
+		}
+	};
 };
 
 } /* namespace ui */
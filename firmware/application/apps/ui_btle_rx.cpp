@@ -40,8 +40,49 @@ void BTLERxView::focus() {
 	field_frequency.focus();
 }
 
+static rf::Frequency channel_frequency(const uint8_t channel_number) {
+	switch (channel_number) {
+		case 37: return 2402000000;
+		case 38: return 2426000000;
+		case 39: return 2480000000;
+		default:
+			// Data channels skip over 2426MHz
+			return 2404000000 + (channel_number + ((channel_number > 10) ? 1 : 0)) * 2000000;
+	}
+}
+
+static uint8_t frequency_channel(const rf::Frequency f) {
+	const int32_t rf_channel = (f - 2402000000 + 1000000) / 2000000;
+	
+	if (rf_channel <= 0) return 37;
+	if (rf_channel < 12) return rf_channel - 1;
+	if (rf_channel == 12) return 38;
+	if (rf_channel < 39) return rf_channel - 2;
+	return 39;
+}
+
 void BTLERxView::update_freq(rf::Frequency f) {
 	receiver_model.set_tuning_frequency(f);
+	
+	// Dewhitening is seeded by the channel index
+	baseband::set_btle(persistent_memory::modem_baudrate(), 8, 0, false, frequency_channel(f));
+}
+
+void BTLERxView::set_channel(const uint8_t channel_number) {
+	const auto f = channel_frequency(channel_number);
+	// field_frequency's on_change tunes, unless it already shows f
+	if (field_frequency.value() == f)
+		update_freq(f);
+	else
+		field_frequency.set_value(f);
+}
+
+void BTLERxView::on_tick_second() {
+	if (static_cast<int32_t>(options_channel.selected_index_value()) != channel_hop)
+		return;
+	
+	hop_index = (hop_index + 1) % 3;
+	set_channel(37 + hop_index);
 }
 
 BTLERxView::BTLERxView(NavigationView& nav) {
@@ -54,7 +95,7 @@ BTLERxView::BTLERxView(NavigationView& nav) {
 		&field_lna,
 		&field_vga,
 		&field_frequency,
-		&text_debug,
+		&options_channel,
 		&button_modem_setup,
 		&record_view,
 		&console
@@ -67,7 +108,6 @@ BTLERxView::BTLERxView(NavigationView& nav) {
 	record_view.set_sampling_rate(24000);
 	
 	// Auto-configure modem for LCR RX (will be removed later)
-	update_freq(2426000000);
 	auto def_bell202 = &modem_defs[0];
 	persistent_memory::set_modem_baudrate(def_bell202->baudrate);
 	serial_format_t serial_format;
@@ -77,8 +117,7 @@ BTLERxView::BTLERxView(NavigationView& nav) {
 	serial_format.bit_order = LSB_FIRST;
 	persistent_memory::set_serial_format(serial_format);
 	
-	field_frequency.set_value(receiver_model.tuning_frequency());
-	field_frequency.set_step(100);
+	field_frequency.set_step(2000000);
 	field_frequency.on_change = [this](rf::Frequency f) {
 		update_freq(f);
 	};
@@ -94,9 +133,16 @@ BTLERxView::BTLERxView(NavigationView& nav) {
 		nav.push<ModemSetupView>();
 	};
 	
+
+	options_channel.on_change = [this](size_t, int32_t v) {
+		if (v != channel_hop)
+			set_channel(v);
+	};
+	options_channel.set_selected_index(1);		// Ch38, the old default
 	
-	// Auto-configure modem for LCR RX (will be removed later)
-	baseband::set_btle(persistent_memory::modem_baudrate(), 8, 0, false);
+	signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+		this->on_tick_second();
+	};
 	
 	audio::set_rate(audio::Rate::Hz_24000);
 	audio::output::start();
@@ -107,51 +153,29 @@ BTLERxView::BTLERxView(NavigationView& nav) {
 	receiver_model.enable();
 }
 
-void BTLERxView::on_data(uint32_t value, bool is_data) {
-	//std::string str_console = "\x1B";
-	std::string str_console = "";
-	if (is_data) {
-		// Colorize differently after message splits
-		//str_console += (char)((console_color & 3) + 9);
-		
-		//value &= 0xFF;											// ABCDEFGH
-		//value = ((value & 0xF0) >> 4) | ((value & 0x0F) << 4);	// EFGHABCD
-		//value = ((value & 0xCC) >> 2) | ((value & 0x33) << 2);	// GHEFCDAB
-		//value = ((value & 0xAA) >> 1) | ((value & 0x55) << 1);	// HGFEDCBA
-		//value &= 0x7F;											// Ignore parity, which is the MSB now
-		
-		//if ((value >= 32) && (value < 127)) {
-		//	str_console += (char)value;							// Printable
-		//} 
-		
-		//str_console += (char)'A';
-		//str_console += (char)value;
-		//str_console += "[" + to_string_hex(value, 2) + "]";	
-		str_console += ":" + to_string_hex(value, 2) ;	
-		console.write(str_console);
-		
-		
-		
-		/*if ((value != 0x7F) && (prev_value == 0x7F)) {
-			// Message split
-			console.writeln("");
-			console_color++;
-			
-			
-		}*/
-		//prev_value = value;
-	} else {
-		// Baudrate estimation
-		//text_debug.set("~" + to_string_dec_uint(value)); 
-		if (value == 'A')
-		{console.write("mac");}
-		else if (value == 'B')
-		{console.writeln("");}
-		//console.writeln("");
+void BTLERxView::on_packet(const BTLEPacketMessage& message) {
+	static const char * const pdu_types[8] = {
+		"ADV_IND", "ADV_DIRECT_IND", "ADV_NONCONN_IND", "SCAN_REQ",
+		"SCAN_RSP", "CONNECT_REQ", "ADV_SCAN_IND", "?"
+	};
+	
+	std::string str_console = to_string_dec_uint(message.channel_number, 2) + " ";
+	str_console += pdu_types[std::min(message.pdu[0] & 0x0F, 7)];
+	
+	// AdvA leads the payload of every advertising PDU, sent low byte first
+	if (message.length >= 2 + 6) {
+		str_console += " ";
+		for (size_t i = 0; i < 6; i++) {
+			str_console += to_string_hex(message.pdu[2 + 5 - i], 2);
+			if (i < 5) str_console += ":";
+		}
 	}
+	
+	console.writeln(str_console);
 }
 
 BTLERxView::~BTLERxView() {
+	rtc_time::signal_tick_second -= signal_token_tick_second;
 	audio::output::stop();
 	receiver_model.disable();
 	baseband::shutdown();
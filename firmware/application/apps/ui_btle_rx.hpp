@@ -29,6 +29,8 @@
 #include "ui_receiver.hpp"
 #include "ui_record_view.hpp"	// DEBUG
 
+#include "message.hpp"
+
 #include "utility.hpp"
 
 namespace ui {
@@ -43,11 +45,14 @@ public:
 	std::string title() const override { return "BTLE RX"; };
 	
 private:
-	void on_data(uint32_t value, bool is_data);
+	static constexpr int32_t channel_hop = -1;
+	
+	void on_packet(const BTLEPacketMessage& message);
+	void set_channel(const uint8_t channel_number);
+	void on_tick_second();
 	
-	uint8_t console_color { 0 };
-	uint32_t prev_value { 0 };
-	std::string str_log { "" };
+	uint8_t hop_index { 0 };
+	SignalToken signal_token_tick_second { };
 
 	RFAmpField field_rf_amp {
 		{ 13 * 8, 0 * 16 }
@@ -69,9 +74,15 @@ private:
 		{ 0 * 8, 0 * 16 },
 	};
 	
-	Text text_debug {
-		{ 0 * 8, 1 * 16, 10 * 8, 16 },
-		"DEBUG"
+	OptionsField options_channel {
+		{ 0 * 8, 1 * 16 },
+		7,
+		{
+			{ "Ch37   ", 37 },
+			{ "Ch38   ", 38 },
+			{ "Ch39   ", 39 },
+			{ "Hop    ", channel_hop }
+		}
 	};
 	
 	
@@ -91,13 +102,12 @@ private:
 	};
 
 	void update_freq(rf::Frequency f);
-	//void on_data_afsk(const AFSKDataMessage& message);
 	
 	MessageHandlerRegistration message_handler_packet {
-		Message::ID::AFSKData,
+		Message::ID::BTLEPacket,
 		[this](Message* const p) {
-			const auto message = static_cast<const AFSKDataMessage*>(p);
-			this->on_data(message->value, message->is_data);
+			const auto message = static_cast<const BTLEPacketMessage*>(p);
+			this->on_packet(*message);
 		}
 	};
 };
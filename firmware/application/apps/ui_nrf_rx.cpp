@@ -22,9 +22,7 @@
  */
 
 #include "ui_nrf_rx.hpp"
-#include "ui_modemsetup.hpp"
 
-#include "modems.hpp"
 #include "audio.hpp"
 #include "rtc_time.hpp"
 #include "baseband_api.hpp"
@@ -32,7 +30,6 @@
 #include "portapack_persistent_memory.hpp"
 
 using namespace portapack;
-using namespace modems;
 
 namespace ui {
 
@@ -44,6 +41,17 @@ void NRFRxView::update_freq(rf::Frequency f) {
 	receiver_model.set_tuning_frequency(f);
 }
 
+void NRFRxView::configure_baseband() {
+	const uint32_t bit_rate = options_rate.selected_index_value();
+	
+	// 2Mbps needs 2 samples per bit after the decimation by 2
+	const uint32_t sampling_rate = (bit_rate >= 2000000) ? 8000000 : 4000000;
+	receiver_model.set_sampling_rate(sampling_rate);
+	// The channel sits at +fs/4, so the filter has to pass the whole band
+	receiver_model.set_baseband_bandwidth(sampling_rate);
+	baseband::set_nrf(bit_rate, 8, 0, false, field_address.value_hex_u64());
+}
+
 NRFRxView::NRFRxView(NavigationView& nav) {
 	baseband::run_image(portapack::spi_flash::image_tag_nrf_rx);
 	
@@ -54,8 +62,9 @@ NRFRxView::NRFRxView(NavigationView& nav) {
 		&field_lna,
 		&field_vga,
 		&field_frequency,
-		&text_debug,
-		&button_modem_setup,
+		&options_rate,
+		&text_address,
+		&field_address,
 		&record_view,
 		&console
 	});
@@ -66,16 +75,7 @@ NRFRxView::NRFRxView(NavigationView& nav) {
 	};
 	record_view.set_sampling_rate(24000);
 	
-	// Auto-configure modem for LCR RX (will be removed later)
 	update_freq(2480000000);
-	auto def_bell202 = &modem_defs[0];
-	persistent_memory::set_modem_baudrate(def_bell202->baudrate);
-	serial_format_t serial_format;
-	serial_format.data_bits = 7;
-	serial_format.parity = EVEN;
-	serial_format.stop_bits = 1;
-	serial_format.bit_order = LSB_FIRST;
-	persistent_memory::set_serial_format(serial_format);
 	
 	field_frequency.set_value(receiver_model.tuning_frequency());
 	field_frequency.set_step(100);
@@ -90,70 +90,33 @@ NRFRxView::NRFRxView(NavigationView& nav) {
 		};
 	};
 
-	button_modem_setup.on_select = [&nav](Button&) {
-		nav.push<ModemSetupView>();
+	// nRF24 reset address
+	for (size_t i = 0; i < 10; i++)
+		field_address.set_sym(i, (i & 1) ? 0x7 : 0xE);
+	field_address.on_change = [this]() {
+		configure_baseband();
 	};
-	
-	
-	// Auto-configure modem for LCR RX (will be removed later)
-	baseband::set_nrf(persistent_memory::modem_baudrate(), 8, 0, false);
+	options_rate.on_change = [this](size_t, int32_t) {
+		configure_baseband();
+	};
+	configure_baseband();
 	
 	audio::set_rate(audio::Rate::Hz_24000);
 	audio::output::start();
 	
-	receiver_model.set_sampling_rate(4000000);
-	receiver_model.set_baseband_bandwidth(4000000);
 	receiver_model.set_modulation(ReceiverModel::Mode::WidebandFMAudio);
 	receiver_model.enable();
 }
 
-void NRFRxView::on_data(uint32_t value, bool is_data) {
-	//std::string str_console = "\x1B";
-	std::string str_console = "";
-	if (is_data) {
-		// Colorize differently after message splits
-		//str_console += (char)((console_color & 3) + 9);
-		
-		//value &= 0xFF;											// ABCDEFGH
-		//value = ((value & 0xF0) >> 4) | ((value & 0x0F) << 4);	// EFGHABCD
-		//value = ((value & 0xCC) >> 2) | ((value & 0x33) << 2);	// GHEFCDAB
-		//value = ((value & 0xAA) >> 1) | ((value & 0x55) << 1);	// HGFEDCBA
-		//value &= 0x7F;											// Ignore parity, which is the MSB now
-		
-		//if ((value >= 32) && (value < 127)) {
-		//	str_console += (char)value;							// Printable
-		//} 
-		
-		//str_console += (char)'A';
-		//str_console += (char)value;
-		//str_console += "[" + to_string_hex(value, 2) + "]";	
-		str_console += " " + to_string_hex(value, 2) ;	
-		console.write(str_console);
-		
-		
-		
-		/*if ((value != 0x7F) && (prev_value == 0x7F)) {
-			// Message split
-			console.writeln("");
-			console_color++;
-			
-			
-		}*/
-		//prev_value = value;
-	} else {
-		// Baudrate estimation
-		//text_debug.set("~" + to_string_dec_uint(value)); 
-		if (value == 'A')
-		{console.write("addr:");}
-		else if (value == 'B')
-		{console.write(" data:");}
-		else if (value == 'C')
-		{
-			console.writeln("");
-			console.writeln("");
-		}
-		//console.writeln("");
-	}
+void NRFRxView::on_packet(const NRFPacketMessage& message) {
+	std::string str_console = "addr:" + to_string_hex(message.address >> 32, 2) + to_string_hex(message.address, 8);
+	str_console += " pid:" + to_string_dec_uint(message.pid);
+	console.writeln(str_console);
+	
+	str_console = "data:";
+	for (size_t i = 0; i < message.length; i++)
+		str_console += " " + to_string_hex(message.payload[i], 2);
+	console.writeln(str_console);
 }
 
 NRFRxView::~NRFRxView() {
@@ -29,6 +29,8 @@
 #include "ui_receiver.hpp"
 #include "ui_record_view.hpp"	// DEBUG
 
+#include "message.hpp"
+
 #include "utility.hpp"
 
 namespace ui {
@@ -43,11 +45,8 @@ public:
 	std::string title() const override { return "NRF RX"; };
 	
 private:
-	void on_data(uint32_t value, bool is_data);
-	
-	uint8_t console_color { 0 };
-	uint32_t prev_value { 0 };
-	std::string str_log { "" };
+	void on_packet(const NRFPacketMessage& message);
+	void configure_baseband();
 
 	RFAmpField field_rf_amp {
 		{ 13 * 8, 0 * 16 }
@@ -69,15 +68,23 @@ private:
 		{ 0 * 8, 0 * 16 },
 	};
 	
-	Text text_debug {
-		{ 0 * 8, 1 * 16, 10 * 8, 16 },
-		"DEBUG"
+	OptionsField options_rate {
+		{ 0 * 8, 1 * 16 },
+		4,
+		{
+			{ "250k", 250000 },
+			{ "1M  ", 1000000 },
+			{ "2M  ", 2000000 }
+		}
 	};
-	
-	
-	Button button_modem_setup {
-		{ 12 * 8, 1 * 16, 96, 24 },
-		"Modem setup"
+	Text text_address {
+		{ 6 * 8, 1 * 16, 5 * 8, 16 },
+		"Addr:"
+	};
+	SymField field_address {
+		{ 11 * 8, 1 * 16 },
+		10,
+		SymField::SYMFIELD_HEX
 	};
 	
 	// DEBUG
@@ -91,13 +98,12 @@ private:
 	};
 
 	void update_freq(rf::Frequency f);
-	//void on_data_afsk(const AFSKDataMessage& message);
 	
 	MessageHandlerRegistration message_handler_packet {
-		Message::ID::AFSKData,
+		Message::ID::NRFPacket,
 		[this](Message* const p) {
-			const auto message = static_cast<const AFSKDataMessage*>(p);
-			this->on_data(message->value, message->is_data);
+			const auto message = static_cast<const NRFPacketMessage*>(p);
+			this->on_packet(*message);
 		}
 	};
 };
@@ -25,15 +25,31 @@
 #include "baseband_api.hpp"
 #include "string_format.hpp"
 #include "audio.hpp"
+#include "radio.hpp"
 
 using namespace portapack;
 
 namespace ui {
 
+void ScannerChannelStats::record(const int32_t db) {
+	const int8_t db_clamped = std::max(std::min(db, (int32_t)INT8_MAX), (int32_t)INT8_MIN);
+
+	if( db_clamped > max_db )
+		max_db = db_clamped;
+
+	history[history_head] = db_clamped;
+	history_head = (history_head + 1) % history_length;
+}
+
 ScannerThread::ScannerThread(
-	std::vector<rf::Frequency> frequency_list
-) : frequency_list_ {  std::move(frequency_list) }
+	std::vector<rf::Frequency> frequency_list,
+	const int32_t squelch,
+	const uint32_t wait
+) : frequency_list_ { std::move(frequency_list) },
+	squelch_ { squelch },
+	wait_ { wait }
 {
+	channel_stats_.resize(frequency_list_.size());
 	thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, ScannerThread::static_fn, this);
 }
 
@@ -49,31 +65,139 @@ void ScannerThread::set_scanning(const bool v) {
 	_scanning = v;
 }
 
+void ScannerThread::set_squelch(const int32_t v) {
+	squelch_ = v;
+}
+
+void ScannerThread::set_wait(const uint32_t v) {
+	wait_ = v;
+}
+
+void ScannerThread::set_tone(const uint32_t v) {
+	tone_ = v;
+}
+
+// The decoder confirmed the tone set, on the current channel.
+void ScannerThread::on_tone() {
+	chSysLock();
+	if( thread ) {
+		chEvtSignalI(thread, EVT_MASK_TONE);
+	}
+	chSysUnlock();
+}
+
+void ScannerThread::on_statistics_update(const ChannelStatistics& statistics) {
+	chSysLock();
+	statistics_ = statistics;
+	if( thread ) {
+		chEvtSignalI(thread, EVT_MASK_STATISTICS);
+	}
+	chSysUnlock();
+}
+
 msg_t ScannerThread::static_fn(void* arg) {
 	auto obj = static_cast<ScannerThread*>(arg);
 	obj->run();
 	return 0;
 }
 
+bool ScannerThread::wait_for_lock() {
+	for(uint32_t i=0; i<lock_timeout_ms; i++) {
+		if( radio::is_tuning_locked() )
+			return true;
+		chThdSleepMilliseconds(1);
+	}
+	return radio::is_tuning_locked();
+}
+
+// Baseband messages are only sent from the UI thread: ScannerView relays it.
+void ScannerThread::restart_statistics(const uint32_t update_interval_ms) {
+	epoch++;
+	ChannelStatsConfigMessage message { epoch, update_interval_ms };
+	EventDispatcher::send_message(message);
+}
+
+// Skips updates left over from before the last restart_statistics().
+bool ScannerThread::wait_statistics(ChannelStatistics& statistics, const uint32_t timeout_ms) {
+	while( chEvtWaitAnyTimeout(EVT_MASK_STATISTICS, MS2ST(timeout_ms)) ) {
+		chSysLock();
+		statistics = statistics_;
+		chSysUnlock();
+
+		if( statistics.epoch == epoch )
+			return true;
+	}
+	return false;
+}
+
+/* Hop as soon as the synthesizers lock and decide squelch from the first
+ * short statistics update taken after the retune. On a hit, hold the channel
+ * at the normal update rate until `wait` updates in a row fall below squelch.
+ * With a tone set, also leave if the decoder hasn't confirmed it lately.
+ */
 void ScannerThread::run() {
 	RetuneMessage message { };
+	ChannelStatistics statistics { };
 	uint32_t frequency_index = 0;
+	uint32_t below_squelch = 0;
 	
 	while( !chThdShouldTerminate() ) {
 		if (_scanning) {
 			// Retune
 			receiver_model.set_tuning_frequency(frequency_list_[frequency_index]);
+			wait_for_lock();
+			CodedSquelchResetMessage reset { ++tone_epoch };
+			EventDispatcher::send_message(reset);
+			restart_statistics(dwell_update_ms);
 			
 			message.range = frequency_index;
 			EventDispatcher::send_message(message);
 			
+			if( wait_statistics(statistics, dwell_timeout_ms) ) {
+				auto& channel = channel_stats_[frequency_index];
+				channel.record(statistics.max_db);
+
+				if( statistics.max_db >= -squelch_ ) {
+					channel.hits++;
+					below_squelch = 0;
+					_scanning = false;
+					chEvtGetAndClearEvents(EVT_MASK_TONE);
+					tone_seen_time = chTimeNow();
+					restart_statistics(ChannelStatsConfigMessage::update_interval_default_ms);
+					continue;
+				}
+			}
 			
 			frequency_index++;
 			if (frequency_index >= frequency_list_.size())
 				frequency_index = 0;
+		} else {
+			// Holding
+			if( chEvtGetAndClearEvents(EVT_MASK_TONE) )
+				tone_seen_time = chTimeNow();
+			if( tone_ && (chTimeNow() - tone_seen_time > MS2ST(tone_timeout_ms)) ) {
+				frequency_index++;
+				if (frequency_index >= frequency_list_.size())
+					frequency_index = 0;
+				_scanning = true;
+				continue;
+			}
+
+			if( wait_statistics(statistics, hold_timeout_ms) ) {
+				channel_stats_[frequency_index].record(statistics.max_db);
+
+				if( statistics.max_db < -squelch_ ) {
+					if( ++below_squelch >= wait_ ) {
+						frequency_index++;
+						if (frequency_index >= frequency_list_.size())
+							frequency_index = 0;
+						_scanning = true;
+					}
+				} else {
+					below_squelch = 0;
+				}
+			}
 		}
-		
-		chThdSleepMilliseconds(50);
 	}
 }
 
@@ -81,6 +205,40 @@ void ScannerView::handle_retune(uint32_t i) {
 	text_cycle.set(	to_string_dec_uint(i) + "/" +
 					to_string_dec_uint(frequency_list.size()) + " : " +
 					to_string_dec_uint(frequency_list[i]) );
+
+	// The decoder was reset for this channel
+	if (tone_shown) {
+		text_tone.set("");
+		tone_shown = false;
+	}
+
+	const auto& channel = scan_thread->channel_stats(i);
+	text_channel_stats.set(	"Hits:" + to_string_dec_uint(channel.hits) +
+							" Max:" + to_string_dec_int(channel.max_db) + "dB" );
+}
+
+void ScannerView::handle_stats_restart(const ChannelStatsConfigMessage& message) {
+	baseband::channel_stats_restart(message.epoch, message.update_interval_ms);
+}
+
+void ScannerView::handle_coded_squelch_reset(const CodedSquelchResetMessage& message) {
+	tone_epoch = message.epoch;
+	baseband::coded_squelch_reset(message.epoch);
+}
+
+void ScannerView::handle_coded_squelch(const CodedSquelchMessage& message) {
+	// Decoded before the last retune
+	if (message.epoch != tone_epoch)
+		return;
+
+	text_tone.set(tonekey::coded_squelch_string(message));
+	tone_shown = true;
+
+	const bool match = (tone & ScannerThread::tone_dcs_flag) ?
+		((message.type == CodedSquelchMessage::Type::DCS) && (message.value == (tone & ~ScannerThread::tone_dcs_flag))) :
+		((message.type == CodedSquelchMessage::Type::CTCSS) && (message.value == tone));
+	if (match && scan_thread)
+		scan_thread->on_tone();
 }
 
 void ScannerView::focus() {
@@ -88,6 +246,8 @@ void ScannerView::focus() {
 }
 
 ScannerView::~ScannerView() {
+	// Before the baseband goes, nothing may be left to relay to it
+	scan_thread.reset();
 	audio::output::stop();
 	receiver_model.disable();
 	baseband::shutdown();
@@ -106,21 +266,26 @@ ScannerView::ScannerView(
 		&field_bw,
 		&field_squelch,
 		&field_wait,
+		&field_tone,
+		&text_tone,
 		//&record_view,
 		&text_cycle,
+		&text_channel_stats,
 		//&waterfall,
 	});
 
+	// Only the frequencies are kept, the index is freed once the list is built
 	std::string scanner_file = "SCANNER";
-	if (load_freqman_file(scanner_file, database)) {
-		for(auto& entry : database) {
+	FreqmanIndex database;
+	if (database.load(scanner_file)) {
+		for (size_t n = 0; n < database.size(); n++) {
 			// FIXME
-			if (entry.type == RANGE) {
-				for (uint32_t i=entry.frequency_a; i < entry.frequency_b; i+= 1000000) {
+			if (database.type(n) == RANGE) {
+				for (uint32_t i=database.frequency_a(n); i < database.frequency_b(n); i+= 1000000) {
 					frequency_list.push_back(i);
 				}
 			} else {
-				frequency_list.push_back(entry.frequency_a);
+				frequency_list.push_back(database.frequency_a(n));
 			}
 		}
 	} else {
@@ -140,14 +305,35 @@ ScannerView::ScannerView(
 
 	field_wait.on_change = [this](int32_t v) {
 		wait = v;
+		if (scan_thread)
+			scan_thread->set_wait(v);
 	};
 	field_wait.set_value(5);
 
 	field_squelch.on_change = [this](int32_t v) {
 		squelch = v;
+		if (scan_thread)
+			scan_thread->set_squelch(v);
 	};
 	field_squelch.set_value(30);
 
+	// Any tone, one of the CTCSS tones or one of the DCS codes
+	using option_t = std::pair<std::string, int32_t>;
+	std::vector<option_t> tone_options { { "Any", 0 } };
+	for (size_t c = 1; c < 51; c++) {
+		const auto f = tonekey::tone_key_frequency(c);
+		tone_options.emplace_back(to_string_dec_uint(f) + "." + to_string_dec_uint((uint32_t)(f * 10) % 10), (int32_t)(f * 100 + 0.5f));
+	}
+	for (const auto code : tonekey::dcs_codes)
+		tone_options.emplace_back("D" + tonekey::dcs_code_string(code) + "N", ScannerThread::tone_dcs_flag | code);
+	field_tone.set_options(tone_options);
+	field_tone.on_change = [this](size_t, OptionsField::value_t v) {
+		tone = v;
+		if (scan_thread)
+			scan_thread->set_tone(v);
+	};
+	field_tone.set_selected_index(0);
+
 	field_volume.set_value((receiver_model.headphone_volume() - audio::headphone::volume_range().max).decibel() + 99);
 	field_volume.on_change = [this](int32_t v) {
 		this->on_headphone_volume_changed(v);
@@ -165,26 +351,13 @@ ScannerView::ScannerView(
 	receiver_model.set_nbfm_configuration(field_bw.selected_index());
 	audio::output::unmute();
 	
-	// TODO: Scanning thread here
-	scan_thread = std::make_unique<ScannerThread>(frequency_list);
+	scan_thread = std::make_unique<ScannerThread>(frequency_list, squelch, wait);
+	scan_thread->set_tone(tone);
 }
 
 void ScannerView::on_statistics_update(const ChannelStatistics& statistics) {
-	int32_t max_db = statistics.max_db;
-	
-	if (timer <= wait)
-		timer++;
-	
-	if (max_db < -squelch) {
-		if (timer == wait) {
-			//audio::output::stop();
-			scan_thread->set_scanning(true);
-		}
-	} else {
-		//audio::output::start();
-		scan_thread->set_scanning(false);
-		timer = 0;
-	}
+	if (scan_thread)
+		scan_thread->on_statistics_update(statistics);
 }
 
 void ScannerView::on_headphone_volume_changed(int32_t v) {
@@ -25,15 +25,49 @@
 #include "ui_receiver.hpp"
 #include "ui_font_fixed_8x16.hpp"
 #include "freqman.hpp"
+#include "tone_key.hpp"
+
+#include <array>
 
 namespace ui {
 
+// Per-channel activity, kept small since scan lists run to hundreds of entries.
+struct ScannerChannelStats {
+	static constexpr size_t history_length = 4;
+
+	uint16_t hits { 0 };
+	int8_t max_db { -128 };
+	uint8_t history_head { 0 };
+	std::array<int8_t, history_length> history { { -128, -128, -128, -128 } };
+
+	void record(const int32_t db);
+};
+
+static_assert(sizeof(ScannerChannelStats) == 8, "ScannerChannelStats wrong size");
+
 class ScannerThread {
 public:
-	ScannerThread(std::vector<rf::Frequency> frequency_list);
+	// set_tone(): tone_dcs_flag | octal code for a DCS code (normal polarity)
+	static constexpr uint32_t tone_dcs_flag = 1 << 16;
+
+	ScannerThread(
+		std::vector<rf::Frequency> frequency_list,
+		const int32_t squelch,
+		const uint32_t wait
+	);
 	~ScannerThread();
 	
 	void set_scanning(const bool v);
+	void set_squelch(const int32_t v);
+	void set_wait(const uint32_t v);
+	void set_tone(const uint32_t v);
+
+	void on_statistics_update(const ChannelStatistics& statistics);
+	void on_tone();
+
+	const ScannerChannelStats& channel_stats(const size_t index) const {
+		return channel_stats_[index];
+	}
 
 	ScannerThread(const ScannerThread&) = delete;
 	ScannerThread(ScannerThread&&) = delete;
@@ -41,14 +75,37 @@ public:
 	ScannerThread& operator=(ScannerThread&&) = delete;
 
 private:
+	static constexpr eventmask_t EVT_MASK_STATISTICS = EVENT_MASK(0);
+	static constexpr eventmask_t EVT_MASK_TONE = EVENT_MASK(1);
+
+	static constexpr uint32_t lock_timeout_ms = 5;
+	static constexpr uint32_t dwell_update_ms = 2;		// Stats interval while hopping
+	static constexpr uint32_t dwell_timeout_ms = 30;	// Includes the UI thread relaying the restart
+	static constexpr uint32_t hold_timeout_ms = 250;
+	// First confirmation takes up to 3 blocks (~576ms), then one per block
+	// (192ms): room for the first one plus a couple of missed blocks.
+	static constexpr uint32_t tone_timeout_ms = 1200;
+
 	std::vector<rf::Frequency> frequency_list_ { };
+	std::vector<ScannerChannelStats> channel_stats_ { };
 	Thread* thread { nullptr };
 	
-	bool _scanning { true };
+	volatile bool _scanning { true };
+	volatile int32_t squelch_ { 0 };
+	volatile uint32_t wait_ { 0 };
+	volatile uint32_t tone_ { 0 };				// CTCSS in 1/100 Hz or DCS, 0 for any
+
+	uint32_t epoch { 0 };
+	uint32_t tone_epoch { 0 };		// Decoder reset on each retune
+	systime_t tone_seen_time { 0 };
+	ChannelStatistics statistics_ { };
 
 	static msg_t static_fn(void* arg);
 	
 	void run();
+	bool wait_for_lock();
+	void restart_statistics(const uint32_t update_interval_ms);
+	bool wait_statistics(ChannelStatistics& statistics, const uint32_t timeout_ms);
 };
 
 class ScannerView : public View {
@@ -64,16 +121,21 @@ private:
 	void on_statistics_update(const ChannelStatistics& statistics);
 	void on_headphone_volume_changed(int32_t v);
 	void handle_retune(uint32_t i);
+	void handle_stats_restart(const ChannelStatsConfigMessage& message);
+	void handle_coded_squelch_reset(const CodedSquelchResetMessage& message);
+	void handle_coded_squelch(const CodedSquelchMessage& message);
 	
 	std::vector<rf::Frequency> frequency_list { };
 	int32_t squelch { 0 };
-	uint32_t timer { 0 };
 	uint32_t wait { 0 };
-	freqman_db database { };
+	uint32_t tone { 0 };
+	uint32_t tone_epoch { 0 };
+	bool tone_shown { false };
 	
 	Labels labels {
 		{ { 0 * 8, 0 * 16 }, "LNA:   VGA:   AMP:  VOL:", Color::light_grey() },
 		{ { 0 * 8, 1 * 16 }, "BW:    SQUELCH:  /99 WAIT:", Color::light_grey() },
+		{ { 0 * 8, 2 * 16 }, "TONE:", Color::light_grey() },
 		{ { 0 * 8, 3 * 16 }, "Work in progress...", Color::light_grey() }
 	};
 	
@@ -123,10 +185,26 @@ private:
 		' ',
 	};
 
+	OptionsField field_tone {
+		{ 6 * 8, 2 * 16 },
+		5,
+		{ }
+	};
+
+	Text text_tone {
+		{ 12 * 8, 2 * 16, 18 * 8, 16 },
+		""
+	};
+
 	Text text_cycle {
 		{ 0, 5 * 16, 240, 16 },
 		"--/--"
 	};
+
+	Text text_channel_stats {
+		{ 0, 6 * 16, 240, 16 },
+		""
+	};
 	
 	std::unique_ptr<ScannerThread> scan_thread { };
 	
@@ -138,6 +216,27 @@ private:
 		}
 	};
 	
+	MessageHandlerRegistration message_handler_stats_restart {
+		Message::ID::ChannelStatsConfig,
+		[this](const Message* const p) {
+			this->handle_stats_restart(*reinterpret_cast<const ChannelStatsConfigMessage*>(p));
+		}
+	};
+	
+	MessageHandlerRegistration message_handler_coded_squelch_reset {
+		Message::ID::CodedSquelchReset,
+		[this](const Message* const p) {
+			this->handle_coded_squelch_reset(*reinterpret_cast<const CodedSquelchResetMessage*>(p));
+		}
+	};
+	
+	MessageHandlerRegistration message_handler_coded_squelch {
+		Message::ID::CodedSquelch,
+		[this](const Message* const p) {
+			this->handle_coded_squelch(*reinterpret_cast<const CodedSquelchMessage*>(p));
+		}
+	};
+	
 	MessageHandlerRegistration message_handler_stats {
 		Message::ID::ChannelStatistics,
 		[this](const Message* const p) {
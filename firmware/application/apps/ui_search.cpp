@@ -45,7 +45,7 @@ void RecentEntriesTable<SearchRecentEntries>::draw(
 		
 	str_duration.resize(target_rect.width() / 8, ' ');
 	
-	painter.draw_string(target_rect.location(), style, to_string_short_freq(entry.frequency) + " " + entry.time + " " + str_duration);
+	painter.draw_string(target_rect.location(), style, to_string_short_freq(entry.frequency) + " " + entry.time.str() + " " + str_duration);
 }
 
 void SearchView::focus() {
@@ -63,7 +63,6 @@ void SearchView::do_detection() {
 	uint32_t slice_max = 0;
 	uint32_t snap_value;
 	uint8_t power;
-	rtc::RTC datetime;
 	std::string str_approx, str_timestamp;
 	
 	// Display spectrum
@@ -74,7 +73,7 @@ void SearchView::do_detection() {
 		spectrum_row
 	);
 	
-	mean_power = mean_acc / (SEARCH_BIN_NB_NO_DC * slices_nb);
+	mean_power = mean_acc / (SEARCH_BIN_NB_NO_EDGES * slices_nb);
 	mean_acc = 0;
 	
 	overall_power_max = 0;
@@ -114,7 +113,8 @@ void SearchView::do_detection() {
 						
 						auto& entry = ::on_packet(recent, resolved_frequency);
 						
-						rtcGetTime(&RTCD1, &datetime);
+						// Time the slice was captured, not when it was processed
+						const auto& datetime = slices[slice_max].timestamp;
 						str_timestamp = to_string_dec_uint(datetime.hour(), 2, '0') + ":" +
 										to_string_dec_uint(datetime.minute(), 2, '0') + ":" +
 										to_string_dec_uint(datetime.second(), 2, '0');
@@ -195,11 +195,11 @@ void SearchView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
 	baseband::spectrum_streaming_stop();
 	
 	// Add pixels to spectrum display and find max power for this slice
-	// Center 12 bins are ignored (DC spike is blanked)
+	// DC spike is interpolated away by the baseband
 	// Leftmost and rightmost 2 bins are ignored
 	for (bin = 0; bin < 256; bin++) {
 
-		if ((bin < 2) || (bin > 253) || ((bin >= 122) && (bin < 134))) {
+		if ((bin < 2) || (bin > 253)) {
 			power = 0;
 		} else {
 			if (bin < 128)
@@ -219,6 +219,7 @@ void SearchView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
 	
 	slices[slice_counter].max_power = max_power;
 	slices[slice_counter].max_index = max_bin;
+	slices[slice_counter].timestamp = spectrum.timestamp;
 	
 	if (slices_nb > 1) {
 		// Slice sequence
@@ -238,6 +239,7 @@ void SearchView::on_channel_spectrum(const ChannelSpectrum& spectrum) {
 }
 
 void SearchView::on_show() {
+	// Detection needs every slice as measured: default window, no averaging
 	baseband::spectrum_streaming_start();
 }
 
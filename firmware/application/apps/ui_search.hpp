@@ -32,7 +32,7 @@ namespace ui {
 
 #define SEARCH_SLICE_WIDTH	2500000					// Search slice bandwidth
 #define SEARCH_BIN_NB			256					// FFT power bins
-#define SEARCH_BIN_NB_NO_DC	(SEARCH_BIN_NB - 16)	// Bins after trimming
+#define SEARCH_BIN_NB_NO_EDGES	(SEARCH_BIN_NB - 4)	// Bins after trimming
 #define SEARCH_BIN_WIDTH		(SEARCH_SLICE_WIDTH / SEARCH_BIN_NB)
 
 #define DETECT_DELAY		5	// In 100ms units
@@ -45,7 +45,7 @@ struct SearchRecentEntry {
 	
 	rf::Frequency frequency;
 	uint32_t duration { 0 };	// In 100ms units
-	std::string time { "" };
+	RecentEntryString<8> time { };
 
 	SearchRecentEntry(
 	) : SearchRecentEntry { 0 }
@@ -110,6 +110,7 @@ private:
 		int16_t max_index;
 		uint8_t power;
 		int16_t index;
+		rtc::RTC timestamp;
 	} slices[32];
 	
 	uint32_t bin_skip_acc { 0 }, bin_skip_frac { };
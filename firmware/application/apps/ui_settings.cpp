@@ -291,6 +291,33 @@ void SetAudioView::focus() {
 	field_tone_mix.focus();
 }
 
+SetSpectrumView::SetSpectrumView(NavigationView& nav) {
+	add_children({
+		&labels,
+		&options_window,
+		&options_averaging,
+		&options_shift,
+		&button_ok
+	});
+
+	options_window.set_by_value(persistent_memory::spectrum_window());
+	options_averaging.set_by_value(persistent_memory::spectrum_averaging());
+	options_shift.set_by_value(persistent_memory::spectrum_averaging_shift());
+	
+	button_ok.on_select = [&nav, this](Button&) {
+		persistent_memory::set_spectrum_config(
+			options_window.selected_index_value(),
+			options_averaging.selected_index_value(),
+			options_shift.selected_index_value()
+		);
+		nav.pop();
+	};
+}
+
+void SetSpectrumView::focus() {
+	options_window.focus();
+}
+
 /*void ModInfoView::on_show() {
 	if (modules_nb) update_infos(0);
 }
@@ -475,6 +502,7 @@ SettingsMenuView::SettingsMenuView(NavigationView& nav) {
 		{ "Audio", 			ui::Color::dark_cyan(), &bitmap_icon_speaker,	[&nav](){ nav.push<SetAudioView>(); } },
 		{ "Radio",			ui::Color::dark_cyan(), nullptr,	[&nav](){ nav.push<SetRadioView>(); } },
 		{ "UI", 			ui::Color::dark_cyan(), nullptr,	[&nav](){ nav.push<SetUIView>(); } },
+		{ "Waterfall",		ui::Color::dark_cyan(), nullptr,	[&nav](){ nav.push<SetSpectrumView>(); } },
 		//{ "SD card modules", ui::Color::dark_cyan(), [&nav](){ nav.push<ModInfoView>(); } },
 		{ "Date/Time",		ui::Color::dark_cyan(), nullptr,	[&nav](){ nav.push<SetDateTimeView>(); } },
 		{ "Touch screen",	ui::Color::dark_cyan(), nullptr,	[&nav](){ nav.push<TouchCalibrationView>(); } },
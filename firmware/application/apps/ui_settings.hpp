@@ -257,6 +257,62 @@ private:
 	};
 };
 
+class SetSpectrumView : public View {
+public:
+	SetSpectrumView(NavigationView& nav);
+	
+	void focus() override;
+	
+	std::string title() const override { return "Waterfall settings"; };
+	
+private:
+	Labels labels {
+		{ { 2 * 8, 3 * 16 }, "Window:", Color::light_grey() },
+		{ { 2 * 8, 5 * 16 }, "Averaging:", Color::light_grey() },
+		{ { 2 * 8, 7 * 16 }, "Over:    lines", Color::light_grey() },
+	};
+	
+	OptionsField options_window {
+		{ 13 * 8, 3 * 16 },
+		15,
+		{
+			{ "Hamming (bins)", 0 },
+			{ "Blackman-Harris", 1 },
+			{ "Flat top", 2 },
+			{ "Kaiser", 3 }
+		}
+	};
+	
+	OptionsField options_averaging {
+		{ 13 * 8, 5 * 16 },
+		11,
+		{
+			{ "None", 0 },
+			{ "Exponential", 1 },
+			{ "Peak hold", 2 }
+		}
+	};
+	
+	// Averaging shift: one line per 2^shift spectrums
+	OptionsField options_shift {
+		{ 8 * 8, 7 * 16 },
+		2,
+		{
+			{ " 1", 0 },
+			{ " 2", 1 },
+			{ " 4", 2 },
+			{ " 8", 3 },
+			{ "16", 4 },
+			{ "32", 5 }
+		}
+	};
+	
+	Button button_ok {
+		{ 2 * 8, 16 * 16, 12 * 8, 32 },
+		"OK"
+	};
+};
+
 class SetPlayDeadView : public View {
 public:
 	SetPlayDeadView(NavigationView& nav);
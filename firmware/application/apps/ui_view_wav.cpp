@@ -27,6 +27,9 @@ using namespace portapack;
 
 #include "string_format.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ui {
 
 void ViewWavView::update_scale(int32_t new_scale) {
@@ -37,22 +40,57 @@ void ViewWavView::update_scale(int32_t new_scale) {
 }
 
 void ViewWavView::refresh_waveform() {
-	for (size_t i = 0; i < 240; i++) {
-		wav_reader->data_seek(position + (i * scale));
-		wav_reader->read(&waveform_buffer[i], sizeof(int16_t));
+	// Without the pyramid, wide views would read the whole file at once
+	if (pyramid.is_building())
+		return;
+	
+	pyramid.read_columns(*wav_reader, position, scale, columns.data(), columns.size());
+	for (size_t i = 0; i < columns.size(); i++) {
+		waveform_buffer[i * 2] = columns[i].min;
+		waveform_buffer[i * 2 + 1] = columns[i].max;
 	}
 	
 	waveform.set_dirty();
 	
 	// Window
-	uint64_t w_start = (position * 240) / wav_reader->sample_count();
-	uint64_t w_width = (scale * 240) / (wav_reader->sample_count() / 240);
+	const uint64_t sample_count = std::max<uint64_t>(wav_reader->sample_count(), 1);
+	uint64_t w_start = std::min<uint64_t>((position * 240) / sample_count, 239);
+	uint64_t w_width = std::min<uint64_t>((scale * 240 * 240) / sample_count, 239 - w_start);
 	display.fill_rectangle({ 0, 10 * 16 + 1, 240, 16 }, Color::black());
 	display.fill_rectangle({ (Coord)w_start, 21 * 8, (Dim)w_width + 1, 8 }, Color::white());
 	display.draw_line({ 0, 10 * 16 + 1 }, { (Coord)w_start, 21 * 8 }, Color::white());
 	display.draw_line({ 239, 10 * 16 + 1 }, { (Coord)(w_start + w_width), 21 * 8 }, Color::white());
 }
 
+void ViewWavView::on_frame_sync() {
+	if (!pyramid.is_building())
+		return;
+	
+	if (pyramid.build_step(*wav_reader, build_samples_per_frame))
+		text_delta.set("Indexing... " + to_string_dec_uint(pyramid.build_progress()) + "%");
+	else
+		on_pyramid_ready();
+}
+
+void ViewWavView::on_pyramid_ready() {
+	// Whole file RMS envelope, only from the pyramid: the samples would take
+	// too long to read
+	if (pyramid.is_open()) {
+		const uint64_t overview_scale = std::max<uint64_t>((wav_reader->sample_count() + 239) / 240, 1);
+		pyramid.read_columns(*wav_reader, 0, overview_scale, columns.data(), columns.size());
+		for (size_t i = 0; i < columns.size(); i++)
+			amplitude_buffer[i] = std::min<uint32_t>(sqrtf(columns[i].mean_square), 32767) >> 8;
+		set_scale_options(scale_log2_max);
+	} else {
+		std::fill(std::begin(amplitude_buffer), std::end(amplitude_buffer), 0);
+		set_scale_options(scale_log2_max_unindexed);
+	}
+	set_dirty();
+	
+	reset_controls();
+	update_scale(1);
+}
+
 void ViewWavView::refresh_measurements() {
 	uint64_t span_ns = ns_per_pixel * abs(field_cursor_b.value() - field_cursor_a.value());
 	
@@ -78,9 +116,6 @@ void ViewWavView::on_pos_changed() {
 }
 
 void ViewWavView::load_wav(std::filesystem::path file_path) {
-	int16_t sample;
-	uint32_t average;
-
 	if (!wav_reader->open(file_path)) {
 		nav_.display_modal("Error", "Couldn't open file.", INFO, nullptr);
 		return;
@@ -100,27 +135,35 @@ void ViewWavView::load_wav(std::filesystem::path file_path) {
 	text_samplerate.set(to_string_dec_uint(wav_reader->sample_rate()) + "Hz");
 	text_title.set(wav_reader->title());
 	
-	// Fill amplitude buffer, world's worst downsampling
-	uint64_t skip = wav_reader->sample_count() / (240 * subsampling_factor);
-	
-	for (size_t i = 0; i < 240; i++) {
-		average = 0;
-		
-		for (size_t s = 0; s < subsampling_factor; s++) {
-			wav_reader->data_seek(((i * subsampling_factor) + s) * skip);
-			wav_reader->read(&sample, 2);
-			average += (abs(sample) >> 8);
-		}
-		
-		amplitude_buffer[i] = average / subsampling_factor;
+	// One streaming pass on first open, spread over frames, then every view
+	// is a short read
+	if (pyramid.open(*wav_reader, file_path) || !pyramid.is_building()) {
+		on_pyramid_ready();
+	} else {
+		std::fill(std::begin(amplitude_buffer), std::end(amplitude_buffer), 0);
+		std::fill(std::begin(waveform_buffer), std::end(waveform_buffer), 0);
+		waveform.set_dirty();
+		set_dirty();
+		text_delta.set("Indexing... 0%");
 	}
-	
-	reset_controls();
-	update_scale(1);
+}
+
+void ViewWavView::set_scale_options(const size_t log2_max) {
+	OptionsField::options_t scale_options;
+	for (size_t n = 0; n <= log2_max; n++) {
+		const int32_t value = 1 << n;
+		if (n < 10)
+			scale_options.emplace_back(to_string_dec_uint(value), value);
+		else if (n < 20)
+			scale_options.emplace_back(to_string_dec_uint(value >> 10) + "k", value);
+		else
+			scale_options.emplace_back(to_string_dec_uint(value >> 20) + "M", value);
+	}
+	field_scale.set_options(scale_options);
 }
 
 void ViewWavView::reset_controls() {
-	field_scale.set_value(1);
+	field_scale.set_selected_index(0);
 	field_pos_seconds.set_value(0);
 	field_pos_samples.set_value(0);
 	field_cursor_a.set_value(0);
@@ -133,6 +176,8 @@ ViewWavView::ViewWavView(
 {
 	wav_reader = std::make_unique<WAVFileReader>();
 	
+	set_scale_options(scale_log2_max);
+	
 	add_children({
 		&labels,
 		&text_filename,
@@ -157,7 +202,7 @@ ViewWavView::ViewWavView(
 		};
 	};
 	
-	field_scale.on_change = [this](int32_t value) {
+	field_scale.on_change = [this](size_t, int32_t value) {
 		update_scale(value);
 	};
 	field_pos_seconds.on_change = [this](int32_t) {
@@ -23,6 +23,7 @@
 #include "ui.hpp"
 #include "ui_navigation.hpp"
 #include "io_wave.hpp"
+#include "waveform_pyramid.hpp"
 #include "spectrum_color_lut.hpp"
 
 namespace ui {
@@ -38,18 +39,28 @@ public:
 
 private:
 	NavigationView& nav_;
-	static constexpr uint32_t subsampling_factor = 8;
+	static constexpr size_t scale_log2_max = 20;
+	// Without a pyramid every column is read from samples: 240 * 64 at most
+	static constexpr size_t scale_log2_max_unindexed = 6;
+	// Pyramid build work per frame, 16KB of reads
+	static constexpr uint32_t build_samples_per_frame = 8192;
 	
 	void update_scale(int32_t new_scale);
 	void refresh_waveform();
 	void refresh_measurements();
 	void on_pos_changed();
+	void on_frame_sync();
+	void on_pyramid_ready();
 	void load_wav(std::filesystem::path file_path);
 	void reset_controls();
+	void set_scale_options(const size_t log2_max);
 
 	std::unique_ptr<WAVFileReader> wav_reader { };
+	WaveformPyramid pyramid { };
 	
-	int16_t waveform_buffer[240] { };
+	std::array<WaveformPyramid::Entry, 240> columns { };
+	// Min and max of each column, drawn as one zig-zag line
+	int16_t waveform_buffer[480] { };
 	uint8_t amplitude_buffer[240] { };
 	int32_t scale { 1 };
 	uint64_t ns_per_pixel { };
@@ -60,7 +71,7 @@ private:
 		{ { 0 * 8, 1 * 16 }, "Samplerate:", Color::light_grey() },
 		{ { 0 * 8, 2 * 16 }, "Title:", Color::light_grey() },
 		{ { 0 * 8, 3 * 16 }, "Duration:", Color::light_grey() },
-		{ { 0 * 8, 11 * 16 }, "Position:   s         Scale:", Color::light_grey() },
+		{ { 0 * 8, 11 * 16 }, "Position:   s       Scale:", Color::light_grey() },
 		{ { 0 * 8, 12 * 16 }, "Cursor A:", Color::dark_cyan() },
 		{ { 0 * 8, 13 * 16 }, "Cursor B:", Color::dark_magenta() },
 		{ { 0 * 8, 14 * 16 }, "Delta:", Color::light_grey() }
@@ -90,7 +101,7 @@ private:
 	Waveform waveform {
 		{ 0, 5 * 16, 240, 64 },
 		waveform_buffer,
-		240,
+		480,
 		0,
 		false,
 		Color::white()
@@ -110,12 +121,11 @@ private:
 		1,
 		'0'
 	};
-	NumberField field_scale {
-		{ 28 * 8, 11 * 16 },
-		2,
-		{ 1, 40 },
-		1,
-		' '
+	// Samples per pixel, set up in the constructor
+	OptionsField field_scale {
+		{ 26 * 8, 11 * 16 },
+		4,
+		{ }
 	};
 	
 	NumberField field_cursor_a {
@@ -140,6 +150,13 @@ private:
 		{ 6 * 8, 14 * 16, 30 * 8, 16 },
 		"-"
 	};
+	
+	MessageHandlerRegistration message_handler_frame_sync {
+		Message::ID::DisplayFrameSync,
+		[this](const Message* const) {
+			this->on_frame_sync();
+		}
+	};
 };
 
 } /* namespace ui */
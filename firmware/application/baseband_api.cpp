@@ -130,22 +130,26 @@ void set_afsk(const uint32_t baudrate, const uint32_t word_length, const uint32_
 	send_message(&message);
 }
 
-void set_btle(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word) {
+void set_btle(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word,
+				const uint8_t channel_number) {
 	const BTLERxConfigureMessage message {
 		baudrate,
 		word_length,
 		trigger_value,
-		trigger_word
+		trigger_word,
+		channel_number
 	};
 	send_message(&message);
 }
     
-void set_nrf(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word) {
+void set_nrf(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word,
+				const uint64_t address) {
 	const NRFRxConfigureMessage message {
 		baudrate,
 		word_length,
 		trigger_value,
-		trigger_word
+		trigger_word,
+		address
 	};
 	send_message(&message);
 }
@@ -176,13 +180,14 @@ void kill_afsk() {
 }
 
 void set_audiotx_config(const uint32_t divider, const float deviation_hz, const float audio_gain,
-					const uint32_t tone_key_delta) {
+					const uint32_t tone_key_delta, const uint32_t bits_per_sample) {
 	const AudioTXConfigMessage message {
 		divider,
 		deviation_hz,
 		audio_gain,
 		tone_key_delta,
-		(float)persistent_memory::tone_mix() / 100.0f
+		(float)persistent_memory::tone_mix() / 100.0f,
+		bits_per_sample
 	};
 	send_message(&message);
 }
@@ -255,9 +260,18 @@ void set_rds_data(const uint16_t message_length) {
 	send_message(&message);
 }
 
-void set_spectrum(const size_t sampling_rate, const size_t trigger) {
+void set_spectrum(
+	const size_t sampling_rate,
+	const size_t trigger,
+	const size_t presum_factor,
+	const bool overlap,
+	const size_t dc_bins,
+	const size_t fft_size
+) {
 	const WidebandSpectrumConfigMessage message {
-		sampling_rate, trigger
+		sampling_rate, trigger,
+		presum_factor, overlap, dc_bins,
+		fft_size
 	};
 	send_message(&message);
 }
@@ -306,9 +320,16 @@ void shutdown() {
 	baseband_image_running = false;
 }
 
-void spectrum_streaming_start() {
+void spectrum_streaming_start(
+	const SpectrumStreamingConfigMessage::Window window,
+	const SpectrumStreamingConfigMessage::Averaging averaging,
+	const uint8_t averaging_shift
+) {
 	SpectrumStreamingConfigMessage message {
-		SpectrumStreamingConfigMessage::Mode::Running
+		SpectrumStreamingConfigMessage::Mode::Running,
+		window,
+		averaging,
+		averaging_shift
 	};
 	send_message(&message);
 }
@@ -320,11 +341,29 @@ void spectrum_streaming_stop() {
 	send_message(&message);
 }
 
+void channel_stats_restart(
+	const uint32_t epoch,
+	const uint32_t update_interval_ms
+) {
+	const ChannelStatsConfigMessage message { epoch, update_interval_ms };
+	send_message(&message);
+}
+
+void coded_squelch_reset(const uint32_t epoch) {
+	const CodedSquelchResetMessage message { epoch };
+	send_message(&message);
+}
+
 void set_sample_rate(const uint32_t sample_rate) {
 	SamplerateConfigMessage message { sample_rate };
 	send_message(&message);
 }
 
+void set_capture_chain(const size_t decimation, const bool narrow_filter) {
+	const CaptureChainConfigMessage message { decimation, narrow_filter };
+	send_message(&message);
+}
+
 void capture_start(CaptureConfig* const config) {
 	CaptureConfigMessage message { config };
 	send_message(&message);
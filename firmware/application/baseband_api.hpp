@@ -61,7 +61,7 @@ void set_tones_config(const uint32_t bw, const uint32_t pre_silence, const uint1
 void kill_tone();
 void set_sstv_data(const uint8_t vis_code, const uint32_t pixel_duration);
 void set_audiotx_config(const uint32_t divider, const float deviation_hz, const float audio_gain,
-					const uint32_t tone_key_delta);
+					const uint32_t tone_key_delta, const uint32_t bits_per_sample = 8);
 void set_fifo_data(const int8_t * data);
 void set_pitch_rssi(int32_t avg, bool enabled);
 void set_afsk_data(const uint32_t afsk_samples_per_bit, const uint32_t afsk_phase_inc_mark, const uint32_t afsk_phase_inc_space,
@@ -69,9 +69,11 @@ void set_afsk_data(const uint32_t afsk_samples_per_bit, const uint32_t afsk_phas
 void kill_afsk();
 void set_afsk(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word);
 
-void set_btle(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word);
+void set_btle(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word,
+				const uint8_t channel_number = 37);
 
-void set_nrf(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word);
+void set_nrf(const uint32_t baudrate, const uint32_t word_length, const uint32_t trigger_value, const bool trigger_word,
+				const uint64_t address = 0xE7E7E7E7E7);
 
 void set_ook_data(const uint32_t stream_length, const uint32_t samples_per_bit, const uint8_t repeat,
 					const uint32_t pause_symbols);
@@ -81,7 +83,14 @@ void set_pocsag(const pocsag::BitRate bitrate, bool phase);
 void set_adsb();
 void set_jammer(const bool run, const jammer::JammerType type, const uint32_t speed);
 void set_rds_data(const uint16_t message_length);
-void set_spectrum(const size_t sampling_rate, const size_t trigger);
+void set_spectrum(
+	const size_t sampling_rate,
+	const size_t trigger,
+	const size_t presum_factor = 1,
+	const bool overlap = true,
+	const size_t dc_bins = 2,
+	const size_t fft_size = 256
+);
 void set_siggen_tone(const uint32_t tone);
 void set_siggen_config(const uint32_t bw, const uint32_t shape, const uint32_t duration);
 void request_beep();
@@ -89,10 +98,21 @@ void request_beep();
 void run_image(const portapack::spi_flash::image_tag_t image_tag);
 void shutdown();
 
-void spectrum_streaming_start();
+void spectrum_streaming_start(
+	const SpectrumStreamingConfigMessage::Window window = SpectrumStreamingConfigMessage::Window::Hamming3,
+	const SpectrumStreamingConfigMessage::Averaging averaging = SpectrumStreamingConfigMessage::Averaging::None,
+	const uint8_t averaging_shift = 0
+);
 void spectrum_streaming_stop();
 
+void channel_stats_restart(
+	const uint32_t epoch,
+	const uint32_t update_interval_ms = ChannelStatsConfigMessage::update_interval_default_ms
+);
+void coded_squelch_reset(const uint32_t epoch);
+
 void set_sample_rate(const uint32_t sample_rate);
+void set_capture_chain(const size_t decimation, const bool narrow_filter);
 void capture_start(CaptureConfig* const config);
 void capture_stop();
 void replay_start(ReplayConfig* const config);
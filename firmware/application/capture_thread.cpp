@@ -24,6 +24,8 @@
 #include "baseband_api.hpp"
 #include "buffer_exchange.hpp"
 
+#include <array>
+
 struct BasebandCapture {
 	BasebandCapture(CaptureConfig* const config) {
 		baseband::capture_start(config);
@@ -40,9 +42,10 @@ CaptureThread::CaptureThread(
 	std::unique_ptr<stream::Writer> writer,
 	size_t write_size,
 	size_t buffer_count,
+	CaptureConfig::Format format,
 	std::function<void()> success_callback,
 	std::function<void(File::Error)> error_callback
-) : config { write_size, buffer_count },
+) : config { write_size, buffer_count, format },
 	writer { std::move(writer) },
 	success_callback { std::move(success_callback) },
 	error_callback { std::move(error_callback) }
@@ -73,17 +76,47 @@ msg_t CaptureThread::static_fn(void* arg) {
 }
 
 Optional<File::Error> CaptureThread::run() {
+	// Before the baseband starts filling buffers
+	const auto prepare_error = writer->prepare();
+	if( prepare_error.is_valid() ) {
+		return prepare_error;
+	}
+
 	BasebandCapture capture { &config };
 	BufferExchange buffers { &config };
 
+	StreamBuffer* next { nullptr };
+
 	while( !chThdShouldTerminate() ) {
-		auto buffer = buffers.get();
-		auto write_result = writer->write(buffer->data(), buffer->size());
+		// Gather full buffers that sit back to back in memory, so FatFs sees
+		// one large write (and can go straight to the card) instead of several.
+		std::array<StreamBuffer*, write_merge_max> run;
+		run[0] = next ? next : buffers.get();
+		next = nullptr;
+		auto run_length = 1U;
+		auto run_size = run[0]->size();
+
+		while( run_length < run.size() ) {
+			auto buffer = buffers.get_prefill();
+			if( !buffer ) {
+				break;
+			}
+			if( buffer->data() != static_cast<uint8_t*>(run[0]->data()) + run_size ) {
+				next = buffer;
+				break;
+			}
+			run[run_length++] = buffer;
+			run_size += buffer->size();
+		}
+
+		auto write_result = writer->write(run[0]->data(), run_size);
 		if( write_result.is_error() ) {
 			return write_result.error();
 		}
-		buffer->empty();
-		buffers.put(buffer);
+		for(size_t i=0; i<run_length; i++) {
+			run[i]->empty();
+			buffers.put(run[i]);
+		}
 	}
 
 	return { };
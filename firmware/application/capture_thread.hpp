@@ -39,6 +39,7 @@ public:
 		std::unique_ptr<stream::Writer> writer,
 		size_t write_size,
 		size_t buffer_count,
+		CaptureConfig::Format format,
 		std::function<void()> success_callback,
 		std::function<void(File::Error)> error_callback
 	);
@@ -54,6 +55,8 @@ public:
 	}
 
 private:
+	static constexpr size_t write_merge_max = 4;
+
 	CaptureConfig config;
 	std::unique_ptr<stream::Writer> writer;
 	std::function<void()> success_callback;
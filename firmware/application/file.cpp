@@ -56,7 +56,43 @@ Optional<File::Error> File::create(const std::filesystem::path& filename) {
 	return open_fatfs(filename, FA_WRITE | FA_CREATE_ALWAYS);
 }
 
+Optional<File::Error> File::preallocate(const Size size) {
+	if( (size == 0) || (f_size(&f) != 0) ) {
+		return { };
+	}
+
+	const auto result = f_expand(&f, size, 1);
+	if( result == FR_DENIED ) {
+		// No contiguous space (or too large), fall back to growing the file.
+		return { };
+	}
+	if( result != FR_OK ) {
+		return { result };
+	}
+
+	// The chain is contiguous, so the link map is known without walking the FAT.
+	const Size cluster_size = f.obj.fs->csize * _MIN_SS;
+	link_map = { {
+		link_map.size(),
+		static_cast<DWORD>((size + cluster_size - 1) / cluster_size),
+		f.obj.sclust,
+		0
+	} };
+	f.cltbl = link_map.data();
+	preallocated = true;
+	write_end = 0;
+
+	return { };
+}
+
 File::~File() {
+	if( preallocated ) {
+		// Give back the space that was reserved but never written.
+		if( f_lseek(&f, write_end) == FR_OK ) {
+			f_truncate(&f);
+		}
+		f.cltbl = nullptr;
+	}
 	f_close(&f);
 }
 
@@ -71,8 +107,14 @@ File::Result<File::Size> File::read(void* const data, const Size bytes_to_read)
 }
 
 File::Result<File::Size> File::write(const void* const data, const Size bytes_to_write) {
+	if( f.cltbl && (f_tell(&f) + bytes_to_write > f_size(&f)) ) {
+		// Past the reserved space, FatFs can only grow the chain without the link map.
+		f.cltbl = nullptr;
+	}
+
 	UINT bytes_written = 0;
 	const auto result = f_write(&f, data, bytes_to_write, &bytes_written);
+	write_end = std::max<Size>(write_end, f_tell(&f));
 	if( result == FR_OK ) {
 		if( bytes_to_write == bytes_written ) {
 			return { static_cast<File::Size>(bytes_written) };
@@ -97,6 +139,18 @@ File::Result<File::Offset> File::seek(const Offset new_position) {
 	return { static_cast<File::Offset>(old_position) };
 }
 
+Optional<File::Error> File::map_clusters(DWORD* const table, const size_t table_size) {
+	table[0] = table_size;
+	f.cltbl = table;
+	const auto result = f_lseek(&f, CREATE_LINKMAP);
+	if( result != FR_OK ) {
+		// Too fragmented for the table, seeks walk the FAT as before.
+		f.cltbl = nullptr;
+		return { result };
+	}
+	return { };
+}
+
 File::Size File::size() {
 	return { static_cast<File::Size>(f_size(&f)) };
 }
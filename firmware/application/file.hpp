@@ -325,11 +325,21 @@ public:
 	Optional<Error> open(const std::filesystem::path& filename);
 	Optional<Error> append(const std::filesystem::path& filename);
 	Optional<Error> create(const std::filesystem::path& filename);
+	/* Reserves one contiguous run of clusters in a new, empty file, so
+	 * writes up to `size` never touch the FAT. Without contiguous free space
+	 * the file grows as usual. Unwritten space is truncated on close.
+	 * Finding the run scans the FAT, which can take seconds on a large card.
+	 */
+	Optional<Error> preallocate(const Size size);
 
 	Result<Size> read(void* const data, const Size bytes_to_read);
 	Result<Size> write(const void* const data, const Size bytes_to_write);
 	
 	Result<Offset> seek(const uint64_t Offset);
+	/* Builds a cluster link map in `table` (kept by the caller for the life
+	 * of the file), so seeks in a large file skip walking the FAT.
+	 */
+	Optional<Error> map_clusters(DWORD* const table, const size_t table_size);
 	Timestamp created_date();
 	Size size();
 
@@ -345,6 +355,10 @@ public:
 
 private:
 	FIL f { };
+	// Cluster link map for fast seek: a single fragment, then terminator
+	std::array<DWORD, 4> link_map { };
+	bool preallocated { false };
+	Size write_end { 0 };
 
 	Optional<Error> open_fatfs(const std::filesystem::path& filename, BYTE mode);
 };
@@ -35,94 +35,336 @@ std::vector<std::string> get_freqman_files() {
 	return file_list;
 };
 
-bool load_freqman_file(std::string& file_stem, freqman_db &db) {
-	File freqman_file;
-	size_t length, n = 0, file_position = 0;
-	char * pos;
-	char * line_start;
-	char * line_end;
-	std::string description;
-	rf::Frequency frequency_a, frequency_b;
-	char file_data[257];
+/* Single-pass tokenizer for "key=value,key=value" lines. Lines can span
+ * read blocks, so all state is carried between feed() calls.
+ */
+struct freqman_token {
+	rf::Frequency frequency_a;
+	rf::Frequency frequency_b;
 	freqman_entry_type type;
+	const char* description;
+	size_t description_length;
+};
+
+class FreqmanTokenizer {
+public:
+	// Callback returns false to stop parsing.
+	template<typename Callback>
+	bool feed(const char* p, const size_t count, Callback callback) {
+		for(size_t i = 0; i < count; i++) {
+			const char c = p[i];
+			
+			if (c == '\x0A') {
+				if (!end_line(callback))
+					return false;
+			} else if (c == '\x0D') {
+				continue;
+			} else if (in_value) {
+				if (c == ',')
+					in_value = false;
+				else
+					value_char(c);
+			} else if (c == '=') {
+				begin_value();
+			} else if (c == ',') {
+				key = 0;
+			} else {
+				key = c;
+			}
+		}
+		return true;
+	}
 	
-	db.clear();
+	template<typename Callback>
+	bool end_line(Callback callback) {
+		bool more = true;
+		
+		if (has_frequency) {
+			if (!has_description) {
+				description[0] = '-';
+				description_length = 1;
+			}
+			more = callback(freqman_token {
+				frequency_a,
+				(type == RANGE) ? frequency_b : 0,
+				type,
+				description,
+				description_length
+			});
+		}
+		
+		key = 0;
+		in_value = false;
+		has_frequency = false;
+		has_description = false;
+		description_length = 0;
+		frequency_a = 0;
+		frequency_b = 0;
+		type = SINGLE;
+		
+		return more;
+	}
+
+private:
+	char key { 0 };
+	bool in_value { false };
+	bool digits_done { false };
+	bool has_frequency { false };
+	bool has_description { false };
+	freqman_entry_type type { SINGLE };
+	rf::Frequency frequency_a { 0 };
+	rf::Frequency frequency_b { 0 };
+	char description[FREQMAN_DESC_MAX_LEN] { };
+	size_t description_length { 0 };
+	
+	void begin_value() {
+		in_value = true;
+		digits_done = false;
+		
+		switch (key) {
+			case 'f':
+				// "f=" wins over a range on the same line, as before
+				has_frequency = true;
+				type = SINGLE;
+				frequency_a = 0;
+				break;
+			case 'a':
+				if (!has_frequency || (type == RANGE)) {
+					has_frequency = true;
+					type = RANGE;
+					frequency_a = 0;
+				} else {
+					key = 0;
+				}
+				break;
+			case 'b':
+				frequency_b = 0;
+				break;
+			case 'd':
+				has_description = true;
+				description_length = 0;
+				break;
+			default:
+				break;
+		}
+	}
+	
+	void value_char(const char c) {
+		if (key == 'd') {
+			if (description_length < FREQMAN_DESC_MAX_LEN)
+				description[description_length++] = c;
+			return;
+		}
+		
+		// Same as strtoll(): stop at the first non-digit
+		if (digits_done)
+			return;
+		if ((c < '0') || (c > '9')) {
+			digits_done = true;
+			return;
+		}
+		
+		if (key == 'f')
+			frequency_a = frequency_a * 10 + (c - '0');
+		else if ((key == 'a') && (type == RANGE))
+			frequency_a = frequency_a * 10 + (c - '0');
+		else if (key == 'b')
+			frequency_b = frequency_b * 10 + (c - '0');
+	}
+};
+
+// Whole FAT sectors, so FatFs can read straight into the buffer.
+static constexpr size_t freqman_read_size = 4096;
+
+template<typename Callback>
+static bool parse_freqman_file(const std::string& file_stem, Callback callback) {
+	File freqman_file;
+	FreqmanTokenizer tokenizer;
+	std::vector<char> file_data(freqman_read_size);
 	
 	auto result = freqman_file.open("FREQMAN/" + file_stem + ".TXT");
 	if (result.is_valid())
 		return false;
 	
 	while (1) {
-		// Read a 256 bytes block from file
-		freqman_file.seek(file_position);
-		
-		memset(file_data, 0, 257);
-		auto read_size = freqman_file.read(file_data, 256);
+		auto read_size = freqman_file.read(file_data.data(), freqman_read_size);
 		if (read_size.is_error())
 			return false;	// Read error
 		
-		file_position += 256;
-		
-		// Reset line_start to beginning of buffer
-		line_start = file_data;
-		
-		if (!strstr(file_data, "f=") && !strstr(file_data, "a="))
-			break;
-		
-		// Look for complete lines in buffer
-		while ((line_end = strstr(line_start, "\x0A"))) {
-			// Read frequency
-			pos = strstr(line_start, "f=");
-			frequency_b = 0;
-			type = SINGLE;
-			if (pos) {
-				pos += 2;
-				frequency_a = strtoll(pos, nullptr, 10);
-			} else {
-				// ...or range
-				pos = strstr(line_start, "a=");
-				if (pos) {
-					pos += 2;
-					frequency_a = strtoll(pos, nullptr, 10);
-					type = RANGE;
-					pos = strstr(line_start, "b=");
-					if (pos) {
-						pos += 2;
-						frequency_b = strtoll(pos, nullptr, 10);
-					} else
-						frequency_b = 0;
-				} else
-					frequency_a = 0;
-			}
-			
-			// Read description until , or LF
-			pos = strstr(line_start, "d=");
-			if (pos) {
-				pos += 2;
-				length = std::min(strcspn(pos, ",\x0A"), (size_t)FREQMAN_DESC_MAX_LEN);
-				description = string(pos, length);
-			} else
-				description = "-";
-			
-			db.push_back({ frequency_a, frequency_b, description, type });
-			n++;
-			
-			if (n >= FREQMAN_MAX_PER_FILE) return true;
-			
-			line_start = line_end + 1;
-			if (line_start - file_data >= 256) break;
-		}
+		if (!tokenizer.feed(file_data.data(), read_size.value(), callback))
+			return true;
 		
-		if (read_size.value() != 256)
+		if (read_size.value() != freqman_read_size)
 			break;	// End of file
-		
-		// Restart at beginning of last incomplete line
-		file_position -= (file_data + 256 - line_start);
+	}
+	
+	// Last line may not be terminated
+	tokenizer.end_line(callback);
+	
+	return true;
+}
+
+bool load_freqman_file(std::string& file_stem, freqman_db &db) {
+	db.clear();
+	
+	return parse_freqman_file(file_stem, [&db](const freqman_token& token) {
+		db.push_back({
+			token.frequency_a,
+			token.frequency_b,
+			std::string(token.description, token.description_length),
+			token.type
+		});
+		return db.size() < FREQMAN_MAX_PER_FILE;
+	});
+}
+
+struct freqman_sidecar_header {
+	static constexpr uint32_t magic_value = 0x31494d46;	// "FMI1"
+	
+	uint32_t magic;
+	uint16_t source_date;
+	uint16_t source_time;
+	uint32_t source_size;
+	uint32_t entry_count;
+	uint32_t pool_size;
+};
+
+void FreqmanIndex::clear() {
+	entries.clear();
+	entries.shrink_to_fit();
+	pool.clear();
+	pool.shrink_to_fit();
+	by_frequency.clear();
+	by_frequency.shrink_to_fit();
+}
+
+bool FreqmanIndex::load(const std::string& file_stem, const bool use_sidecar) {
+	clear();
+	
+	uint32_t source_size;
+	{
+		File freqman_file;
+		auto result = freqman_file.open("FREQMAN/" + file_stem + ".TXT");
+		if (result.is_valid())
+			return false;
+		source_size = freqman_file.size();
+	}
+	const auto source_date = file_created_date("FREQMAN/" + file_stem + ".TXT");
+	
+	if (use_sidecar && load_sidecar(file_stem, source_date, source_size))
+		return true;
+	
+	const bool parsed = parse_freqman_file(file_stem, [this](const freqman_token& token) {
+		freqman_packed_entry packed { };
+		packed.frequency_a = token.frequency_a;
+		packed.frequency_b = token.frequency_b;
+		packed.type = token.type;
+		packed.description_offset = pool.size();
+		packed.description_length = token.description_length;
+		entries.push_back(packed);
+		pool.insert(pool.end(), token.description, token.description + token.description_length);
+		return entries.size() < entries_max;
+	});
+	if (!parsed) {
+		clear();
+		return false;
+	}
+	
+	entries.shrink_to_fit();
+	pool.shrink_to_fit();
+	
+	by_frequency.resize(entries.size());
+	for (size_t n = 0; n < by_frequency.size(); n++)
+		by_frequency[n] = n;
+	std::stable_sort(by_frequency.begin(), by_frequency.end(), [this](const uint16_t a, const uint16_t b) {
+		return entries[a].frequency_a < entries[b].frequency_a;
+	});
+	
+	if (use_sidecar)
+		save_sidecar(file_stem, source_date, source_size);
+	
+	return true;
+}
+
+bool FreqmanIndex::load_sidecar(const std::string& file_stem, const FATTimestamp source_date, const uint32_t source_size) {
+	File sidecar_file;
+	freqman_sidecar_header header;
+	
+	auto result = sidecar_file.open("FREQMAN/" + file_stem + ".IDX");
+	if (result.is_valid())
+		return false;
+	
+	auto read_size = sidecar_file.read(&header, sizeof(header));
+	if (read_size.is_error() || (read_size.value() != sizeof(header)))
+		return false;
+	
+	if ((header.magic != freqman_sidecar_header::magic_value) ||
+		(header.source_date != source_date.FAT_date) ||
+		(header.source_time != source_date.FAT_time) ||
+		(header.source_size != source_size) ||
+		(header.entry_count > entries_max))
+		return false;
+	
+	const File::Size expected_size = sizeof(header) +
+		header.entry_count * (sizeof(freqman_packed_entry) + sizeof(uint16_t)) +
+		header.pool_size;
+	if (sidecar_file.size() != expected_size)
+		return false;
+	
+	entries.resize(header.entry_count);
+	pool.resize(header.pool_size);
+	by_frequency.resize(header.entry_count);
+	
+	if (sidecar_file.read(entries.data(), entries.size() * sizeof(freqman_packed_entry)).is_error() ||
+		sidecar_file.read(pool.data(), pool.size()).is_error() ||
+		sidecar_file.read(by_frequency.data(), by_frequency.size() * sizeof(uint16_t)).is_error()) {
+		clear();
+		return false;
 	}
 	
 	return true;
 }
 
+void FreqmanIndex::save_sidecar(const std::string& file_stem, const FATTimestamp source_date, const uint32_t source_size) {
+	File sidecar_file;
+	
+	auto result = sidecar_file.create("FREQMAN/" + file_stem + ".IDX");
+	if (result.is_valid())
+		return;
+	
+	const freqman_sidecar_header header {
+		freqman_sidecar_header::magic_value,
+		source_date.FAT_date,
+		source_date.FAT_time,
+		source_size,
+		entries.size(),
+		pool.size()
+	};
+	
+	sidecar_file.write(&header, sizeof(header));
+	sidecar_file.write(entries.data(), entries.size() * sizeof(freqman_packed_entry));
+	sidecar_file.write(pool.data(), pool.size());
+	sidecar_file.write(by_frequency.data(), by_frequency.size() * sizeof(uint16_t));
+}
+
+std::string FreqmanIndex::description(const size_t n) const {
+	const auto& packed = entries[n];
+	return std::string(&pool[packed.description_offset], packed.description_length);
+}
+
+freqman_entry FreqmanIndex::entry(const size_t n) const {
+	return { frequency_a(n), frequency_b(n), description(n), type(n) };
+}
+
+size_t FreqmanIndex::lower_bound(const rf::Frequency frequency) const {
+	const auto it = std::lower_bound(by_frequency.begin(), by_frequency.end(), frequency,
+		[this](const uint16_t n, const rf::Frequency f) {
+			return (rf::Frequency)entries[n].frequency_a < f;
+		}
+	);
+	return it - by_frequency.begin();
+}
+
 bool save_freqman_file(std::string& file_stem, freqman_db &db) {
 	File freqman_file;
 	std::string item_string;
@@ -131,6 +373,9 @@ bool save_freqman_file(std::string& file_stem, freqman_db &db) {
 	if (!create_freqman_file(file_stem, freqman_file))
 		return false;
 	
+	// FAT timestamps are too coarse to catch a quick re-save
+	delete_file("FREQMAN/" + file_stem + ".IDX");
+	
 	for (size_t n = 0; n < db.size(); n++) {
 		auto& entry = db[n];
 
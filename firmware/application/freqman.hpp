@@ -22,6 +22,7 @@
 
 #include <cstring>
 #include <string>
+#include <vector>
 #include "file.hpp"
 #include "ui_receiver.hpp"
 #include "string_format.hpp"
@@ -57,6 +58,62 @@ struct freqman_entry {
 
 using freqman_db = std::vector<freqman_entry>;
 
+// Packed form of freqman_entry, descriptions live in FreqmanIndex's pool.
+struct freqman_packed_entry {
+	uint64_t frequency_a : 40;
+	uint64_t description_length : 5;
+	uint64_t type : 1;
+	uint64_t : 18;
+	uint64_t frequency_b : 40;
+	uint64_t description_offset : 24;
+};
+
+static_assert(sizeof(freqman_packed_entry) == 16, "freqman_packed_entry wrong size");
+
+/* Read-only view of a frequency file for large lists (scanner).
+ * Entries are kept packed in file order with all descriptions in a single
+ * pool, plus an index of entries sorted by frequency. The parsed tables are
+ * cached in FREQMAN/<stem>.IDX and reused while the .TXT is unchanged.
+ */
+class FreqmanIndex {
+public:
+	static constexpr size_t entries_max = 65535;
+
+	bool load(const std::string& file_stem, const bool use_sidecar = true);
+	void clear();
+
+	size_t size() const {
+		return entries.size();
+	}
+
+	rf::Frequency frequency_a(const size_t n) const {
+		return entries[n].frequency_a;
+	}
+	rf::Frequency frequency_b(const size_t n) const {
+		return entries[n].frequency_b;
+	}
+	freqman_entry_type type(const size_t n) const {
+		return static_cast<freqman_entry_type>(entries[n].type);
+	}
+	std::string description(const size_t n) const;
+	freqman_entry entry(const size_t n) const;
+
+	// n-th entry in ascending frequency_a order.
+	size_t sorted(const size_t n) const {
+		return by_frequency[n];
+	}
+	// First entry (in sorted order) at or above the frequency, size() if none.
+	size_t lower_bound(const rf::Frequency frequency) const;
+
+private:
+	std::vector<freqman_packed_entry> entries { };
+	std::vector<char> pool { };
+	std::vector<uint16_t> by_frequency { };
+
+	bool load_sidecar(const std::string& file_stem, const FATTimestamp source_date, const uint32_t source_size);
+	void save_sidecar(const std::string& file_stem, const FATTimestamp source_date, const uint32_t source_size);
+};
+
 std::vector<std::string> get_freqman_files();
 bool load_freqman_file(std::string& file_stem, freqman_db& db);
 bool save_freqman_file(std::string& file_stem, freqman_db& db);
@@ -268,6 +268,10 @@ void RFFC507x::set_gpo1(const bool new_value) {
 	flush_one(Register::GPO);
 }
 
+bool RFFC507x::is_locked() {
+	return (readback(Readback::TuningCalibration) >> 15) & 1;
+}
+
 spi::reg_t RFFC507x::readback(const Readback readback) {
 	/* TODO: This clobbers the rest of the DEV_CTRL register
 	 * Time to implement bitfields for registers.
@@ -809,6 +809,9 @@ public:
 	void set_mixer_current(const uint8_t value);
 	void set_frequency(const rf::Frequency lo_frequency);
 	void set_gpo1(const bool new_value);
+
+	/* Synthesizer lock, from the LOCK bit of the tuning calibration readback. */
+	bool is_locked();
 	
 	reg_t read(const address_t reg_num);
 
@@ -33,6 +33,8 @@ public:
 
 class Writer {
 public:
+	// Slow setup, run by the writing thread before the first write
+	virtual Optional<File::Error> prepare() { return { }; }
 	virtual File::Result<File::Size> write(const void* const buffer, const File::Size bytes) = 0;
 	virtual ~Writer() = default;
 };
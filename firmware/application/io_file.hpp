@@ -61,11 +61,22 @@ public:
 		return file.create(filename);
 	}
 
+	// The space is reserved by prepare(), on the writing thread
+	Optional<File::Error> create(const std::filesystem::path& filename, const File::Size preallocate_size) {
+		this->preallocate_size = preallocate_size;
+		return file.create(filename);
+	}
+
+	Optional<File::Error> prepare() override {
+		return file.preallocate(preallocate_size);
+	}
+
 	File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
 	
 protected:
 	File file { };
 	uint64_t bytes_written { 0 };
+	File::Size preallocate_size { 0 };
 };
 
 using RawFileWriter = FileWriter;
@@ -21,17 +21,132 @@
 
 #include "log_file.hpp"
 
-#include "string_format.hpp"
+#include "rtc_time.hpp"
+
+#include "hal.h"
+
+#include <algorithm>
+
+LogFile::~LogFile() {
+	flush();
+	if( tick_registered ) {
+		rtc_time::signal_tick_second -= signal_token_tick_second;
+	}
+}
+
+Optional<File::Error> LogFile::append(const std::filesystem::path& filename) {
+	if( file_open ) {
+		flush();
+	}
+
+	const auto error = file.append(filename);
+	file_open = !error.is_valid();
+	if( !file_open ) {
+		return error;
+	}
+
+	batch_size = buffer_size - (file.size() % buffer_size);
+
+	if( !tick_registered ) {
+		signal_token_tick_second = rtc_time::signal_tick_second += [this]() {
+			this->on_tick_second();
+		};
+		tick_registered = true;
+	}
+
+	return { };
+}
 
 Optional<File::Error> LogFile::write_entry(const rtc::RTC& datetime, const std::string& entry) {
-	std::string timestamp = to_string_timestamp(datetime);
-	return write_line(timestamp + " " + entry);
+	if( !file_open ) {
+		return { };
+	}
+
+	// YYYYMMDDhhmmss, same as to_string_timestamp()
+	queue_decimal(datetime.year(), 4);
+	queue_decimal(datetime.month(), 2);
+	queue_decimal(datetime.day(), 2);
+	queue_decimal(datetime.hour(), 2);
+	queue_decimal(datetime.minute(), 2);
+	queue_decimal(datetime.second(), 2);
+	queue(" ", 1);
+	queue(entry.data(), entry.size());
+	queue("\r\n", 2);
+
+	// Report a failed batch write once
+	const auto error = queue_error;
+	queue_error = { };
+	return error;
 }
 
-Optional<File::Error> LogFile::write_line(const std::string& message) {
-	auto error = file.write_line(message);
+Optional<File::Error> LogFile::flush() {
+	if( !file_open ) {
+		return { };
+	}
+
+	const halrtcnt_t start = halGetCounterValue();
+
+	auto error = write_batch();
+	const auto sync_error = file.sync();
 	if( !error.is_valid() ) {
-		file.sync();
+		error = sync_error;
 	}
+
+	const uint32_t latency_us = RTT2US(halGetCounterValue() - start);
+	stats_.flush_count++;
+	stats_.flush_latency_us = latency_us;
+	stats_.flush_latency_max_us = std::max(stats_.flush_latency_max_us, latency_us);
+
 	return error;
 }
+
+void LogFile::queue(const char* data, size_t length) {
+	while( length ) {
+		const size_t count = std::min(length, batch_size - stats_.queued_bytes);
+		std::copy(data, data + count, &buffer[stats_.queued_bytes]);
+		stats_.queued_bytes += count;
+		data += count;
+		length -= count;
+
+		if( stats_.queued_bytes == batch_size ) {
+			const auto error = write_batch();
+			if( error.is_valid() ) {
+				queue_error = error;
+			}
+		}
+	}
+}
+
+void LogFile::queue_decimal(uint32_t value, const size_t digits) {
+	char text[10];
+	for(size_t i=digits; i>0; i--) {
+		text[i - 1] = '0' + (value % 10);
+		value /= 10;
+	}
+	queue(text, digits);
+}
+
+Optional<File::Error> LogFile::write_batch() {
+	const size_t length = stats_.queued_bytes;
+	stats_.queued_bytes = 0;
+	queued_seconds = 0;
+
+	if( length == 0 ) {
+		return { };
+	}
+
+	const auto result = file.write(buffer.data(), length);
+	// A partial batch (timed flush) leaves the end of the file mid-sector,
+	// so the next batch only fills up to the sector boundary.
+	batch_size = buffer_size - (file.size() % buffer_size);
+	if( result.is_error() ) {
+		return { result.error() };
+	}
+	return { };
+}
+
+void LogFile::on_tick_second() {
+	if( stats_.queued_bytes && (++queued_seconds >= flush_interval_s) ) {
+		flush();
+	}
+}
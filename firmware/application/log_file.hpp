@@ -22,25 +22,71 @@
 #ifndef __LOG_FILE_H__
 #define __LOG_FILE_H__
 
+#include <cstdint>
+#include <cstddef>
+#include <array>
 #include <string>
 
 #include "file.hpp"
+#include "signal.hpp"
 
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
+/* Lines are queued in RAM and written a sector at a time. The first batch
+ * after append() only tops up the file's last partial sector, so later
+ * writes stay sector aligned. Whatever is queued is written and synced
+ * flush_interval_s after it was queued, on append() of another file and on
+ * destruction; FAT directory updates only happen then.
+ */
 class LogFile {
 public:
-	Optional<File::Error> append(const std::filesystem::path& filename) {
-		return file.append(filename);
-	}
+	static constexpr size_t buffer_size = 512;
+	static constexpr uint32_t flush_interval_s = 5;
+
+	struct Stats {
+		size_t queued_bytes { 0 };
+		uint32_t flush_count { 0 };
+		uint32_t flush_latency_us { 0 };		// Last flush, write and sync
+		uint32_t flush_latency_max_us { 0 };
+	};
+
+	LogFile() = default;
+	~LogFile();
+
+	LogFile(const LogFile&) = delete;
+	LogFile(LogFile&&) = delete;
+	LogFile& operator=(const LogFile&) = delete;
+	LogFile& operator=(LogFile&&) = delete;
+
+	Optional<File::Error> append(const std::filesystem::path& filename);
 
 	Optional<File::Error> write_entry(const rtc::RTC& datetime, const std::string& entry);
 
+	/* Writes out and syncs everything queued. */
+	Optional<File::Error> flush();
+
+	const Stats& stats() const {
+		return stats_;
+	}
+
 private:
 	File file { };
+	bool file_open { false };
+
+	std::array<char, buffer_size> buffer { };
+	size_t batch_size { buffer_size };
+	uint32_t queued_seconds { 0 };
+	Stats stats_ { };
+	Optional<File::Error> queue_error { };
+
+	bool tick_registered { false };
+	SignalToken signal_token_tick_second { };
 
-	Optional<File::Error> write_line(const std::string& message);
+	void queue(const char* data, size_t length);
+	void queue_decimal(uint32_t value, const size_t digits);
+	Optional<File::Error> write_batch();
+	void on_tick_second();
 };
 
 #endif/*__LOG_FILE_H__*/
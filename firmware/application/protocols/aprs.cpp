@@ -24,6 +24,9 @@
 #include "ax25.hpp"
 
 #include "portapack_persistent_memory.hpp"
+#include "string_format.hpp"
+
+#include <cmath>
 
 using namespace ax25;
 
@@ -45,4 +48,267 @@ void make_aprs_frame(const char * src_address, const uint32_t src_ssid,
 	frame.make_ui_frame(address, 0x03, protocol_id_t::NO_LAYER3, payload);
 }
 
+// Spaces stand for digits blanked out for position ambiguity
+static bool read_digits(const std::string& s, const size_t offset, const size_t count, uint32_t& value) {
+	value = 0;
+	
+	for (size_t i = offset; i < offset + count; i++) {
+		const char c = s[i];
+		if ((c >= '0') && (c <= '9'))
+			value = value * 10 + (c - '0');
+		else if (c == ' ')
+			value = value * 10;
+		else
+			return false;
+	}
+	
+	return true;
+}
+
+static bool read_base91(const std::string& s, const size_t offset, uint32_t& value) {
+	value = 0;
+	
+	for (size_t i = offset; i < offset + 4; i++) {
+		const char c = s[i];
+		if ((c < 33) || (c > 124))
+			return false;
+		value = value * 91 + (c - 33);
+	}
+	
+	return true;
+}
+
+static std::string trim_right(const std::string& s) {
+	const auto end = s.find_last_not_of(' ');
+	return (end == std::string::npos) ? "" : s.substr(0, end + 1);
+}
+
+static std::string to_string_degrees(const float value) {
+	const uint32_t v = std::abs(value) * 10000.0f + 0.5f;
+	return ((value < 0) ? "-" : "") + to_string_dec_uint(v / 10000) + "." + to_string_dec_uint(v % 10000, 4, '0');
+}
+
+APRSPacket::APRSPacket(const ax25::Packet& packet) {
+	const auto& info = packet.info();
+	if (info.empty())
+		return;
+	
+	switch (info[0]) {
+	case '!':
+	case '=':
+		type_ = DataType::Position;
+		parse_position(info, 1);
+		break;
+	
+	case '/':
+	case '@':
+		// 7 character timestamp first
+		type_ = DataType::Position;
+		parse_position(info, 8);
+		break;
+	
+	case '`':
+	case '\'':
+	case 0x1C:
+	case 0x1D:
+		type_ = DataType::MicE;
+		parse_mic_e(packet.destination().callsign, info);
+		break;
+	
+	case ';':
+		// Name, live/killed flag, timestamp
+		type_ = DataType::Object;
+		if (info.size() > 18) {
+			name_ = trim_right(info.substr(1, 9));
+			parse_position(info, 18);
+		}
+		break;
+	
+	case ')': {
+		type_ = DataType::Item;
+		const auto end = info.find_first_of("!_", 1);
+		if ((end != std::string::npos) && (end >= 4) && (end <= 10)) {
+			name_ = info.substr(1, end - 1);
+			parse_position(info, end + 1);
+		}
+		break;
+	}
+	
+	case ':':
+		if ((info.size() > 10) && (info[10] == ':')) {
+			type_ = DataType::Message;
+			name_ = trim_right(info.substr(1, 9));
+			text_ = info.substr(11);
+		}
+		break;
+	
+	case '>':
+		type_ = DataType::Status;
+		text_ = info.substr(1);
+		break;
+	
+	case 'T':
+		type_ = DataType::Telemetry;
+		text_ = info.substr(1);
+		break;
+	
+	case '_':
+		type_ = DataType::Weather;
+		text_ = info.substr(1);
+		break;
+	
+	default:
+		break;
+	}
+	
+	// Keep whatever couldn't be decoded readable
+	if (!has_position_ && text_.empty() && name_.empty())
+		text_ = info;
+}
+
+/* Uncompressed "DDMM.mmN/DDDMM.mmW$" or compressed "/YYYYXXXX$csT", the
+ * rest is the comment.
+ */
+bool APRSPacket::parse_position(const std::string& info, const size_t offset) {
+	if (offset >= info.size())
+		return false;
+	
+	const char first = info[offset];
+	
+	if (((first >= '0') && (first <= '9')) || (first == ' ')) {
+		if (info.size() < offset + 19)
+			return false;
+		
+		uint32_t lat_deg, lat_min, lat_hun, lon_deg, lon_min, lon_hun;
+		if (!read_digits(info, offset, 2, lat_deg) ||
+			!read_digits(info, offset + 2, 2, lat_min) ||
+			(info[offset + 4] != '.') ||
+			!read_digits(info, offset + 5, 2, lat_hun) ||
+			!read_digits(info, offset + 9, 3, lon_deg) ||
+			!read_digits(info, offset + 12, 2, lon_min) ||
+			(info[offset + 14] != '.') ||
+			!read_digits(info, offset + 15, 2, lon_hun))
+			return false;
+		
+		const char ns = info[offset + 7];
+		const char ew = info[offset + 17];
+		if (((ns != 'N') && (ns != 'S')) || ((ew != 'E') && (ew != 'W')))
+			return false;
+		
+		latitude_ = lat_deg + (lat_min + lat_hun / 100.0f) / 60.0f;
+		longitude_ = lon_deg + (lon_min + lon_hun / 100.0f) / 60.0f;
+		if (ns == 'S')
+			latitude_ = -latitude_;
+		if (ew == 'W')
+			longitude_ = -longitude_;
+		
+		symbol_table_ = info[offset + 8];
+		symbol_code_ = info[offset + 18];
+		text_ = info.substr(offset + 19);
+	} else {
+		if (info.size() < offset + 13)
+			return false;
+		
+		uint32_t y, x;
+		if (!read_base91(info, offset + 1, y) || !read_base91(info, offset + 5, x))
+			return false;
+		
+		latitude_ = 90.0f - y / 380926.0f;
+		longitude_ = -180.0f + x / 190463.0f;
+		symbol_table_ = first;
+		symbol_code_ = info[offset + 9];
+		text_ = info.substr(offset + 13);
+	}
+	
+	if ((std::abs(latitude_) > 90.0f) || (std::abs(longitude_) > 180.0f))
+		return false;
+	
+	has_position_ = true;
+	return true;
+}
+
+/* Latitude and flags are in the destination callsign, longitude in the info
+ * field's first three bytes.
+ */
+bool APRSPacket::parse_mic_e(const std::string& destination, const std::string& info) {
+	if ((destination.size() != 6) || (info.size() < 9))
+		return false;
+	
+	uint32_t digits[6];
+	for (size_t i = 0; i < 6; i++) {
+		const char c = destination[i];
+		if ((c >= '0') && (c <= '9'))
+			digits[i] = c - '0';
+		else if ((c >= 'A') && (c <= 'J'))
+			digits[i] = c - 'A';
+		else if ((c >= 'P') && (c <= 'Y'))
+			digits[i] = c - 'P';
+		else if ((c == 'K') || (c == 'L') || (c == 'Z'))
+			digits[i] = 0;		// Ambiguity
+		else
+			return false;
+	}
+	
+	const bool north = destination[3] >= 'P';
+	const bool longitude_offset = destination[4] >= 'P';
+	const bool west = destination[5] >= 'P';
+	
+	latitude_ = (digits[0] * 10 + digits[1]) +
+		((digits[2] * 10 + digits[3]) + (digits[4] * 10 + digits[5]) / 100.0f) / 60.0f;
+	if (!north)
+		latitude_ = -latitude_;
+	
+	int32_t lon_deg = info[1] - 28;
+	if (longitude_offset)
+		lon_deg += 100;
+	if ((lon_deg >= 180) && (lon_deg <= 189))
+		lon_deg -= 80;
+	else if ((lon_deg >= 190) && (lon_deg <= 199))
+		lon_deg -= 190;
+	
+	int32_t lon_min = info[2] - 28;
+	if (lon_min >= 60)
+		lon_min -= 60;
+	const int32_t lon_hun = info[3] - 28;
+	
+	longitude_ = lon_deg + (lon_min + lon_hun / 100.0f) / 60.0f;
+	if (west)
+		longitude_ = -longitude_;
+	
+	symbol_code_ = info[7];
+	symbol_table_ = info[8];
+	text_ = info.substr(9);
+	
+	if ((std::abs(latitude_) > 90.0f) || (std::abs(longitude_) > 180.0f))
+		return false;
+	
+	has_position_ = true;
+	return true;
+}
+
+std::string APRSPacket::to_string() const {
+	std::string result;
+	
+	switch (type_) {
+	case DataType::Object:
+	case DataType::Item:
+		result = "Obj " + name_ + " ";
+		break;
+	
+	case DataType::Message:
+		return "Msg to " + name_ + ": " + text_;
+	
+	case DataType::Status:
+		return "Status: " + text_;
+	
+	default:
+		break;
+	}
+	
+	if (has_position_)
+		result += to_string_degrees(latitude_) + " " + to_string_degrees(longitude_) + " ";
+	
+	return result + text_;
+}
+
 } /* namespace aprs */
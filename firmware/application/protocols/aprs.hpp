@@ -20,6 +20,9 @@
  * Boston, MA 02110-1301, USA.
  */
 
+#include "ax25.hpp"
+
+#include <cstdint>
 #include <cstring>
 #include <string>
 
@@ -33,6 +36,77 @@ namespace aprs {
 		const char * dest_address, const uint32_t dest_ssid,
 		const std::string& payload);
 
+enum class DataType {
+	Unknown,
+	Position,
+	MicE,
+	Object,
+	Item,
+	Message,
+	Status,
+	Telemetry,
+	Weather,
+};
+
+/* Decoded information field of an APRS frame. Positions are in degrees, north
+ * and east positive. Timestamps, course/speed and extensions are left in the
+ * comment.
+ */
+class APRSPacket {
+public:
+	APRSPacket(const ax25::Packet& packet);
+
+	DataType type() const {
+		return type_;
+	}
+
+	bool has_position() const {
+		return has_position_;
+	}
+
+	float latitude() const {
+		return latitude_;
+	}
+
+	float longitude() const {
+		return longitude_;
+	}
+
+	char symbol_table() const {
+		return symbol_table_;
+	}
+
+	char symbol_code() const {
+		return symbol_code_;
+	}
+
+	// Object or item name, message addressee
+	const std::string& name() const {
+		return name_;
+	}
+
+	// Comment, status or message text
+	const std::string& text() const {
+		return text_;
+	}
+
+	// One line for the console
+	std::string to_string() const;
+
+private:
+	DataType type_ { DataType::Unknown };
+	bool has_position_ { false };
+	float latitude_ { 0 };
+	float longitude_ { 0 };
+	char symbol_table_ { 0 };
+	char symbol_code_ { 0 };
+	std::string name_ { };
+	std::string text_ { };
+
+	bool parse_position(const std::string& info, const size_t offset);
+	bool parse_mic_e(const std::string& destination, const std::string& info);
+};
+
 } /* namespace aprs */
 
 #endif/*__APRS_H__*/
@@ -23,9 +23,92 @@
 #include "ax25.hpp"
 
 #include "portapack_shared_memory.hpp"
+#include "string_format.hpp"
 
 namespace ax25 {
 
+static constexpr size_t address_length = 7;
+
+static Address unpack_address(const uint8_t* const data) {
+	Address address { };
+	
+	for (size_t i = 0; i < 6; i++) {
+		const char c = data[i] >> 1;
+		if (c != ' ')
+			address.callsign += c;
+	}
+	address.ssid = (data[6] >> 1) & 15;
+	address.repeated = data[6] & 0x80;
+	
+	return address;
+}
+
+std::string Address::to_string() const {
+	if (ssid)
+		return callsign + "-" + to_string_dec_uint(ssid);
+	else
+		return callsign;
+}
+
+Packet::Packet(const uint8_t* const data, const size_t length) {
+	// Addresses end with the low bit set in their last byte
+	size_t address_count = 0;
+	size_t offset = 0;
+	bool last = false;
+	
+	while (!last) {
+		if ((offset + address_length > length) || (address_count >= 2 + digipeaters_max))
+			return;
+		
+		const auto address = unpack_address(&data[offset]);
+		last = data[offset + address_length - 1] & 1;
+		
+		if (address_count == 0)
+			destination_ = address;
+		else if (address_count == 1)
+			source_ = address;
+		else
+			digipeaters_[digipeater_count_++] = address;
+		
+		address_count++;
+		offset += address_length;
+	}
+	
+	if ((address_count < 2) || (offset >= length))
+		return;
+	
+	control_ = data[offset++];
+	
+	// I and UI frames carry a PID
+	if (((control_ & 1) == 0) || ((control_ & 0xEF) == 0x03)) {
+		if (offset >= length)
+			return;
+		protocol_ = data[offset++];
+	}
+	
+	info_.assign(reinterpret_cast<const char*>(&data[offset]), length - offset);
+	valid = true;
+}
+
+std::string Packet::path_string() const {
+	std::string result = source_.to_string() + ">" + destination_.to_string();
+	
+	// Only the last digipeater that has repeated the frame is starred
+	size_t last_repeated = digipeater_count_;
+	for (size_t i = 0; i < digipeater_count_; i++) {
+		if (digipeaters_[i].repeated)
+			last_repeated = i;
+	}
+	
+	for (size_t i = 0; i < digipeater_count_; i++) {
+		result += "," + digipeaters_[i].to_string();
+		if (i == last_repeated)
+			result += "*";
+	}
+	
+	return result;
+}
+
 void AX25Frame::make_extended_field(char * const data, size_t length) {
 	size_t i = 0;
 	
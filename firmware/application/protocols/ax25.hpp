@@ -24,6 +24,7 @@
 
 #include <cstring>
 #include <string>
+#include <array>
 
 #ifndef __AX25_H__
 #define __AX25_H__
@@ -41,6 +42,72 @@ enum protocol_id_t {
 	NO_LAYER3 = 0xF0
 };
 
+struct Address {
+	std::string callsign { };
+	uint8_t ssid { 0 };
+	bool repeated { false };		// H bit, for digipeaters
+
+	std::string to_string() const;
+};
+
+/* A received frame, flags and FCS already removed (see AX25PacketMessage). */
+class Packet {
+public:
+	static constexpr size_t digipeaters_max = 8;
+
+	Packet(const uint8_t* const data, const size_t length);
+
+	bool is_valid() const {
+		return valid;
+	}
+
+	const Address& destination() const {
+		return destination_;
+	}
+
+	const Address& source() const {
+		return source_;
+	}
+
+	size_t digipeater_count() const {
+		return digipeater_count_;
+	}
+
+	const Address& digipeater(const size_t index) const {
+		return digipeaters_[index];
+	}
+
+	uint8_t control() const {
+		return control_;
+	}
+
+	uint8_t protocol() const {
+		return protocol_;
+	}
+
+	// UI frame without layer 3: APRS and most beacons
+	bool is_ui() const {
+		return ((control_ & 0xEF) == 0x03) && (protocol_ == NO_LAYER3);
+	}
+
+	const std::string& info() const {
+		return info_;
+	}
+
+	// "SRC>DEST,DIGI*,DIGI" as used by TNC2 monitors and APRS-IS
+	std::string path_string() const;
+
+private:
+	Address destination_ { };
+	Address source_ { };
+	std::array<Address, digipeaters_max> digipeaters_ { };
+	size_t digipeater_count_ { 0 };
+	uint8_t control_ { 0 };
+	uint8_t protocol_ { 0 };
+	std::string info_ { };
+	bool valid { false };
+};
+
 class AX25Frame {
 public:
 	void make_ui_frame(char * const address, const uint8_t control, const uint8_t protocol,
@@ -61,7 +128,7 @@ private:
 	size_t bit_counter { 0 };
 	uint8_t ones_counter { 0 };
 	
-	CRC<16, true, true> crc_ccitt { 0x1021, 0xFFFF, 0xFFFF };
+	TableCRC<16, 0x1021, true, true> crc_ccitt { 0xFFFF, 0xFFFF };
 };
 
 } /* namespace ax25 */
@@ -27,14 +27,294 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <array>
 #include <list>
+#include <new>
+#include <string>
+#include <type_traits>
 #include <utility>
 #include <functional>
 #include <iterator>
 #include <algorithm>
 
-template<class Entry>
-using RecentEntries = std::list<Entry>;
+/* Inline, fixed capacity string for entry fields, so updating an entry on
+ * every packet doesn't go through the heap. Longer values are truncated.
+ */
+template<size_t N>
+class RecentEntryString {
+	static_assert(N < 256, "RecentEntryString length must fit in a byte");
+
+public:
+	RecentEntryString() = default;
+
+	RecentEntryString(const char* const s) {
+		assign(s, strlen(s));
+	}
+
+	RecentEntryString& operator=(const std::string& s) {
+		assign(s.data(), s.size());
+		return *this;
+	}
+
+	bool empty() const { return length == 0; }
+	size_t size() const { return length; }
+	const char* c_str() const { return data_.data(); }
+
+	std::string str() const { return { data_.data(), length }; }
+	operator std::string() const { return str(); }
+
+private:
+	std::array<char, N + 1> data_ { };
+	uint8_t length { 0 };
+
+	void assign(const char* const s, const size_t n) {
+		length = std::min(n, N);
+		memcpy(data_.data(), s, length);
+		data_[length] = 0;
+	}
+};
+
+/* Hashes for the entry keys. Key types that aren't integers or pairs provide
+ * their own overload, found by argument-dependent lookup.
+ */
+template<typename Key>
+constexpr typename std::enable_if<std::is_integral<Key>::value || std::is_enum<Key>::value, uint32_t>::type
+recent_entries_hash(const Key key) {
+	return static_cast<uint32_t>(static_cast<uint64_t>(key) ^ (static_cast<uint64_t>(key) >> 32));
+}
+
+template<typename First, typename Second>
+uint32_t recent_entries_hash(const std::pair<First, Second>& key) {
+	return recent_entries_hash(key.first) * 31 + recent_entries_hash(key.second);
+}
+
+/* Most recently seen first, at most N entries; the least recently seen entry
+ * is recycled when a new key arrives and the pool is full.
+ *
+ * Entries live in a fixed pool and are chained in a doubly linked list by
+ * slot number. An open addressing table (linear probing, twice the pool
+ * size) maps keys to slots, so a packet finds its entry without walking the
+ * list or allocating.
+ */
+template<class Entry, size_t N = 64>
+class RecentEntriesPool {
+	using Slot = uint8_t;
+	static constexpr Slot none = 0xff;
+	static_assert(N < none, "RecentEntriesPool too large for slot numbers");
+
+	static constexpr size_t index_size_for(const size_t n) {
+		return (n >= 2 * N) ? n : index_size_for(n * 2);
+	}
+	static constexpr size_t index_size = index_size_for(1);
+	static constexpr size_t index_mask = index_size - 1;
+
+public:
+	using value_type = Entry;
+	using reference = Entry&;
+	using const_reference = const Entry&;
+	using size_type = size_t;
+	using Key = typename Entry::Key;
+
+	template<typename Pool, typename Value>
+	class Iterator {
+	public:
+		using iterator_category = std::bidirectional_iterator_tag;
+		using value_type = Entry;
+		using difference_type = ptrdiff_t;
+		using pointer = Value*;
+		using reference = Value&;
+
+		Iterator(Pool* const pool, const Slot slot) : pool { pool }, slot { slot } { }
+
+		// Lets a const_iterator be made from an iterator
+		template<typename OtherPool, typename OtherValue>
+		Iterator(const Iterator<OtherPool, OtherValue>& other) : pool { other.pool }, slot { other.slot } { }
+
+		reference operator*() const { return pool->entry(slot); }
+		pointer operator->() const { return &pool->entry(slot); }
+
+		Iterator& operator++() {
+			slot = pool->next[slot];
+			return *this;
+		}
+
+		Iterator& operator--() {
+			slot = (slot == none) ? pool->tail : pool->prev[slot];
+			return *this;
+		}
+
+		Iterator operator++(int) { auto result = *this; ++*this; return result; }
+		Iterator operator--(int) { auto result = *this; --*this; return result; }
+
+		bool operator==(const Iterator& other) const { return slot == other.slot; }
+		bool operator!=(const Iterator& other) const { return slot != other.slot; }
+
+	private:
+		template<typename, typename> friend class Iterator;
+
+		Pool* pool;
+		Slot slot;
+	};
+
+	using iterator = Iterator<RecentEntriesPool, Entry>;
+	using const_iterator = Iterator<const RecentEntriesPool, const Entry>;
+
+	RecentEntriesPool() {
+		index.fill(none);
+		for(size_t i=0; i<N; i++) {
+			next[i] = (i + 1 < N) ? i + 1 : none;
+		}
+	}
+
+	~RecentEntriesPool() {
+		clear();
+	}
+
+	RecentEntriesPool(const RecentEntriesPool&) = delete;
+	RecentEntriesPool& operator=(const RecentEntriesPool&) = delete;
+
+	iterator begin() { return { this, head }; }
+	iterator end() { return { this, none }; }
+	const_iterator begin() const { return { this, head }; }
+	const_iterator end() const { return { this, none }; }
+
+	bool empty() const { return count == 0; }
+	size_t size() const { return count; }
+	static constexpr size_t max_size() { return N; }
+
+	Entry& front() { return entry(head); }
+	const Entry& front() const { return entry(head); }
+	Entry& back() { return entry(tail); }
+	const Entry& back() const { return entry(tail); }
+
+	const_iterator find(const Key& key) const {
+		const auto position = index_find(key);
+		return { this, (position == index_size) ? none : index[position] };
+	}
+
+	/* Returns the entry for key, moved to the front, creating it if needed. */
+	Entry& on_packet(const Key& key) {
+		const auto position = index_find(key);
+		if( position != index_size ) {
+			const auto slot = index[position];
+			unlink(slot);
+			link_front(slot);
+			return entry(slot);
+		}
+
+		if( count == N ) {
+			release(tail);
+		}
+
+		const auto slot = free_head;
+		free_head = next[slot];
+		new (&storage[slot]) Entry(key);
+		count++;
+		link_front(slot);
+		index_insert(slot);
+		return entry(slot);
+	}
+
+	void clear() {
+		while( count ) {
+			release(tail);
+		}
+	}
+
+private:
+	using Storage = typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type;
+
+	std::array<Storage, N> storage { };
+	std::array<Slot, N> prev { };
+	std::array<Slot, N> next { };
+	std::array<Slot, index_size> index { };
+	Slot head { none };
+	Slot tail { none };
+	Slot free_head { 0 };
+	size_t count { 0 };
+
+	Entry& entry(const Slot slot) {
+		return *reinterpret_cast<Entry*>(&storage[slot]);
+	}
+
+	const Entry& entry(const Slot slot) const {
+		return *reinterpret_cast<const Entry*>(&storage[slot]);
+	}
+
+	static size_t home(const Key& key) {
+		// Fibonacci hashing spreads sequential IDs over the table
+		return (recent_entries_hash(key) * 0x9E3779B1U) & index_mask;
+	}
+
+	/* Position of key in the index, or index_size if absent. */
+	size_t index_find(const Key& key) const {
+		for(size_t i=home(key); index[i] != none; i=(i + 1) & index_mask) {
+			if( entry(index[i]).key() == key ) {
+				return i;
+			}
+		}
+		return index_size;
+	}
+
+	void index_insert(const Slot slot) {
+		size_t i = home(entry(slot).key());
+		while( index[i] != none ) {
+			i = (i + 1) & index_mask;
+		}
+		index[i] = slot;
+	}
+
+	void index_erase(size_t i) {
+		// Shift later members of the probe run back so lookups never stop short
+		index[i] = none;
+		for(size_t j=(i + 1) & index_mask; index[j] != none; j=(j + 1) & index_mask) {
+			const size_t k = home(entry(index[j]).key());
+			const bool movable = (i <= j) ? ((k <= i) || (k > j)) : ((k <= i) && (k > j));
+			if( movable ) {
+				index[i] = index[j];
+				index[j] = none;
+				i = j;
+			}
+		}
+	}
+
+	void link_front(const Slot slot) {
+		prev[slot] = none;
+		next[slot] = head;
+		if( head != none ) {
+			prev[head] = slot;
+		} else {
+			tail = slot;
+		}
+		head = slot;
+	}
+
+	void unlink(const Slot slot) {
+		if( prev[slot] != none ) {
+			next[prev[slot]] = next[slot];
+		} else {
+			head = next[slot];
+		}
+		if( next[slot] != none ) {
+			prev[next[slot]] = prev[slot];
+		} else {
+			tail = prev[slot];
+		}
+	}
+
+	void release(const Slot slot) {
+		index_erase(index_find(entry(slot).key()));
+		unlink(slot);
+		entry(slot).~Entry();
+		count--;
+		next[slot] = free_head;
+		free_head = slot;
+	}
+};
+
+template<class Entry, size_t N = 64>
+using RecentEntries = RecentEntriesPool<Entry, N>;
 
 template<typename ContainerType, typename Key>
 typename ContainerType::const_iterator find(const ContainerType& entries, const Key key) {
@@ -44,6 +324,11 @@ typename ContainerType::const_iterator find(const ContainerType& entries, const
 	);
 }
 
+template<class Entry, size_t N, typename Key>
+typename RecentEntriesPool<Entry, N>::const_iterator find(const RecentEntriesPool<Entry, N>& entries, const Key key) {
+	return entries.find(key);
+}
+
 template<typename ContainerType>
 static void truncate_entries(ContainerType& entries, const size_t entries_max = 64) {
 	while(entries.size() > entries_max) {
@@ -66,6 +351,11 @@ typename ContainerType::reference on_packet(ContainerType& entries, const Key ke
 	return entries.front();
 }
 
+template<class Entry, size_t N, typename Key>
+Entry& on_packet(RecentEntriesPool<Entry, N>& entries, const Key key) {
+	return entries.on_packet(key);
+}
+
 template<typename ContainerType>
 static std::pair<typename ContainerType::const_iterator, typename ContainerType::const_iterator> range_around(
 	const ContainerType& entries,
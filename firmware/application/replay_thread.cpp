@@ -41,9 +41,10 @@ ReplayThread::ReplayThread(
 	std::unique_ptr<stream::Reader> reader,
 	size_t read_size,
 	size_t buffer_count,
+	size_t interpolation,
 	bool* ready_signal,
 	std::function<void(uint32_t return_code)> terminate_callback
-) : config { read_size, buffer_count },
+) : config { read_size, buffer_count, interpolation },
 	reader { std::move(reader) },
 	ready_sig { ready_signal },
 	terminate_callback { std::move(terminate_callback) }
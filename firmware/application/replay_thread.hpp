@@ -40,6 +40,7 @@ public:
 		std::unique_ptr<stream::Reader> reader,
 		size_t read_size,
 		size_t buffer_count,
+		size_t interpolation,
 		bool* ready_signal,
 		std::function<void(uint32_t return_code)> terminate_callback
 	);
@@ -23,6 +23,8 @@
 #include "string_format.hpp"
 #include "tone_key.hpp"
 
+#include <cmath>
+
 namespace tonekey {
 
 const tone_key_t tone_keys = {
@@ -84,6 +86,17 @@ const tone_key_t tone_keys = {
 	{ "Shure 19kHz", 19000.0 }
 };
 
+const std::array<uint16_t, 104> dcs_codes = { {
+	0023, 0025, 0026, 0031, 0032, 0036, 0043, 0047, 0051, 0053, 0054, 0065, 0071,
+	0072, 0073, 0074, 0114, 0115, 0116, 0122, 0125, 0131, 0132, 0134, 0143, 0145,
+	0152, 0155, 0156, 0162, 0165, 0172, 0174, 0205, 0212, 0223, 0225, 0226, 0243,
+	0244, 0245, 0246, 0251, 0252, 0255, 0261, 0263, 0265, 0266, 0271, 0274, 0306,
+	0311, 0315, 0325, 0331, 0332, 0343, 0346, 0351, 0356, 0364, 0365, 0371, 0411,
+	0412, 0413, 0423, 0431, 0432, 0445, 0446, 0452, 0454, 0455, 0462, 0464, 0465,
+	0466, 0503, 0506, 0516, 0523, 0526, 0532, 0546, 0565, 0606, 0612, 0624, 0627,
+	0631, 0632, 0654, 0662, 0664, 0703, 0712, 0723, 0731, 0732, 0734, 0743, 0754
+} };
+
 void tone_keys_populate(OptionsField& field) {
 	using option_t = std::pair<std::string, int32_t>;
 	using options_t = std::vector<option_t>;
@@ -108,4 +121,42 @@ float tone_key_frequency(const uint32_t index) {
 	return tone_keys[index].second;
 }
 
+// CTCSS entry nearest to a frequency in 1/100 Hz, 0 ("None") if none is within 1Hz
+size_t tone_key_index_by_value(const uint32_t value) {
+	size_t index = 0;
+	float min_diff = 1.0;
+
+	for (size_t c = 1; c < 51; c++) {
+		const float diff = std::abs(value / 100.0f - tone_keys[c].second);
+		if (diff < min_diff) {
+			index = c;
+			min_diff = diff;
+		}
+	}
+
+	return index;
+}
+
+// Codes are named by their three octal digits
+std::string dcs_code_string(const uint32_t code) {
+	return to_string_dec_uint((code >> 6) & 7) +
+		to_string_dec_uint((code >> 3) & 7) +
+		to_string_dec_uint(code & 7);
+}
+
+std::string coded_squelch_string(const CodedSquelchMessage& message) {
+	switch (message.type) {
+	case CodedSquelchMessage::Type::CTCSS:
+		return "CTCSS " + tone_keys[tone_key_index_by_value(message.value)].first;
+
+	case CodedSquelchMessage::Type::DCS:
+	case CodedSquelchMessage::Type::DCSInverted:
+		return "DCS " + dcs_code_string(message.value) +
+			((message.type == CodedSquelchMessage::Type::DCSInverted) ? "I" : "N");
+
+	default:
+		return "";
+	}
+}
+
 }
@@ -25,6 +25,9 @@
 
 #include "ui.hpp"
 #include "ui_widget.hpp"
+#include "message.hpp"
+
+#include <array>
 
 using namespace ui;
 
@@ -33,9 +36,14 @@ namespace tonekey {
 using tone_key_t = std::vector<std::pair<std::string, float>>;
 
 extern const tone_key_t tone_keys;
+// Standard DCS codes, octal
+extern const std::array<uint16_t, 104> dcs_codes;
 
 void tone_keys_populate(OptionsField& field);
 float tone_key_frequency(const uint32_t index);
+size_t tone_key_index_by_value(const uint32_t value);
+std::string dcs_code_string(const uint32_t code);
+std::string coded_squelch_string(const CodedSquelchMessage& message);
 
 }
 
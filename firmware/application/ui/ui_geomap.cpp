@@ -25,6 +25,7 @@
 #include "portapack.hpp"
 
 #include <cstring>
+#include <algorithm>
 #include <stdio.h>
 
 using namespace portapack;
@@ -139,6 +140,58 @@ int32_t GeoPos::altitude() {
 	return field_altitude.value();
 };
 
+const uint16_t* MapTileCache::find(const uint32_t index) {
+	for (size_t i = 0; i < entry_count; i++) {
+		if (entries[i].index == index) {
+			entries[i].last_used = ++clock;
+			return &pool[entries[i].offset];
+		}
+	}
+	return nullptr;
+}
+
+uint16_t* MapTileCache::insert(const uint32_t index, const size_t words) {
+	if (words > pool_words)
+		return nullptr;
+	
+	while ((entry_count == entries_max) || (used_words + words > pool_words))
+		evict_lru();
+	
+	auto& entry = entries[entry_count++];
+	entry.index = index;
+	entry.last_used = ++clock;
+	entry.offset = used_words;
+	entry.words = words;
+	used_words += words;
+	
+	return &pool[entry.offset];
+}
+
+void MapTileCache::clear() {
+	entry_count = 0;
+	used_words = 0;
+}
+
+void MapTileCache::evict_lru() {
+	size_t lru = 0;
+	for (size_t i = 1; i < entry_count; i++) {
+		if (entries[i].last_used < entries[lru].last_used)
+			lru = i;
+	}
+	
+	// Close the gap so free space stays in one piece
+	const auto gap_offset = entries[lru].offset;
+	const auto gap_words = entries[lru].words;
+	std::copy(&pool[gap_offset + gap_words], &pool[used_words], &pool[gap_offset]);
+	used_words -= gap_words;
+	
+	for (size_t i = lru + 1; i < entry_count; i++) {
+		entries[i - 1] = entries[i];
+		entries[i - 1].offset -= gap_words;
+	}
+	entry_count--;
+}
+
 GeoMap::GeoMap(
 	Rect parent_rect
 ) : Widget { parent_rect }
@@ -146,30 +199,194 @@ GeoMap::GeoMap(
 	//set_focusable(true);
 }
 
+Rect GeoMap::marker_rect(const Point p) const {
+	return { p - Point(17, 17), { 35, 35 } };
+}
+
+Rect GeoMap::tag_rect(const Point p) const {
+	return { p + Point(-((int)tag_.length() * 8 / 2), -32), { (int)tag_.length() * 8, 16 } };
+}
+
+Rect GeoMap::cross_rect() const {
+	return { Point(size().width() / 2, size().height() / 2) - Point(16, 16), { 32, 32 } };
+}
+
+void GeoMap::scroll_map(const Point delta) {
+	// Screen content moves by -delta. Rows are copied in an order that never
+	// reads a row already overwritten.
+	std::array<ui::ColorRGB888, 240> rgb;
+	std::array<ui::Color, 240> line;
+	const auto r = screen_rect();
+	const Dim width = r.width() - std::abs(delta.x());
+	const Dim height = r.height() - std::abs(delta.y());
+	const Coord src_x = r.left() + std::max<Coord>(delta.x(), 0);
+	const Coord dst_x = r.left() + std::max<Coord>(-delta.x(), 0);
+	const Coord src_y = r.top() + std::max<Coord>(delta.y(), 0);
+	const Coord dst_y = r.top() + std::max<Coord>(-delta.y(), 0);
+	
+	for (Coord i = 0; i < height; i++) {
+		const Coord y = (delta.y() >= 0) ? i : (height - 1 - i);
+		display.read_pixels({ src_x, src_y + y, width, 1 }, rgb.data(), width);
+		for (Coord x = 0; x < width; x++)
+			line[x] = { rgb[x].r, rgb[x].g, rgb[x].b };
+		display.start_pixels({ dst_x, dst_y + y, width, 1 });
+		display.stream_pixels(line.data(), width);
+	}
+	
+	// Exposed strips, in widget coordinates
+	if (delta.x() > 0)
+		draw_map({ width, 0, delta.x(), r.height() });
+	else if (delta.x() < 0)
+		draw_map({ 0, 0, -delta.x(), r.height() });
+	if (delta.y() > 0)
+		draw_map({ 0, height, r.width(), delta.y() });
+	else if (delta.y() < 0)
+		draw_map({ 0, 0, r.width(), -delta.y() });
+}
+
 void GeoMap::paint(Painter& painter) {
-	Coord line;
-	std::array<ui::Color, 240> map_line_buffer;
 	const auto r = screen_rect();
 	
 	// Ony redraw map if it moved by at least 1 pixel
 	if ((x_pos != prev_x_pos) || (y_pos != prev_y_pos)) {
-		for (line = 0; line < r.height(); line++) {
-			map_file.seek(4 + ((x_pos + (map_width * (y_pos + line))) << 1));
-			map_file.read(map_line_buffer.data(), r.width() << 1);
-			display.draw_pixels({ 0, r.top() + line, r.width(), 1 }, map_line_buffer);
+		const Point delta { x_pos - prev_x_pos, y_pos - prev_y_pos };
+		if ((prev_x_pos != 0xFFFF) && (std::abs(delta.x()) < r.width()) && (std::abs(delta.y()) < r.height())) {
+			// Small pan: move what is on screen, draw only the exposed strips
+			scroll_map(delta);
+			if (mode_ == PROMPT) {
+				draw_map(cross_rect() + (-delta));
+			} else {
+				draw_map(marker_rect(prev_marker) + (-delta));
+				draw_map(tag_rect(prev_marker) + (-delta));
+			}
+		} else {
+			draw_map({ { 0, 0 }, r.size() });
 		}
 		
 		prev_x_pos = x_pos;
 		prev_y_pos = y_pos;
+	} else if ((mode_ == DISPLAY) && ((marker.x() != prev_marker.x()) || (marker.y() != prev_marker.y()))) {
+		// Map didn't move, only put back what the marker covered
+		draw_map(marker_rect(prev_marker));
+		draw_map(tag_rect(prev_marker));
 	}
+	prev_marker = marker;
 	
 	if (mode_ == PROMPT) {
 		// Cross
 		display.fill_rectangle({ r.center() - Point(16, 1), { 32, 2 } }, Color::red());
 		display.fill_rectangle({ r.center() - Point(1, 16), { 2, 32 } }, Color::red());
 	} else {
-		draw_bearing({ 120, 32 + 144 }, angle_, 16, Color::red());
-		painter.draw_string({ 120 - ((int)tag_.length() * 8 / 2), 32 + 144 - 32 }, style(), tag_);
+		const auto origin = r.location() + marker;
+		draw_bearing(origin, angle_, 16, Color::red());
+		painter.draw_string(origin + Point(-((int)tag_.length() * 8 / 2), -32), style(), tag_);
+	}
+}
+
+void GeoMap::draw_map(const Rect area) {
+	const auto clipped = area.intersect({ { 0, 0 }, screen_rect().size() });
+	if (clipped.is_empty())
+		return;
+	
+	if (tiled) {
+		draw_map_tiled(clipped);
+		return;
+	}
+	
+	std::array<ui::Color, 240> map_line_buffer;
+	const auto r = screen_rect();
+	
+	for (Coord line = clipped.top(); line < clipped.bottom(); line++) {
+		map_file.seek(4 + ((x_pos + clipped.left() + (map_width * (y_pos + line))) << 1));
+		map_file.read(map_line_buffer.data(), clipped.width() << 1);
+		display.start_pixels({ r.left() + clipped.left(), r.top() + line, clipped.width(), 1 });
+		display.stream_pixels(map_line_buffer.data(), clipped.width());
+	}
+}
+
+void GeoMap::draw_map_tiled(const Rect area) {
+	const auto r = screen_rect();
+	const Coord map_x0 = x_pos + area.left();
+	const Coord map_y0 = y_pos + area.top();
+	const Coord map_x1 = map_x0 + area.width();
+	const Coord map_y1 = map_y0 + area.height();
+	
+	for (Coord ty = map_y0 / tile_size; ty * tile_size < map_y1; ty++) {
+		for (Coord tx = map_x0 / tile_size; tx * tile_size < map_x1; tx++) {
+			// Part of the tile inside the area, in map pixels
+			const Coord x0 = std::max<Coord>(tx * tile_size, map_x0);
+			const Coord y0 = std::max<Coord>(ty * tile_size, map_y0);
+			const Coord x1 = std::min<Coord>((tx + 1) * tile_size, map_x1);
+			const Coord y1 = std::min<Coord>((ty + 1) * tile_size, map_y1);
+			const Point dst { r.left() + x0 - x_pos, r.top() + y0 - y_pos };
+			
+			const auto data = ((tx < tiles_x) && (ty < tiles_y)) ? load_tile(ty * tiles_x + tx) : nullptr;
+			if (data)
+				draw_tile(data, { x0 - tx * tile_size, y0 - ty * tile_size, x1 - x0, y1 - y0 }, dst);
+			else
+				display.fill_rectangle({ dst, { x1 - x0, y1 - y0 } }, Color::black());
+		}
+	}
+}
+
+const uint16_t* GeoMap::load_tile(const uint32_t index) {
+	auto data = tile_cache.find(index);
+	if (data)
+		return data;
+	
+	uint32_t offsets[2];
+	map_file.seek(tiles_header_size + index * 4);
+	const auto read_offsets = map_file.read(offsets, sizeof(offsets));
+	if (read_offsets.is_error() || (read_offsets.value() != sizeof(offsets)))
+		return nullptr;
+	
+	const size_t words = (offsets[1] - offsets[0]) / 2;
+	if ((offsets[1] < offsets[0]) || (words > tile_words_max))
+		return nullptr;
+	
+	auto tile = tile_cache.insert(index, words);
+	map_file.seek(offsets[0]);
+	const auto read_tile = map_file.read(tile, words * 2);
+	if (read_tile.is_error() || (read_tile.value() != words * 2)) {
+		tile_cache.clear();
+		return nullptr;
+	}
+	
+	return tile;
+}
+
+void GeoMap::draw_tile(const uint16_t* data, const Rect src, const Point dst) {
+	// Walks the run-length data, skipping what is outside src
+	size_t count = 0;
+	bool repeat = false;
+	
+	const auto advance = [&data, &count, &repeat](size_t n, const bool draw) {
+		while (n) {
+			if (!count) {
+				repeat = *data & 0x8000;
+				count = *data & 0x7FFF;
+				data++;
+				if (!count) return;		// Corrupt tile
+			}
+			const size_t k = std::min(n, count);
+			if (repeat) {
+				if (draw) display.stream_pixels(Color(*data), k);
+				if (k == count) data++;
+			} else {
+				if (draw) display.stream_pixels(reinterpret_cast<const Color*>(data), k);
+				data += k;
+			}
+			count -= k;
+			n -= k;
+		}
+	};
+	
+	display.start_pixels({ dst, src.size() });
+	advance(src.top() * tile_size + src.left(), false);
+	for (Coord y = 0; y < src.height(); y++) {
+		advance(src.width(), true);
+		if (y + 1 < src.height())
+			advance(tile_size - src.width(), false);
 	}
 }
 
@@ -192,23 +409,63 @@ void GeoMap::move(const float lon, const float lat) {
 	Rect map_rect = screen_rect();
 	
 	// Map is in Equidistant "Plate Carrée" projection
-	x_pos = map_center_x - (map_rect.width() / 2) + (lon_ / lon_ratio);
-	y_pos = map_center_y - (map_rect.height() / 2) + (lat_ / lat_ratio) + 16;
+	const int32_t target_x = map_center_x + (lon_ / lon_ratio);
+	const int32_t target_y = map_center_y + (lat_ / lat_ratio) + 16;
+	
+	// Tracking: keep the map still while the marker stays well inside the view
+	if ((mode_ == DISPLAY) && (prev_x_pos != 0xFFFF)) {
+		const Point p { target_x - x_pos, target_y - y_pos };
+		if ((p.x() >= recenter_margin) && (p.x() < map_rect.width() - recenter_margin) &&
+			(p.y() >= recenter_margin) && (p.y() < map_rect.height() - recenter_margin)) {
+			marker = p;
+			return;
+		}
+	}
+	
+	x_pos = target_x - (map_rect.width() / 2);
+	y_pos = target_y - (map_rect.height() / 2);
 	
 	// Cap position
 	if (x_pos > (map_width - map_rect.width()))
 		x_pos = map_width - map_rect.width();
-	if (y_pos > (map_height + map_rect.height()))
+	if (y_pos > (map_height - map_rect.height()))
 		y_pos = map_height - map_rect.height();
+	if (x_pos < 0)
+		x_pos = 0;
+	if (y_pos < 0)
+		y_pos = 0;
+	
+	marker = { target_x - x_pos, target_y - y_pos };
 }
 
 bool GeoMap::init() {
-	auto result = map_file.open("ADSB/world_map.bin");
-	if (result.is_valid())
-		return false;
+	tiled = false;
+	if (!map_file.open("ADSB/world_map.tiles").is_valid()) {
+		char magic[4];
+		uint16_t header[6];
+		map_file.read(magic, sizeof(magic));
+		map_file.read(header, sizeof(header));
+		if ((memcmp(magic, "PPTM", 4) == 0) && (header[0] == 1) && (header[1] == 32)) {
+			tiled = true;
+			tile_size = header[1];
+			map_width = header[2];
+			map_height = header[3];
+			tiles_x = header[4];
+			tiles_y = header[5];
+			
+			// Tile reads jump all over a large file
+			map_file.map_clusters(map_link_map.data(), map_link_map.size());
+		}
+	}
 	
-	map_file.read(&map_width, 2);
-	map_file.read(&map_height, 2);
+	// No usable tiled map, the plain one will do
+	if (!tiled) {
+		if (map_file.open("ADSB/world_map.bin").is_valid())
+			return false;
+		
+		map_file.read(&map_width, 2);
+		map_file.read(&map_height, 2);
+	}
 	
 	map_center_x = map_width >> 1;
 	map_center_y = map_height >> 1;
@@ -243,7 +500,7 @@ void GeoMapView::focus() {
 	geopos.focus();
 	
 	if (!map_opened)
-		nav_.display_modal("No map", "No world_map.bin file in\n/ADSB/ directory", ABORT, nullptr);
+		nav_.display_modal("No map", "No world_map.tiles or\nworld_map.bin file in\n/ADSB/ directory", ABORT, nullptr);
 }
 
 void GeoMapView::update_position(float lat, float lon) {
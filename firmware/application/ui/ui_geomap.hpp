@@ -112,6 +112,37 @@ private:
 	};
 };
 
+/* Compressed map tiles kept in RAM, least recently used dropped first.
+ * Tiles are packed at the front of the pool.
+ */
+class MapTileCache {
+public:
+	static constexpr size_t pool_words = 4096;
+
+	const uint16_t* find(const uint32_t index);
+	/* Space for a tile of `words`, evicting as needed. */
+	uint16_t* insert(const uint32_t index, const size_t words);
+	void clear();
+
+private:
+	static constexpr size_t entries_max = 64;
+
+	struct Entry {
+		uint32_t index;
+		uint32_t last_used;
+		uint16_t offset;
+		uint16_t words;
+	};
+
+	std::array<uint16_t, pool_words> pool { };
+	std::array<Entry, entries_max> entries { };
+	size_t entry_count { 0 };
+	size_t used_words { 0 };
+	uint32_t clock { 0 };
+
+	void evict_lru();
+};
+
 class GeoMap : public Widget {
 public:
 	std::function<void(float, float)> on_move { };
@@ -130,15 +161,34 @@ public:
 	}
 
 private:
+	// Tiled map: see tools/adsb_map_tiles.py
+	static constexpr size_t tiles_header_size = 16;
+	static constexpr size_t tile_words_max = 32 * 32 + 1;
+	// The marker moves over a still map until it gets this close to an edge
+	static constexpr Dim recenter_margin = 40;
+	
 	void draw_bearing(const Point origin, const uint32_t angle, uint32_t size, const Color color);
+	void draw_map(const Rect area);
+	void scroll_map(const Point delta);
+	void draw_map_tiled(const Rect area);
+	void draw_tile(const uint16_t* data, const Rect src, const Point dst);
+	const uint16_t* load_tile(const uint32_t index);
+	Rect marker_rect(const Point p) const;
+	Rect tag_rect(const Point p) const;
+	Rect cross_rect() const;
 	
 	GeoMapMode mode_ { };
 	File map_file { };
+	bool tiled { false };
+	std::array<DWORD, 32> map_link_map { };
+	uint16_t tile_size { }, tiles_x { }, tiles_y { };
+	MapTileCache tile_cache { };
 	uint16_t map_width { }, map_height { };
 	int32_t map_center_x { }, map_center_y { };
 	float lon_ratio { }, lat_ratio { };
 	int32_t x_pos { }, y_pos { };
 	int32_t prev_x_pos { 0xFFFF }, prev_y_pos { 0xFFFF };
+	Point marker { }, prev_marker { };
 	float lat_ { };
 	float lon_ { };
 	float angle_ { };
@@ -24,6 +24,7 @@
 #include "spectrum_color_lut.hpp"
 
 #include "portapack.hpp"
+#include "portapack_persistent_memory.hpp"
 using namespace portapack;
 
 #include "baseband_api.hpp"
@@ -338,7 +339,11 @@ WaterfallWidget::WaterfallWidget(const bool cursor) {
 }
 
 void WaterfallWidget::on_show() {
-	baseband::spectrum_streaming_start();
+	baseband::spectrum_streaming_start(
+		static_cast<SpectrumStreamingConfigMessage::Window>(persistent_memory::spectrum_window()),
+		static_cast<SpectrumStreamingConfigMessage::Averaging>(persistent_memory::spectrum_averaging()),
+		persistent_memory::spectrum_averaging_shift()
+	);
 }
 
 void WaterfallWidget::on_hide() {
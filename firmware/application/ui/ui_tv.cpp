@@ -191,6 +191,7 @@ TVWidget::TVWidget(const bool cursor) {
 }
 
 void TVWidget::on_show() {
+	// Each spectrum is a picture line, so no averaging across lines
 	baseband::spectrum_streaming_start();
 }
 
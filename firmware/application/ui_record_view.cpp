@@ -71,6 +71,7 @@ RecordView::RecordView(
 		&button_record,
 		&text_record_filename,
 		&text_record_dropped,
+		&text_record_backlog,
 		&text_time_available,
 	});
 	
@@ -107,6 +108,7 @@ void RecordView::set_sampling_rate(const size_t new_sampling_rate) {
 		button_record.hidden(sampling_rate == 0);
 		text_record_filename.hidden(sampling_rate == 0);
 		text_record_dropped.hidden(sampling_rate == 0);
+		text_record_backlog.hidden(sampling_rate == 0);
 		text_time_available.hidden(sampling_rate == 0);
 		rect_background.hidden(sampling_rate != 0);
 
@@ -114,6 +116,22 @@ void RecordView::set_sampling_rate(const size_t new_sampling_rate) {
 	}
 }
 
+void RecordView::set_decimation(const size_t new_decimation) {
+	if( new_decimation != decimation ) {
+		stop();
+		decimation = new_decimation;
+		update_status_display();
+	}
+}
+
+void RecordView::set_file_type(const FileType new_file_type) {
+	if( new_file_type != file_type ) {
+		stop();
+		file_type = new_file_type;
+		update_status_display();
+	}
+}
+
 bool RecordView::is_active() const {
 	return (bool)capture_thread;
 }
@@ -131,6 +149,7 @@ void RecordView::start() {
 
 	text_record_filename.set("");
 	text_record_dropped.set("");
+	text_record_backlog.set("");
 
 	if( sampling_rate == 0 ) {
 		return;
@@ -159,6 +178,7 @@ void RecordView::start() {
 		}
 		break;
 
+	case FileType::RawS8:
 	case FileType::RawS16:
 		{
 			const auto metadata_file_error = write_metadata_file(base_path.replace_extension(u".TXT"));
@@ -168,7 +188,10 @@ void RecordView::start() {
 			}
 
 			auto p = std::make_unique<RawFileWriter>();
-			auto create_error = p->create(base_path.replace_extension(u".C16"));
+			auto create_error = p->create(
+				base_path.replace_extension((file_type == FileType::RawS8) ? u".C8" : u".C16"),
+				preallocate_size()
+			);
 			if( create_error.is_valid() ) {
 				handle_error(create_error.value());
 			} else {
@@ -187,6 +210,7 @@ void RecordView::start() {
 		capture_thread = std::make_unique<CaptureThread>(
 			std::move(writer),
 			write_size, buffer_count,
+			(file_type == FileType::RawS8) ? CaptureConfig::Format::C8 : CaptureConfig::Format::C16,
 			[]() {
 				CaptureThreadDoneMessage message { };
 				EventDispatcher::send_message(message);
@@ -216,7 +240,7 @@ Optional<File::Error> RecordView::write_metadata_file(const std::filesystem::pat
 	if( create_error.is_valid() ) {
 		return create_error;
 	} else {
-		const auto error_line1 = file.write_line("sample_rate=" + to_string_dec_uint(sampling_rate / 8));
+		const auto error_line1 = file.write_line("sample_rate=" + to_string_dec_uint(sampling_rate / decimation));
 		if( error_line1.is_valid() ) {
 			return error_line1;
 		}
@@ -237,6 +261,21 @@ void RecordView::update_status_display() {
 		const auto dropped_percent = std::min(99U, capture_thread->state().dropped_percent());
 		const auto s = to_string_dec_uint(dropped_percent, 2, ' ') + "\%";
 		text_record_dropped.set(s);
+		const auto backlog = std::min<size_t>(99, capture_thread->state().buffers_full_max);
+		text_record_backlog.set(to_string_dec_uint(backlog, 2, ' '));
+	}
+
+	// Once samples have been dropped, alternate the time left with the
+	// number of stalls and the longest one in KiB.
+	const auto stall_count = is_active() ? capture_thread->state().stall_count : 0;
+	show_stalls = stall_count && !show_stalls;
+	if( show_stalls ) {
+		const auto stall_kib = capture_thread->state().stall_bytes_max / 1024;
+		text_time_available.set(
+			"S" + to_string_dec_uint(std::min<uint32_t>(99, stall_count), 2, ' ') +
+			" " + to_string_dec_uint(std::min<uint32_t>(9999, stall_kib), 4, ' ') + "k"
+		);
+		return;
 	}
 	
 	/*if (pitch_rssi_enabled) {
@@ -245,8 +284,7 @@ void RecordView::update_status_display() {
 
 	if( sampling_rate ) {
 		const auto space_info = std::filesystem::space(u"");
-		const uint32_t bytes_per_second = file_type == FileType::WAV ? (sampling_rate * 2) : (sampling_rate / 8 * 4);
-		const uint32_t available_seconds = space_info.free / bytes_per_second;
+		const uint32_t available_seconds = space_info.free / bytes_per_second();
 		const uint32_t seconds = available_seconds % 60;
 		const uint32_t available_minutes = available_seconds / 60;
 		const uint32_t minutes = available_minutes % 60;
@@ -259,6 +297,27 @@ void RecordView::update_status_display() {
 	}
 }
 
+uint32_t RecordView::bytes_per_second() const {
+	if( file_type == FileType::WAV ) {
+		return sampling_rate * 2;
+	}
+
+	// Prefer the rate the baseband reports once a capture is running
+	const uint32_t file_rate = (is_active() && capture_thread->state().sampling_rate) ?
+		capture_thread->state().sampling_rate : (sampling_rate / decimation);
+	return file_rate * ((file_type == FileType::RawS8) ? 2 : 4);
+}
+
+File::Size RecordView::preallocate_size() const {
+	// Leave room for the metadata and other files, and stay below the FAT32 limit
+	const auto space_info = std::filesystem::space(u"");
+	const File::Size size = std::min<File::Size>(
+		static_cast<File::Size>(bytes_per_second()) * preallocate_seconds,
+		space_info.free / 2
+	);
+	return std::min<File::Size>(size, 0xffff0000);
+}
+
 void RecordView::handle_capture_thread_done(const File::Error error) {
 	stop();
 	if( error.code() ) {
@@ -40,6 +40,7 @@ public:
 	std::function<void(std::string)> on_error { };
 
 	enum FileType {
+		RawS8 = 1,
 		RawS16 = 2,
 		WAV = 3,
 	};
@@ -56,6 +57,9 @@ public:
 	void focus() override;
 
 	void set_sampling_rate(const size_t new_sampling_rate);
+	// Raw IQ only: baseband rate / file rate, and C8 or C16 samples
+	void set_decimation(const size_t new_decimation);
+	void set_file_type(const FileType new_file_type);
 
 	void start();
 	void stop();
@@ -69,16 +73,23 @@ private:
 
 	void on_tick_second();
 	void update_status_display();
+	uint32_t bytes_per_second() const;
+	File::Size preallocate_size() const;
 
 	void handle_capture_thread_done(const File::Error error);
 	void handle_error(const File::Error error);
 
 	//bool pitch_rssi_enabled = false;
 	const std::filesystem::path filename_stem_pattern;
-	const FileType file_type;
+	FileType file_type;
 	const size_t write_size;
 	const size_t buffer_count;
 	size_t sampling_rate { 0 };
+	size_t decimation { 8 };
+	bool show_stalls { false };
+
+	// Raw captures reserve this much contiguous space up front
+	static constexpr uint32_t preallocate_seconds = 30;
 	SignalToken signal_token_tick_second { };
 
 	Rectangle rect_background {
@@ -110,6 +121,12 @@ private:
 		"",
 	};
 
+	// Most buffers the SD card has fallen behind by
+	Text text_record_backlog {
+		{ 19 * 8, 0 * 16, 2 * 8, 16 },
+		"",
+	};
+
 	Text text_time_available {
 		{ 21 * 8, 0 * 16, 9 * 8, 16 },
 		"",
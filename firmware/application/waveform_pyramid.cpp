@@ -0,0 +1,334 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "waveform_pyramid.hpp"
+
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+struct Accumulator {
+	int16_t min { INT16_MAX };
+	int16_t max { INT16_MIN };
+	uint64_t square_sum { 0 };
+	uint32_t count { 0 };
+
+	void add(const int16_t sample) {
+		min = std::min(min, sample);
+		max = std::max(max, sample);
+		square_sum += static_cast<int32_t>(sample) * sample;
+		count++;
+	}
+
+	void add(const WaveformPyramid::Entry& entry) {
+		min = std::min(min, entry.min);
+		max = std::max(max, entry.max);
+		square_sum += entry.mean_square;
+		count++;
+	}
+
+	WaveformPyramid::Entry finish() {
+		const WaveformPyramid::Entry entry {
+			count ? min : int16_t(0),
+			count ? max : int16_t(0),
+			count ? static_cast<uint32_t>(square_sum / count) : 0
+		};
+		*this = { };
+		return entry;
+	}
+};
+
+} /* namespace */
+
+/* State of an unfinished build: level l's accumulator builds level l entries,
+ * from samples or level l - 1 entries.
+ */
+struct WaveformPyramid::Build {
+	struct Level {
+		Accumulator accumulator;
+		uint32_t written;
+		size_t queued;
+		std::array<Entry, 32> queue;
+	};
+
+	std::array<Level, levels_max> state { };
+	File out { };
+	std::filesystem::path path { };
+	uint32_t sample_rate { 0 };
+	uint32_t position { 0 };		// Samples consumed
+	bool ok { true };
+};
+
+WaveformPyramid::WaveformPyramid() = default;
+WaveformPyramid::~WaveformPyramid() = default;
+
+bool WaveformPyramid::open(WAVFileReader& reader, const std::filesystem::path& wav_path) {
+	build.reset();
+	file.reset();
+	sample_count_ = reader.sample_count();
+	set_layout(sample_count_);
+
+	auto path = wav_path;
+	path.replace_extension(u".PYR");
+
+	auto pyramid = std::make_unique<File>();
+	bool valid = false;
+	if( !pyramid->open(path).is_valid() ) {
+		Header header { };
+		const auto read = pyramid->read(&header, sizeof(header));
+		valid = !read.is_error() && (read.value() == sizeof(header)) &&
+			(memcmp(header.magic, "PPWV", 4) == 0) &&
+			(header.version == 1) &&
+			(header.levels == levels) &&
+			(header.sample_count == sample_count_) &&
+			(header.sample_rate == reader.sample_rate());
+	}
+
+	if( valid ) {
+		file = std::move(pyramid);
+		return true;
+	}
+
+	pyramid.reset();
+	build_start(reader, path);
+	return false;
+}
+
+void WaveformPyramid::set_layout(const uint32_t sample_count) {
+	uint32_t offset = sizeof(Header);
+	levels = 0;
+	while( levels < levels_max ) {
+		level_offset[levels] = offset;
+		const auto count = entry_count(sample_count, levels);
+		offset += count * sizeof(Entry);
+		levels++;
+		if( count <= 1 ) {
+			break;
+		}
+	}
+}
+
+void WaveformPyramid::build_start(WAVFileReader& reader, const std::filesystem::path& path) {
+	auto new_build = std::make_unique<Build>();
+
+	const auto top = levels - 1;
+	const auto size = level_offset[top] + entry_count(sample_count_, top) * sizeof(Entry);
+
+	// The real header goes in last, so an interrupted build is redone next time
+	const Header blank { };
+	auto& out = new_build->out;
+	if( out.create(path).is_valid() || out.preallocate(size).is_valid() ||
+		out.write(&blank, sizeof(blank)).is_error() ) {
+		return;
+	}
+
+	new_build->path = path;
+	new_build->sample_rate = reader.sample_rate();
+	build = std::move(new_build);
+}
+
+void WaveformPyramid::build_flush(const size_t l) {
+	auto& level = build->state[l];
+	if( !level.queued ) {
+		return;
+	}
+	build->out.seek(level_offset[l] + level.written * sizeof(Entry));
+	build->ok &= !build->out.write(level.queue.data(), level.queued * sizeof(Entry)).is_error();
+	level.written += level.queued;
+	level.queued = 0;
+}
+
+// Stores a finished level l entry and carries it into the level above
+void WaveformPyramid::build_push(size_t l, Entry entry) {
+	while( true ) {
+		auto& level = build->state[l];
+		level.queue[level.queued++] = entry;
+		if( level.queued == level.queue.size() ) {
+			build_flush(l);
+		}
+
+		if( l + 1 == levels ) {
+			break;
+		}
+		auto& above = build->state[l + 1].accumulator;
+		above.add(entry);
+		if( above.count < (1U << step_log2) ) {
+			break;
+		}
+		entry = above.finish();
+		l++;
+	}
+}
+
+bool WaveformPyramid::build_step(WAVFileReader& reader, const uint32_t samples_max) {
+	if( !build ) {
+		return false;
+	}
+
+	std::array<int16_t, 256> samples;
+	auto& accumulator = build->state[0].accumulator;
+	uint32_t budget = samples_max;
+
+	// The reader may have been used in between
+	reader.data_seek(build->position);
+	while( budget && build->ok && (build->position < sample_count_) ) {
+		const size_t count = std::min<size_t>(std::min(sample_count_ - build->position, budget), samples.size());
+		const auto read = reader.read(samples.data(), count * sizeof(int16_t));
+		if( read.is_error() ) {
+			build->ok = false;
+			break;
+		}
+		if( read.value() < sizeof(int16_t) ) {
+			build->position = sample_count_;
+			break;
+		}
+
+		const size_t read_count = read.value() / sizeof(int16_t);
+		for(size_t i=0; i<read_count; i++) {
+			accumulator.add(samples[i]);
+			if( accumulator.count == (1U << base_log2) ) {
+				build_push(0, accumulator.finish());
+			}
+		}
+		build->position += read_count;
+		budget -= std::min<uint32_t>(budget, read_count);
+	}
+
+	if( build->ok && (build->position < sample_count_) ) {
+		return true;
+	}
+
+	build_finish();
+	return false;
+}
+
+void WaveformPyramid::build_finish() {
+	// Partial entries at the end of each level, then whatever is queued
+	for(size_t l=0; l<levels; l++) {
+		auto& accumulator = build->state[l].accumulator;
+		if( accumulator.count ) {
+			build_push(l, accumulator.finish());
+		}
+	}
+	for(size_t l=0; l<levels; l++) {
+		build_flush(l);
+	}
+
+	if( build->ok ) {
+		const Header header { { 'P', 'P', 'W', 'V' }, 1, static_cast<uint16_t>(levels), sample_count_, build->sample_rate };
+		build->out.seek(0);
+		build->ok = !build->out.write(&header, sizeof(header)).is_error();
+	}
+
+	const auto path = build->path;
+	const auto ok = build->ok;
+	build.reset();
+
+	if( ok ) {
+		file = std::make_unique<File>();
+		if( file->open(path).is_valid() ) {
+			file.reset();
+		}
+	}
+}
+
+uint32_t WaveformPyramid::build_progress() const {
+	if( !build || !sample_count_ ) {
+		return 100;
+	}
+	return static_cast<uint64_t>(build->position) * 100 / sample_count_;
+}
+
+void WaveformPyramid::read_columns(
+	WAVFileReader& reader,
+	const uint64_t start,
+	const uint64_t samples_per_column,
+	Entry* const columns,
+	const size_t count
+) {
+	if( !file || (samples_per_column < entry_samples(0)) ) {
+		read_samples(reader, start, samples_per_column, columns, count);
+		return;
+	}
+
+	// Coarsest level that still resolves a column
+	size_t level = 0;
+	while( (level + 1 < levels) && (entry_samples(level + 1) <= samples_per_column) ) {
+		level++;
+	}
+	read_entries(level, start, samples_per_column, columns, count);
+}
+
+void WaveformPyramid::read_samples(WAVFileReader& reader, const uint64_t start, const uint64_t samples_per_column, Entry* const columns, const size_t count) {
+	std::array<int16_t, 128> samples;
+	size_t index = 0;
+	size_t available = 0;
+	uint64_t position = start;
+
+	reader.data_seek(start);
+	for(size_t c=0; c<count; c++) {
+		Accumulator accumulator { };
+		for(uint64_t n=0; (n<samples_per_column) && (position < sample_count_); n++, position++) {
+			if( index == available ) {
+				const auto read = reader.read(samples.data(), sizeof(samples));
+				available = read.is_error() ? 0 : (read.value() / sizeof(int16_t));
+				index = 0;
+				if( !available ) {
+					position = sample_count_;
+					break;
+				}
+			}
+			accumulator.add(samples[index++]);
+		}
+		columns[c] = accumulator.finish();
+	}
+}
+
+void WaveformPyramid::read_entries(const size_t level, const uint64_t start, const uint64_t samples_per_column, Entry* const columns, const size_t count) {
+	std::array<Entry, 32> entries;
+	// Entries [base, base + available) are in the buffer
+	uint32_t base = 0;
+	size_t available = 0;
+
+	const auto total = entry_count(sample_count_, level);
+	const auto shift = base_log2 + level * step_log2;
+
+	for(size_t c=0; c<count; c++) {
+		const uint64_t first_sample = start + c * samples_per_column;
+		const uint64_t last_sample = std::min<uint64_t>(first_sample + samples_per_column, sample_count_) - 1;
+		const uint32_t first = first_sample >> shift;
+		const uint32_t last = (first_sample < sample_count_) ? (last_sample >> shift) + 1 : first;
+
+		Accumulator accumulator { };
+		for(uint32_t i=first; i<last; i++) {
+			if( (i < base) || (i >= base + available) ) {
+				base = i;
+				file->seek(level_offset[level] + base * sizeof(Entry));
+				const auto read = file->read(entries.data(), std::min<size_t>(total - base, entries.size()) * sizeof(Entry));
+				available = read.is_error() ? 0 : (read.value() / sizeof(Entry));
+				if( !available ) {
+					break;
+				}
+			}
+			accumulator.add(entries[i - base]);
+		}
+		columns[c] = accumulator.finish();
+	}
+}
@@ -0,0 +1,133 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __WAVEFORM_PYRAMID_H__
+#define __WAVEFORM_PYRAMID_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+#include "file.hpp"
+#include "io_wave.hpp"
+
+/* Min/max/mean square overview of a 16-bit mono WAV file, at several
+ * resolutions, so any zoom level can be drawn from a single short read.
+ *
+ * Level 0 summarizes 16 samples per entry, each level above summarizes 4
+ * entries of the one below. The levels are built in one streaming pass, in
+ * steps so the UI keeps running, and kept next to the WAV file (same name,
+ * .PYR), all values little-endian:
+ *	char[4]		"PPWV"
+ *	u16			version (1)
+ *	u16			level count
+ *	u32			sample count
+ *	u32			sample rate
+ *	entries		level 0 first, ceil(samples / entry size) per level
+ * and are rebuilt when the sample count or rate don't match.
+ */
+class WaveformPyramid {
+public:
+	struct Entry {
+		int16_t min;
+		int16_t max;
+		uint32_t mean_square;
+	};
+
+	static constexpr size_t base_log2 = 4;
+	static constexpr size_t step_log2 = 2;
+	static constexpr size_t levels_max = 10;
+
+	WaveformPyramid();
+	~WaveformPyramid();
+
+	/* Opens the pyramid for the WAV file reader has open. Returns false if it
+	 * has to be built first: then call build_step() until it returns false.
+	 * Without a pyramid, read_columns() falls back to reading samples.
+	 */
+	bool open(WAVFileReader& reader, const std::filesystem::path& wav_path);
+
+	/* Builds on from up to samples_max more samples. Returns true while there
+	 * are more to go. Dropping the pyramid (or opening another) mid-way
+	 * cancels the build.
+	 */
+	bool build_step(WAVFileReader& reader, const uint32_t samples_max);
+
+	bool is_open() const {
+		return file != nullptr;
+	}
+
+	bool is_building() const {
+		return build != nullptr;
+	}
+
+	/* Percent of the samples consumed by the build. */
+	uint32_t build_progress() const;
+
+	/* Summarizes count columns of samples_per_column samples from start.
+	 * Columns past the end of the file are zero.
+	 */
+	void read_columns(
+		WAVFileReader& reader,
+		const uint64_t start,
+		const uint64_t samples_per_column,
+		Entry* const columns,
+		const size_t count
+	);
+
+	uint32_t sample_count() const {
+		return sample_count_;
+	}
+
+private:
+	struct Header {
+		char magic[4];
+		uint16_t version;
+		uint16_t levels;
+		uint32_t sample_count;
+		uint32_t sample_rate;
+	};
+
+	struct Build;
+
+	std::unique_ptr<File> file { };
+	std::unique_ptr<Build> build { };
+	uint32_t sample_count_ { 0 };
+	size_t levels { 0 };
+	std::array<uint32_t, levels_max> level_offset { };
+
+	static uint64_t entry_samples(const size_t level) {
+		return 1ULL << (base_log2 + level * step_log2);
+	}
+
+	static uint32_t entry_count(const uint32_t sample_count, const size_t level) {
+		return (sample_count + entry_samples(level) - 1) >> (base_log2 + level * step_log2);
+	}
+
+	void set_layout(const uint32_t sample_count);
+	void build_start(WAVFileReader& reader, const std::filesystem::path& path);
+	void build_flush(const size_t l);
+	void build_push(size_t l, Entry entry);
+	void build_finish();
+
+	void read_samples(WAVFileReader& reader, const uint64_t start, const uint64_t samples_per_column, Entry* const columns, const size_t count);
+	void read_entries(const size_t level, const uint64_t start, const uint64_t samples_per_column, Entry* const columns, const size_t count);
+};
+
+#endif/*__WAVEFORM_PYRAMID_H__*/
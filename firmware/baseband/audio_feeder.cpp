@@ -0,0 +1,166 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "audio_feeder.hpp"
+
+#include "dsp_fft.hpp"
+#include "dsp_window.hpp"
+#include "simd.hpp"
+
+#include <utility>
+
+namespace {
+
+constexpr size_t phases = 64;
+constexpr size_t phases_log2 = 6;
+constexpr size_t taps_per_phase = 8;
+constexpr size_t prototype_length = phases * taps_per_phase;
+
+/* Kaiser (beta = 5) windowed sinc at phases * input rate, cutoff 0.4 * input
+ * rate: -1.2dB at 0.3, better than -50dB from 0.6. Q15, each phase sums to
+ * about unity. Index prototype_length is the first tap of the next sample,
+ * so the last phase can be interpolated towards it.
+ */
+constexpr int16_t prototype_tap(const size_t n) {
+	using namespace dsp::window::detail;
+
+	const size_t m = (n > prototype_length / 2) ? (n - prototype_length / 2) : (prototype_length / 2 - n);
+	// sin(2 * pi * 0.4 * m / phases) / (pi * m / phases)
+	const double h = (m == 0) ? 0.8
+		: fft_fixed::sin_turns((2 * m) % (5 * phases), 5 * phases) / (3.14159265358979323846 * m / phases);
+	const double r = (2.0 * n) / prototype_length - 1.0;
+	return fft_fixed::to_q15(h * bessel_i0(5.0 * sqrt_newton(1.0 - r * r)) / bessel_i0(5.0));
+}
+
+/* Pair j of phase p, oldest sample in the low half, to match the window. */
+constexpr uint32_t packed_taps(const size_t i) {
+	const size_t p = i / (taps_per_phase / 2);
+	const size_t k = taps_per_phase - 1 - (i % (taps_per_phase / 2)) * 2;
+	return (static_cast<uint32_t>(prototype_tap(p + k * phases)) & 0xffff)
+		| (static_cast<uint32_t>(prototype_tap(p + (k - 1) * phases)) << 16);
+}
+
+template<size_t... I>
+constexpr std::array<uint32_t, sizeof...(I)> make_taps(std::index_sequence<I...>) {
+	return { { packed_taps(I)... } };
+}
+
+constexpr auto taps = make_taps(std::make_index_sequence<(phases + 1) * taps_per_phase / 2>());
+
+inline int32_t dot(const std::array<uint32_t, taps_per_phase / 2>& window, const uint32_t* const t) {
+	int32_t acc = 0;
+	acc = __SMLAD(window[0], t[0], acc);
+	acc = __SMLAD(window[1], t[1], acc);
+	acc = __SMLAD(window[2], t[2], acc);
+	acc = __SMLAD(window[3], t[3], acc);
+	return acc;
+}
+
+} /* namespace */
+
+void AudioFeeder::configure(
+	const uint32_t input_rate,
+	const uint32_t output_rate,
+	const size_t bits_per_sample
+) {
+	const uint32_t intermediate_rate = output_rate / output_stage_factor;
+	// Input samples per intermediate sample, 0.32 fixed point
+	phase_increment = (input_rate >= intermediate_rate) ? 0xffffffff
+		: static_cast<uint32_t>((static_cast<uint64_t>(input_rate) << 32) / intermediate_rate);
+	bytes_per_sample = (bits_per_sample == 16) ? 2 : 1;
+	reset();
+}
+
+void AudioFeeder::reset() {
+	block_count = 0;
+	block_index = 0;
+	samples_read_ = 0;
+	window.fill(0);
+	phase = 0;
+	last_output = 0;
+	output_stage_index = 0;
+	output_stage_base = 0;
+	output_stage_delta = 0;
+}
+
+int16_t AudioFeeder::next_input(StreamOutput* const stream) {
+	if( block_count - block_index < bytes_per_sample ) {
+		// Keep a split sample's first byte in front of the next block
+		const size_t carry = block_count - block_index;
+		if( carry ) {
+			block[0] = block[block_index];
+		}
+		const size_t read = stream ? stream->read(&block[carry], block_bytes) : 0;
+		block_count = carry + read;
+		block_index = 0;
+
+		if( block_count < bytes_per_sample ) {
+			// Underrun or end of file
+			return 0;
+		}
+	}
+
+	samples_read_++;
+	const uint8_t* const p = &block[block_index];
+	block_index += bytes_per_sample;
+
+	if( bytes_per_sample == 2 ) {
+		return static_cast<int16_t>(p[0] | (p[1] << 8));
+	}
+	return static_cast<int16_t>((p[0] - 0x80) << 8);
+}
+
+int32_t AudioFeeder::next_intermediate(StreamOutput* const stream) {
+	const uint32_t last_phase = phase;
+	phase += phase_increment;
+	if( phase < last_phase ) {
+		// Wrapped, shift in the next file sample
+		const uint32_t sample = static_cast<uint16_t>(next_input(stream));
+		window[0] = (window[0] >> 16) | (window[1] << 16);
+		window[1] = (window[1] >> 16) | (window[2] << 16);
+		window[2] = (window[2] >> 16) | (window[3] << 16);
+		window[3] = (window[3] >> 16) | (sample << 16);
+	}
+
+	const size_t p = phase >> (32 - phases_log2);
+	const uint32_t* const t = &taps[p * (taps_per_phase / 2)];
+	const int32_t y0 = dot(window, t);
+	const int32_t y1 = dot(window, t + taps_per_phase / 2);
+
+	// Linear between neighbouring phases, with 16 bits of the remaining fraction
+	const int32_t fraction = (phase >> (16 - phases_log2)) & 0xffff;
+	const int32_t y = y0 + static_cast<int32_t>(((static_cast<int64_t>(y1) - y0) * fraction) >> 16);
+	return __SSAT(y >> 15, 16);
+}
+
+void AudioFeeder::execute(StreamOutput* const stream, const buffer_s16_t& dst) {
+	for(size_t i=0; i<dst.count; i++) {
+		if( output_stage_index == 0 ) {
+			const int32_t next = next_intermediate(stream);
+			output_stage_base = last_output;
+			output_stage_delta = next - last_output;
+			last_output = next;
+		}
+		output_stage_index = (output_stage_index + 1) & (output_stage_factor - 1);
+
+		// Ramp from the previous intermediate sample to the new one
+		const size_t k = output_stage_index ? output_stage_index : output_stage_factor;
+		dst.p[i] = output_stage_base + (output_stage_delta * static_cast<int32_t>(k)) / static_cast<int32_t>(output_stage_factor);
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __AUDIO_FEEDER_H__
+#define __AUDIO_FEEDER_H__
+
+#include "dsp_types.hpp"
+#include "stream_output.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Mono 8-bit unsigned or 16-bit signed PCM from a StreamOutput, resampled
+ * to the TX rate as S16.
+ *
+ * The stream is read a block at a time. Resampling is done in two stages:
+ * a 64 phase, 8 tap polyphase FIR (linearly interpolated between adjacent
+ * phases) brings the file rate up to output_rate / 8, then a linear
+ * interpolator covers the last x8. Images of the file rate are pushed below
+ * the FIR stopband instead of being repeated by a sample-and-hold.
+ *
+ * When the stream runs dry the output decays to silence.
+ */
+class AudioFeeder {
+public:
+	static constexpr size_t output_stage_factor = 8;
+
+	void configure(
+		const uint32_t input_rate,
+		const uint32_t output_rate,
+		const size_t bits_per_sample
+	);
+
+	void reset();
+
+	/* Fills dst.count samples at the output rate. stream may be null. */
+	void execute(StreamOutput* const stream, const buffer_s16_t& dst);
+
+	/* File samples consumed since the last reset(). */
+	uint32_t samples_read() const {
+		return samples_read_;
+	}
+
+private:
+	static constexpr size_t taps_per_phase = 8;
+	static constexpr size_t block_bytes = 256;
+
+	// Block of raw file data, with room to carry a split 16-bit sample
+	std::array<uint8_t, block_bytes + 1> block { };
+	size_t block_count { 0 };
+	size_t block_index { 0 };
+	size_t bytes_per_sample { 1 };
+	uint32_t samples_read_ { 0 };
+
+	// Newest sample last, pairs packed for SMLAD
+	std::array<uint32_t, taps_per_phase / 2> window { };
+	uint32_t phase { 0 };
+	uint32_t phase_increment { 0 };
+
+	int32_t last_output { 0 };
+	size_t output_stage_index { 0 };
+	int32_t output_stage_base { 0 };
+	int32_t output_stage_delta { 0 };
+
+	int16_t next_input(StreamOutput* const stream);
+	int32_t next_intermediate(StreamOutput* const stream);
+};
+
+#endif/*__AUDIO_FEEDER_H__*/
@@ -34,3 +34,7 @@ void BasebandProcessor::feed_channel_stats(const buffer_c16_t& channel) {
 		}
 	);
 }
+
+void BasebandProcessor::configure_channel_stats(const ChannelStatsConfigMessage& message) {
+	channel_stats.configure(message.epoch, message.update_interval_ms);
+}
@@ -38,6 +38,7 @@ public:
 
 protected:
 	void feed_channel_stats(const buffer_c16_t& channel);
+	void configure_channel_stats(const ChannelStatsConfigMessage& message);
 
 private:
 	ChannelStatsCollector channel_stats { };
@@ -33,8 +33,24 @@
 
 class ChannelStatsCollector {
 public:
+	/* Restart the measurement, e.g. after a retune. The buffer in flight may
+	 * hold samples from before the change, so it is dropped.
+	 */
+	void configure(const uint32_t new_epoch, const uint32_t new_update_interval_ms) {
+		epoch = new_epoch;
+		update_interval_ms = new_update_interval_ms;
+		max_squared = 0;
+		count = 0;
+		skip = true;
+	}
+
 	template<typename Callback>
 	void feed(const buffer_c16_t& src, Callback callback) {
+		if( skip ) {
+			skip = false;
+			return;
+		}
+
 		auto src_p = src.p;
 		while(src_p < &src.p[src.count]) {
 			const uint32_t sample = *__SIMD32(src_p)++;
@@ -45,12 +61,12 @@ public:
 		}
 		count += src.count;
 
-		const size_t samples_per_update = src.sampling_rate * update_interval;
+		const size_t samples_per_update = src.sampling_rate * update_interval_ms / 1000;
 
 		if( count >= samples_per_update ) {
 			const float max_squared_f = max_squared;
 			const int32_t max_db = mag2_to_dbv_norm(max_squared_f * (1.0f / (32768.0f * 32768.0f)));
-			callback({ max_db, count });
+			callback({ max_db, count, epoch });
 
 			max_squared = 0;
 			count = 0;
@@ -58,9 +74,11 @@ public:
 	}
 
 private:
-	static constexpr float update_interval { 0.1f };
+	uint32_t update_interval_ms { ChannelStatsConfigMessage::update_interval_default_ms };
+	uint32_t epoch { 0 };
 	uint32_t max_squared { 0 };
 	size_t count { 0 };
+	bool skip { false };
 };
 
 #endif/*__CHANNEL_STATS_COLLECTOR_H__*/
@@ -0,0 +1,214 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "coded_squelch.hpp"
+
+#include "complex.hpp"
+#include "dcs.hpp"
+
+#include <cmath>
+
+namespace {
+
+// Standard tones in 1/100 Hz, in the application's tone_keys order
+constexpr std::array<uint16_t, CodedSquelchDecoder::tone_count> ctcss_tones { {
+	 6700,  6940,  7190,  7440,  7700,  7970,  8250,  8540,  8850,  9150,
+	 9480,  9740, 10000, 10350, 10720, 11090, 11480, 11880, 12300, 12730,
+	13180, 13650, 14130, 14620, 15140, 15670, 15980, 16220, 16550, 16790,
+	17130, 17380, 17730, 17990, 18350, 18620, 18990, 19280, 19660, 19950,
+	20350, 20650, 21070, 21810, 22570, 22910, 23360, 24180, 25030, 25410
+} };
+
+constexpr uint32_t dcs_word_mask = (1U << 23) - 1;
+constexpr int32_t dcs_inverted_flag = 1 << 9;
+
+// 134.4bps as a fraction of the decimated rate, 32-bit phase
+constexpr uint32_t dcs_phase_increment_default = 134.4 * 4294967296.0 / CodedSquelchDecoder::decimated_rate;
+
+} /* namespace */
+
+void CodedSquelchDecoder::configure(const uint32_t sampling_rate) {
+	decimation_factor = sampling_rate / decimated_rate;
+	decimation_scale = 1.0f / (decimation_factor * 32768.0f);
+
+	for(size_t i=0; i<tone_count; i++) {
+		coefficients[i] = 2.0f * cosf(2.0f * pi * (ctcss_tones[i] / 100.0f) / decimated_rate);
+	}
+	block_samples = decimated_rate * block_ms / 1000;
+	dcs_phase_increment = dcs_phase_increment_default;
+
+	reset(message.epoch);
+}
+
+void CodedSquelchDecoder::reset(const uint32_t epoch) {
+	decimation_count = 0;
+	decimation_sum = 0;
+	dc_input = 0;
+	dc_output = 0;
+
+	s1.fill(0);
+	s2.fill(0);
+	block_energy = 0;
+	block_index = 0;
+	tone_vote = -1;
+	tone_held = -1;
+	tone_misses = 0;
+
+	dcs_phase = 0;
+	dcs_last_positive = false;
+	dcs_sr = 0;
+	dcs_candidate = -1;
+	dcs_bits_since = dcs_word_bits + 1;
+	dcs_held = -1;
+	dcs_hold_bits = 0;
+
+	message.type = CodedSquelchMessage::Type::None;
+	message.value = 0;
+	message.epoch = epoch;
+}
+
+bool CodedSquelchDecoder::ctcss_execute(const float sample) {
+	for(size_t i=0; i<tone_count; i++) {
+		const float s0 = sample + coefficients[i] * s1[i] - s2[i];
+		s2[i] = s1[i];
+		s1[i] = s0;
+	}
+	block_energy += sample * sample;
+
+	if( ++block_index < block_samples ) {
+		return false;
+	}
+
+	const auto vote = ctcss_vote();
+	const bool confirmed = (vote >= 0) && ((vote == tone_vote) || (vote == tone_held));
+	tone_vote = vote;
+
+	if( confirmed ) {
+		tone_held = vote;
+		tone_misses = 0;
+		message.type = CodedSquelchMessage::Type::CTCSS;
+		message.value = ctcss_tones[vote];
+		return true;
+	}
+
+	if( (tone_held >= 0) && (++tone_misses >= tone_misses_max) ) {
+		tone_held = -1;
+		return release();
+	}
+
+	return false;
+}
+
+/* Closes the block: returns the winning tone index, or -1 if there's no
+ * clear winner.
+ */
+int32_t CodedSquelchDecoder::ctcss_vote() {
+	int32_t best = -1;
+	float best_power = 0;
+	float runner_up_power = 0;
+
+	for(size_t i=0; i<tone_count; i++) {
+		const float power = s1[i] * s1[i] + s2[i] * s2[i] - coefficients[i] * s1[i] * s2[i];
+		if( power > best_power ) {
+			runner_up_power = best_power;
+			best_power = power;
+			best = i;
+		} else if( power > runner_up_power ) {
+			runner_up_power = power;
+		}
+	}
+
+	// A pure tone on a bin has power == energy * N / 2
+	const float energy = block_energy;
+	s1.fill(0);
+	s2.fill(0);
+	block_energy = 0;
+	block_index = 0;
+
+	if( best_power * 2.0f < tone_fraction_min * energy * block_samples ) {
+		return -1;
+	}
+	if( best_power < tone_margin * runner_up_power ) {
+		return -1;
+	}
+	return best;
+}
+
+bool CodedSquelchDecoder::dcs_execute(const float sample) {
+	// Pull the bit boundary toward each transition
+	const bool positive = (sample > 0);
+	if( positive != dcs_last_positive ) {
+		dcs_phase -= static_cast<uint32_t>(static_cast<int32_t>(dcs_phase) / 4);
+		dcs_last_positive = positive;
+	}
+
+	// Sample mid-bit
+	const uint32_t phase_prev = dcs_phase;
+	dcs_phase += dcs_phase_increment;
+	if( !((phase_prev < 0x80000000U) && (dcs_phase >= 0x80000000U)) ) {
+		return false;
+	}
+
+	// First bit sent ends up in bit 0
+	dcs_sr = ((dcs_sr >> 1) | (positive ? (1U << 22) : 0)) & dcs_word_mask;
+	if( dcs_bits_since <= dcs_word_bits ) {
+		dcs_bits_since++;
+	}
+
+	int32_t key = dcs::dcs_code(dcs_sr);
+	if( key < 0 ) {
+		key = dcs::dcs_code(~dcs_sr & dcs_word_mask);
+		if( key >= 0 ) {
+			key |= dcs_inverted_flag;
+		}
+	}
+
+	if( key >= 0 ) {
+		if( (key == dcs_candidate) && (dcs_bits_since == dcs_word_bits) ) {
+			dcs_held = key;
+			dcs_hold_bits = 0;
+			dcs_bits_since = 0;
+			message.type = (key & dcs_inverted_flag) ? CodedSquelchMessage::Type::DCSInverted : CodedSquelchMessage::Type::DCS;
+			message.value = key & ~dcs_inverted_flag;
+			return true;
+		}
+		// Other rotations of the word may also be valid codes, stick to the first
+		if( dcs_bits_since >= dcs_word_bits ) {
+			dcs_candidate = key;
+			dcs_bits_since = 0;
+		}
+	}
+
+	if( (dcs_held >= 0) && (++dcs_hold_bits > dcs_word_bits * dcs_misses_max) ) {
+		dcs_held = -1;
+		return release();
+	}
+
+	return false;
+}
+
+bool CodedSquelchDecoder::release() {
+	if( (tone_held >= 0) || (dcs_held >= 0) ) {
+		return false;
+	}
+
+	message.type = CodedSquelchMessage::Type::None;
+	message.value = 0;
+	return true;
+}
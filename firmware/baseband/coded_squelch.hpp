@@ -0,0 +1,124 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CODED_SQUELCH_H__
+#define __CODED_SQUELCH_H__
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* CTCSS and DCS decoder for the sub-audio band of NFM audio.
+ *
+ * Input is lowpassed below 300Hz, then boxcar-decimated to 1500Hz.
+ *
+ * CTCSS: one Goertzel bin per standard tone, evaluated over 192ms blocks. A
+ * block votes for a tone when its bin holds most of the block's energy and
+ * beats the runner-up by a margin, so adjacent tones (2.4Hz apart at worst)
+ * are told apart. Two votes in a row confirm the tone.
+ *
+ * DCS: the same samples are sliced and clocked at 134.4bps by a DPLL. After
+ * each bit, the last 23 are checked against the codeword table in both
+ * polarities. The word repeats, so a code seen again 23 bits later is
+ * confirmed.
+ *
+ * The handler gets a CodedSquelchMessage on each confirmation, and one with
+ * Type::None when neither a tone nor a code is held anymore.
+ */
+class CodedSquelchDecoder {
+public:
+	static constexpr uint32_t decimated_rate = 1500;
+	static constexpr size_t tone_count = 50;
+
+	void configure(const uint32_t sampling_rate);
+	/* Drops all decoding state. Messages from then on carry epoch. */
+	void reset(const uint32_t epoch);
+
+	template<typename Handler>
+	void execute(const buffer_s16_t& src, Handler handler) {
+		for(size_t i=0; i<src.count; i++) {
+			decimation_sum += src.p[i];
+			if( ++decimation_count < decimation_factor ) {
+				continue;
+			}
+
+			// DC block, ~2.4Hz corner
+			const float x = decimation_sum * decimation_scale;
+			dc_output = x - dc_input + dc_pole * dc_output;
+			dc_input = x;
+			decimation_sum = 0;
+			decimation_count = 0;
+
+			if( ctcss_execute(dc_output) ) {
+				handler(message);
+			}
+			if( dcs_execute(dc_output) ) {
+				handler(message);
+			}
+		}
+	}
+
+private:
+	static constexpr float dc_pole = 0.99f;
+	static constexpr uint32_t block_ms = 192;
+	static constexpr float tone_fraction_min = 0.3f;	// Of the block energy
+	static constexpr float tone_margin = 1.5f;			// Over the runner-up
+	static constexpr size_t tone_misses_max = 2;		// Blocks
+	static constexpr size_t dcs_word_bits = 23;
+	static constexpr size_t dcs_misses_max = 3;			// Words
+
+	size_t decimation_factor { 8 };
+	float decimation_scale { 0 };
+	size_t decimation_count { 0 };
+	int32_t decimation_sum { 0 };
+	float dc_input { 0 };
+	float dc_output { 0 };
+
+	// Goertzel bank, structure of arrays for a tight inner loop
+	std::array<float, tone_count> coefficients { };
+	std::array<float, tone_count> s1 { };
+	std::array<float, tone_count> s2 { };
+	float block_energy { 0 };
+	size_t block_samples { 0 };
+	size_t block_index { 0 };
+	int32_t tone_vote { -1 };
+	int32_t tone_held { -1 };
+	size_t tone_misses { 0 };
+
+	uint32_t dcs_phase { 0 };
+	uint32_t dcs_phase_increment { 0 };
+	bool dcs_last_positive { false };
+	uint32_t dcs_sr { 0 };
+	int32_t dcs_candidate { -1 };
+	size_t dcs_bits_since { 0 };
+	int32_t dcs_held { -1 };
+	size_t dcs_hold_bits { 0 };
+
+	CodedSquelchMessage message { };
+
+	bool ctcss_execute(const float sample);
+	int32_t ctcss_vote();
+	bool dcs_execute(const float sample);
+	bool release();
+};
+
+#endif/*__CODED_SQUELCH_H__*/
@@ -21,7 +21,7 @@
 
 #include "dsp_decimate.hpp"
 
-#include <hal.h>
+#include "simd.hpp"
 
 namespace dsp {
 namespace decimate {
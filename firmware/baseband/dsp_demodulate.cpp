@@ -25,8 +25,6 @@
 #include "fxpt_atan2.hpp"
 #include "utility_m4.hpp"
 
-#include <hal.h>
-
 namespace dsp {
 namespace demodulate {
 
@@ -0,0 +1,203 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GFSK_FRAMER_H__
+#define __GFSK_FRAMER_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "dsp_types.hpp"
+
+/* Frames packets out of an FM discriminator for simple GFSK radios (BLE,
+ * nRF24 ShockBurst).
+ *
+ * The slicer threshold is the mean of the last 16 bits. While hunting, each
+ * sample phase of the bit period shifts into its own register, which is
+ * compared against the sync word (preamble and/or address, in air order).
+ * The first phase to match reads the frame against the threshold held from
+ * the sync word. Received bytes are optionally dewhitened with a table, the
+ * length is read from the header and the finished frame is checked.
+ *
+ * Format describes the frame:
+ *	static constexpr size_t frame_bytes_max;
+ *	static constexpr size_t header_bytes;		// Needed to read the length
+ *	static constexpr bool lsb_first;			// Byte bit order on air
+ *	static size_t frame_length(const uint8_t* frame);	// Whole frame, 0 to drop
+ *	static bool check(const uint8_t* frame, const size_t length);
+ */
+
+namespace gfsk {
+
+constexpr uint64_t reverse_bits(const uint64_t value, const size_t bits) {
+	uint64_t result = 0;
+	for(size_t i=0; i<bits; i++) {
+		result |= ((value >> i) & 1) << (bits - 1 - i);
+	}
+	return result;
+}
+
+} /* namespace gfsk */
+
+template<typename Format>
+class GFSKFramer {
+public:
+	static constexpr size_t samples_per_bit_max = 8;
+
+	/* samples_per_bit must be a power of two. The prefix bits are put in the
+	 * frame ahead of the received bits, for checks that cover the sync word.
+	 */
+	void configure(
+		const size_t samples_per_bit,
+		const uint64_t sync_word,
+		const size_t sync_bits,
+		const size_t sync_errors_max,
+		const uint8_t* const whitening = nullptr,
+		const uint64_t prefix = 0,
+		const size_t prefix_bits = 0
+	) {
+		phase_mask = samples_per_bit - 1;
+		window_log2 = threshold_bits_log2;
+		for(size_t n=samples_per_bit; n>1; n>>=1) {
+			window_log2++;
+		}
+
+		this->sync_mask = (sync_bits >= 64) ? ~0ULL : ((1ULL << sync_bits) - 1);
+		this->sync_word = sync_word & this->sync_mask;
+		this->sync_errors_max = sync_errors_max;
+		this->whitening = whitening;
+		this->prefix = prefix;
+		this->prefix_bits = prefix_bits;
+
+		history.fill(0);
+		threshold_sum = 0;
+		sync_sr.fill(0);
+		state = State::Sync;
+	}
+
+	template<typename PacketHandler>
+	void execute(const buffer_s16_t& discriminator, PacketHandler handler) {
+		const size_t window_mask = (1U << window_log2) - 1;
+
+		for(size_t i=0; i<discriminator.count; i++) {
+			const int32_t sample = discriminator.p[i];
+
+			const size_t window_index = sample_index & window_mask;
+			threshold_sum += sample - history[window_index];
+			history[window_index] = sample;
+
+			const size_t phase = sample_index & phase_mask;
+			sample_index++;
+
+			if( state == State::Sync ) {
+				auto& sr = sync_sr[phase];
+				sr = (sr << 1) | (((sample << window_log2) > threshold_sum) ? 1 : 0);
+
+				if( static_cast<size_t>(__builtin_popcountll((sr ^ sync_word) & sync_mask)) <= sync_errors_max ) {
+					start_frame(phase);
+				}
+			} else if( phase == frame_phase ) {
+				if( add_bit(sample > threshold) ) {
+					if( Format::check(frame.data(), frame_length) ) {
+						handler(frame.data(), frame_length);
+					}
+					state = State::Sync;
+				}
+			}
+		}
+	}
+
+private:
+	static constexpr size_t threshold_bits_log2 = 4;
+
+	enum class State {
+		Sync,
+		Header,
+		Payload
+	};
+
+	std::array<int16_t, (1U << threshold_bits_log2) * samples_per_bit_max> history { };
+	int32_t threshold_sum { 0 };
+	size_t window_log2 { threshold_bits_log2 };
+	size_t sample_index { 0 };
+	size_t phase_mask { 0 };
+
+	std::array<uint64_t, samples_per_bit_max> sync_sr { };
+	uint64_t sync_word { 0 };
+	uint64_t sync_mask { 0 };
+	size_t sync_errors_max { 0 };
+
+	const uint8_t* whitening { nullptr };
+	uint64_t prefix { 0 };
+	size_t prefix_bits { 0 };
+
+	State state { State::Sync };
+	size_t frame_phase { 0 };
+	int32_t threshold { 0 };
+	std::array<uint8_t, Format::frame_bytes_max> frame { };
+	size_t frame_length { 0 };
+	size_t byte_index { 0 };
+	size_t bit_count { 0 };
+	uint8_t byte { 0 };
+
+	void start_frame(const size_t phase) {
+		// Hold the slicer level from the sync word for the rest of the frame
+		threshold = threshold_sum >> window_log2;
+		frame_phase = phase;
+		frame_length = Format::frame_bytes_max;
+		byte_index = 0;
+		bit_count = 0;
+		state = State::Header;
+		sync_sr.fill(0);
+
+		for(size_t i=prefix_bits; i>0; i--) {
+			add_bit((prefix >> (i - 1)) & 1);
+		}
+	}
+
+	/* Returns true once the frame is complete. */
+	bool add_bit(const bool bit) {
+		if( Format::lsb_first ) {
+			byte = (byte >> 1) | (bit ? 0x80 : 0);
+		} else {
+			byte = (byte << 1) | (bit ? 0x01 : 0);
+		}
+		if( ++bit_count < 8 ) {
+			return false;
+		}
+
+		bit_count = 0;
+		frame[byte_index] = whitening ? (byte ^ whitening[byte_index]) : byte;
+		byte_index++;
+
+		if( (state == State::Header) && (byte_index == Format::header_bytes) ) {
+			frame_length = Format::frame_length(frame.data());
+			if( (frame_length < byte_index) || (frame_length > Format::frame_bytes_max) ) {
+				state = State::Sync;
+				return false;
+			}
+			state = State::Payload;
+		}
+
+		return byte_index == frame_length;
+	}
+};
+
+#endif/*__GFSK_FRAMER_H__*/
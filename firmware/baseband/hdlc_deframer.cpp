@@ -0,0 +1,87 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "hdlc_deframer.hpp"
+
+void HDLCDeframer::reset() {
+	length_ = 0;
+	bit_count = 0;
+	byte = 0;
+	ones = 0;
+	in_frame = false;
+}
+
+bool HDLCDeframer::execute(const uint_fast8_t bit) {
+	if( bit & 1 ) {
+		if( ++ones > 6 ) {
+			// Abort, or idle line
+			in_frame = false;
+			return false;
+		}
+	} else {
+		const auto run = ones;
+		ones = 0;
+		if( run == 6 ) {
+			return close_frame();
+		}
+		if( run == 5 ) {
+			return false;		// Stuffed
+		}
+	}
+
+	if( !in_frame ) {
+		return false;
+	}
+
+	byte = (byte >> 1) | ((bit & 1) ? 0x80 : 0x00);
+	if( (++bit_count & 7) == 0 ) {
+		const size_t index = (bit_count >> 3) - 1;
+		if( index >= frame_bytes_max ) {
+			in_frame = false;
+			return false;
+		}
+		frame_[index] = byte;
+	}
+
+	return false;
+}
+
+/* The flag's leading zero and six ones have already gone into the frame. */
+bool HDLCDeframer::close_frame() {
+	bool good = false;
+
+	if( in_frame && (bit_count >= 7) && (((bit_count - 7) & 7) == 0) ) {
+		const size_t bytes = (bit_count - 7) >> 3;
+		if( bytes >= frame_bytes_min ) {
+			const size_t data_bytes = bytes - fcs_bytes;
+			fcs.reset();
+			fcs.process_bytes(frame_.data(), data_bytes);
+			const uint32_t received_fcs = frame_[data_bytes] | (frame_[data_bytes + 1] << 8);
+			if( fcs.checksum() == received_fcs ) {
+				length_ = data_bytes;
+				good = true;
+			}
+		}
+	}
+
+	// A flag also opens the next frame
+	in_frame = true;
+	bit_count = 0;
+	return good;
+}
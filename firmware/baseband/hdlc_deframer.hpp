@@ -0,0 +1,70 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __HDLC_DEFRAMER_H__
+#define __HDLC_DEFRAMER_H__
+
+#include "crc.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Byte-oriented HDLC receiver for AX.25: takes NRZI-decoded bits (LSB of
+ * each byte first), drops the stuffed zeros, splits frames on flags and checks
+ * the FCS-16 (CRC-CCITT, reflected, sent low byte first) with a table.
+ *
+ * Seven or more ones in a row abort the frame in progress. Only frames of a
+ * whole number of bytes, long enough for two addresses, are checked.
+ */
+class HDLCDeframer {
+public:
+	static constexpr size_t fcs_bytes = 2;
+	static constexpr size_t frame_bytes_min = 14 + 1 + fcs_bytes;				// Two addresses, control
+	static constexpr size_t frame_bytes_max = 10 * 7 + 2 + 256 + fcs_bytes;		// Eight digipeaters, PID, info
+
+	void reset();
+
+	/* Returns true when a flag closes a frame with a good FCS. The frame, without
+	 * its FCS, is then in frame() and length() until the next call.
+	 */
+	bool execute(const uint_fast8_t bit);
+
+	const uint8_t* frame() const {
+		return frame_.data();
+	}
+
+	size_t length() const {
+		return length_;
+	}
+
+private:
+	std::array<uint8_t, frame_bytes_max> frame_ { };
+	size_t length_ { 0 };
+	size_t bit_count { 0 };		// Since the last flag, stuffing removed
+	uint8_t byte { 0 };
+	uint32_t ones { 0 };
+	bool in_frame { false };
+
+	TableCRC<16, 0x1021, true, true> fcs { 0xFFFF, 0xFFFF };
+
+	bool close_frame();
+};
+
+#endif/*__HDLC_DEFRAMER_H__*/
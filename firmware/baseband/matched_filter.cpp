@@ -25,6 +25,7 @@
 #include <cmath>
 
 #include "utility.hpp"
+#include "simd.hpp"
 
 namespace dsp {
 namespace matched_filter {
@@ -103,5 +104,70 @@ void MatchedFilter::shift_by_decimation_factor() {
 	}
 }
 
+void MatchedFilterQ15::configure(
+	const tap_t* const taps,
+	const size_t taps_count,
+	const size_t decimation_factor
+) {
+	float taps_sum = 0.0f;
+	for(size_t n=0; n<taps_count; n++) {
+		taps_sum += std::abs(taps[n].real()) + std::abs(taps[n].imag());
+	}
+	const float tap_scale = 32767.0f / std::max(taps_sum, 1.0f);
+
+	samples_ = std::make_unique<uint32_t[]>(taps_count * 2);
+	taps_reversed_ = std::make_unique<uint32_t[]>(taps_count);
+	taps_count_ = taps_count;
+	write_index = 0;
+	decimation_factor_ = decimation_factor;
+	decimation_phase = 0;
+	output_scale = 1.0f / tap_scale;
+	output = 0;
+
+	for(size_t n=0; n<taps_count; n++) {
+		const auto& tap = taps[taps_count - 1 - n];
+		const int32_t tr = std::lround(tap.real() * tap_scale);
+		const int32_t ti = std::lround(tap.imag() * tap_scale);
+		taps_reversed_[n] = (static_cast<uint32_t>(tr) & 0xffff) | (static_cast<uint32_t>(ti) << 16);
+	}
+}
+
+bool MatchedFilterQ15::execute_once(
+	const sample_t input
+) {
+	samples_[write_index] = input.__rep();
+	samples_[write_index + taps_count_] = input.__rep();
+	write_index = (write_index + 1 == taps_count_) ? 0 : (write_index + 1);
+
+	decimation_phase = (decimation_phase + 1 == decimation_factor_) ? 0 : (decimation_phase + 1);
+	if( decimation_phase != 0 ) {
+		return false;
+	}
+
+	// Oldest sample first, as in MatchedFilter
+	const uint32_t* s = &samples_[write_index];
+	const uint32_t* t = &taps_reversed_[0];
+
+	int32_t r_n = 0;	// sr*tr + si*ti
+	int32_t r_p = 0;	// sr*tr - si*ti
+	int32_t i_n = 0;	// sr*ti - si*tr (negated, only the magnitude matters)
+	int32_t i_p = 0;	// sr*ti + si*tr
+	for(size_t n=0; n<taps_count_; n++) {
+		const uint32_t sample = *(s++);
+		const uint32_t tap = *(t++);
+		r_n = __SMLAD(sample, tap, r_n);
+		r_p = __SMLSD(sample, tap, r_p);
+		i_n = __SMLSDX(sample, tap, i_n);
+		i_p = __SMLADX(sample, tap, i_p);
+	}
+
+	const float rn = r_n, in = i_n, rp = r_p, ip = i_p;
+	const auto mag_n = __builtin_sqrtf(rn * rn + in * in);
+	const auto mag_p = __builtin_sqrtf(rp * rp + ip * ip);
+	output = (mag_p - mag_n) * output_scale;
+
+	return true;
+}
+
 } /* namespace matched_filter */
 } /* namespace dsp */
@@ -23,9 +23,12 @@
 #define __MATCHED_FILTER_H__
 
 #include <cstddef>
+#include <cstdint>
 #include <complex>
 #include <memory>
 
+#include "complex.hpp"
+
 namespace dsp {
 namespace matched_filter {
 
@@ -90,6 +93,59 @@ private:
 	);
 };
 
+/* Same filter as MatchedFilter, for complex16_t input, in fixed point.
+ *
+ * Taps are scaled to Q15 so their sum of |re| + |im| is at most 1.0, which
+ * keeps each 32-bit accumulator from overflowing at any input level. Each tap
+ * takes four dual 16-bit MACs. The history is stored twice over, so the last
+ * taps_count samples are always contiguous and no shifting is needed.
+ * The output has the same scale as MatchedFilter fed with the same samples.
+ */
+class MatchedFilterQ15 {
+public:
+	using sample_t = complex16_t;
+	using tap_t = std::complex<float>;
+
+	template<class T>
+	MatchedFilterQ15(
+		const T& taps,
+		size_t decimation_factor = 1
+	) {
+		configure(taps, decimation_factor);
+	}
+
+	template<class T>
+	void configure(
+		const T& taps,
+		size_t decimation_factor
+	) {
+		configure(taps.data(), taps.size(), decimation_factor);
+	}
+
+	bool execute_once(const sample_t input);
+
+	float get_output() const {
+		return output;
+	}
+
+private:
+	// Packed complex16_t / Q15 taps, real in the low half
+	std::unique_ptr<uint32_t[]> samples_ { };
+	std::unique_ptr<uint32_t[]> taps_reversed_ { };
+	size_t taps_count_ { 0 };
+	size_t write_index { 0 };
+	size_t decimation_factor_ { 1 };
+	size_t decimation_phase { 0 };
+	float output_scale { 1.0f };
+	float output { 0 };
+
+	void configure(
+		const tap_t* const taps,
+		const size_t taps_count,
+		const size_t decimation_factor
+	);
+};
+
 } /* namespace matched_filter */
 } /* namespace dsp */
 
@@ -0,0 +1,98 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "polyphase_interpolator.hpp"
+
+#include "simd.hpp"
+
+namespace dsp {
+namespace interpolation {
+
+void FIRInterpolateComplexC8::configure(const int16_t* const taps, const size_t interpolation_factor) {
+	interpolation_factor_ = interpolation_factor;
+
+	/* Output phase p of input n is sum(h[p + k*L] * x[n - k]). The window holds
+	 * x[n - (taps_per_phase - 1)] first, so taps go in reverse k order.
+	 */
+	for(size_t p=0; p<interpolation_factor; p++) {
+		for(size_t j=0; j<taps_per_phase; j+=2) {
+			const auto t0 = taps[p + (taps_per_phase - 1 - j) * interpolation_factor];
+			const auto t1 = taps[p + (taps_per_phase - 2 - j) * interpolation_factor];
+			taps_packed[p * pairs_per_phase + j / 2] = (static_cast<uint32_t>(t0) & 0xffff) | (static_cast<uint32_t>(t1) << 16);
+		}
+	}
+
+	window_re.fill(0);
+	window_im.fill(0);
+}
+
+static inline int8_t round_c8(const int32_t accum, const int32_t dither) {
+	/* Q14 accumulator to the C8 scale (C16 >> 8), rounding with dither added. */
+	return __SSAT((accum + ((128 + dither) << 14)) >> 22, 8);
+}
+
+buffer_c8_t FIRInterpolateComplexC8::execute(
+	const buffer_c16_t& src,
+	const buffer_c8_t& dst
+) {
+	const auto L = interpolation_factor_;
+	auto dst_p = dst.p;
+
+	for(size_t n=0; n<src.count; n++) {
+		const uint32_t sample = *reinterpret_cast<const uint32_t*>(&src.p[n]);
+
+		// Shift the new sample into the top of both windows
+		for(size_t k=0; k<(pairs_per_phase - 1); k++) {
+			window_re[k] = (window_re[k] >> 16) | (window_re[k + 1] << 16);
+			window_im[k] = (window_im[k] >> 16) | (window_im[k + 1] << 16);
+		}
+		window_re[pairs_per_phase - 1] = (window_re[pairs_per_phase - 1] >> 16) | (sample << 16);
+		window_im[pairs_per_phase - 1] = (window_im[pairs_per_phase - 1] >> 16) | (sample & 0xffff0000);
+
+		const uint32_t* t = taps_packed.data();
+		for(size_t p=0; p<L; p++) {
+			int32_t re = 0;
+			int32_t im = 0;
+			for(size_t k=0; k<pairs_per_phase; k++) {
+				re = __SMLAD(window_re[k], t[k], re);
+				im = __SMLAD(window_im[k], t[k], im);
+			}
+			t += pairs_per_phase;
+
+			// xorshift32, two bytes of triangular dither per component
+			dither_state ^= dither_state << 13;
+			dither_state ^= dither_state >> 17;
+			dither_state ^= dither_state << 5;
+			const int32_t dither_re = static_cast<int32_t>(dither_state & 0xff) - static_cast<int32_t>((dither_state >> 8) & 0xff);
+			const int32_t dither_im = static_cast<int32_t>((dither_state >> 16) & 0xff) - static_cast<int32_t>(dither_state >> 24);
+
+			*(dst_p++) = { round_c8(re, dither_re), round_c8(im, dither_im) };
+		}
+	}
+
+	return {
+		dst.p,
+		src.count * L,
+		src.sampling_rate * L
+	};
+}
+
+} /* namespace interpolation */
+} /* namespace dsp */
@@ -0,0 +1,79 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __POLYPHASE_INTERPOLATOR_H__
+#define __POLYPHASE_INTERPOLATOR_H__
+
+#include "dsp_types.hpp"
+#include "dsp_fir_taps.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+namespace dsp {
+namespace interpolation {
+
+/* Polyphase FIR interpolator, complex int16_t in, complex int8_t out.
+ * Prototype taps are Q14 with unity gain per phase, taps_per_phase taps for
+ * each output phase, so the interpolation factor is taps.size() / taps_per_phase.
+ * Output is rounded to C8 with +/-1 LSB triangular dither instead of being
+ * truncated, which keeps the requantization error from folding into spurs.
+ */
+class FIRInterpolateComplexC8 {
+public:
+	static constexpr size_t taps_per_phase = 8;
+	static constexpr size_t interpolation_factor_max = 16;
+
+	template<size_t N>
+	void configure(const fir_taps_real<N>& taps) {
+		static_assert((N % taps_per_phase) == 0, "Tap count must be a multiple of taps_per_phase");
+		static_assert((N / taps_per_phase) <= interpolation_factor_max, "Interpolation factor too large");
+		configure(taps.taps.data(), N / taps_per_phase);
+	}
+
+	size_t interpolation_factor() const {
+		return interpolation_factor_;
+	}
+
+	/* dst.count must be at least src.count * interpolation_factor(). */
+	buffer_c8_t execute(
+		const buffer_c16_t& src,
+		const buffer_c8_t& dst
+	);
+
+private:
+	static constexpr size_t pairs_per_phase = taps_per_phase / 2;
+
+	// Per phase, pairs of taps in window order (oldest sample first), packed for SMLAD
+	std::array<uint32_t, interpolation_factor_max * pairs_per_phase> taps_packed { };
+	// Last taps_per_phase input samples, real and imaginary parts packed in pairs
+	std::array<uint32_t, pairs_per_phase> window_re { };
+	std::array<uint32_t, pairs_per_phase> window_im { };
+	size_t interpolation_factor_ { 1 };
+	uint32_t dither_state { 0x2545f491 };
+
+	void configure(const int16_t* const taps, const size_t interpolation_factor);
+};
+
+} /* namespace interpolation */
+} /* namespace dsp */
+
+#endif/*__POLYPHASE_INTERPOLATOR_H__*/
@@ -28,122 +28,121 @@
 #include <cstdint>
 #include <cstddef>
 
+#include <algorithm>
+
 using namespace adsb;
+
+ADSBRXProcessor::ADSBRXProcessor() {
+	ADSBFrame frame { };
+	uint8_t* const data = frame.get_raw_data();
+	for (size_t i = 0; i < frame_bits; i++) {
+		frame.clear();
+		data[i >> 3] = 0x80 >> (i & 7);
+		bit_syndromes[i] = crc_residue(data, 14);
+	}
+}
+
+bool ADSBRXProcessor::is_preamble(const uint16_t* const m) const {
+	// Pulses at 0, 1, 3.5 and 4.5us, each above its neighbours
+	if ((m[0] <= m[1]) || (m[2] <= m[1]) || (m[2] <= m[3]) ||
+		(m[7] <= m[6]) || (m[7] <= m[8]) || (m[9] <= m[8]))
+		return false;
 	
-void ADSBRXProcessor::execute(const buffer_c8_t& buffer) {
-	int8_t re, im;
-	float mag;
-	uint32_t c;
-	uint8_t level, bit, byte { };
-	//bool confidence;
-	bool first_in_window, last_in_window;
+	const uint32_t on = m[0] + m[2] + m[7] + m[9];
+	if (on < pulse_level_min * 4)
+		return false;
+	
+	// Correlate against the gaps: mean of 4 pulses vs. mean of 12 quiet samples
+	const uint32_t off = m[1] + m[3] + m[4] + m[5] + m[6] + m[8] +
+		m[10] + m[11] + m[12] + m[13] + m[14] + m[15];
+	
+	return (on * 3) > (off * preamble_snr_min);
+}
+
+bool ADSBRXProcessor::decode(const uint16_t* const m, ADSBFrame& frame) const {
+	const uint16_t* d = m + preamble_samples;
+	uint8_t byte { 0 };
+	
+	frame.clear();
+	for (size_t bit = 0; bit < frame_bits; bit++, d += 2) {
+		// Pulse in the first half is a 1
+		byte = (byte << 1) | ((d[0] > d[1]) ? 1 : 0);
+		
+		if (bit == 4) {
+			// Only extended squitters (DF17 ADS-B, DF18 TIS-B) have a CRC that can be checked
+			if ((byte != 17) && (byte != 18))
+				return false;
+		}
+		
+		if ((bit & 7) == 7)
+			frame.push_byte(byte);
+	}
+	
+	return true;
+}
+
+bool ADSBRXProcessor::correct(ADSBFrame& frame) const {
+	uint8_t* const data = frame.get_raw_data();
+	const uint32_t syndrome = crc_residue(data, 14);
+	
+	if (!syndrome)
+		return true;
+	
+	// Fix one bit at most, and never in the DF field
+	for (size_t i = 5; i < frame_bits; i++) {
+		if (bit_syndromes[i] == syndrome) {
+			data[i >> 3] ^= 0x80 >> (i & 7);
+			return true;
+		}
+	}
 	
+	return false;
+}
+
+void ADSBRXProcessor::execute(const buffer_c8_t& buffer) {
 	// This is called at 2M/2048 = 977Hz
-	// One pulse = 500ns = 2 samples
-	// One bit = 2 pulses = 1us = 4 samples
 	
 	if (!configured) return;
 	
-	for (size_t i = 0; i < buffer.count; i++) {
-		
-		// Compute sample's magnitude
-		re = buffer.p[i].real();
-		im = buffer.p[i].imag();
-		mag = __builtin_sqrtf((re * re) + (im * im)) * k;
+	const size_t count = std::min(buffer.count, buffer_samples_max);
+	
+	// Keep the tail of the previous buffer, for frames that straddle buffers
+	std::copy(&mag[last_count], &mag[last_count + frame_samples], &mag[0]);
+	last_count = count;
+	
+	for (size_t i = 0; i < count; i++) {
+		const int32_t re = buffer.p[i].real();
+		const int32_t im = buffer.p[i].imag();
+		mag[frame_samples + i] = (re * re) + (im * im);
+	}
+	
+	// Every start position whose whole frame is now available
+	for (size_t i = 0; i < count; i++) {
+		if (holdoff) {
+			holdoff--;
+			continue;
+		}
 		
-		// Only used for preamble detection and visualisation
-		level = (mag < 0.3) ? 0 :		// Blank weak signals
-					(mag > prev_mag) ? 1 : 0;
+		const uint16_t* const m = &mag[i];
+		if (!is_preamble(m))
+			continue;
 		
-		if (decoding) {
-			// Decode
-			
-			// 1 bit lasts 2 samples
-			if (sample_count & 1) {
-				if ((prev_mag < threshold_low) && (mag < threshold_low)) {
-					// Both under window, silence.
-					if (null_count > 3) {
-						const ADSBFrameMessage message(frame);
-						shared_memory.application_queue.push(message);
-							
-						decoding = false;
-					} else
-						null_count++;
-						
-					//confidence = false;
-					if (prev_mag > mag)
-						bit = 1;
-					else
-						bit = 0;
-					
-				} else {
-					
-					null_count = 0;
-				
-					first_in_window = ((prev_mag >= threshold_low) && (prev_mag <= threshold_high));
-					last_in_window = ((mag >= threshold_low) && (mag <= threshold_high));
-					
-					if ((first_in_window && !last_in_window) || (!first_in_window && last_in_window)) {
-						//confidence = true;
-						if (prev_mag > mag)
-							bit = 1;
-						else
-							bit = 0;
-					} else {
-						//confidence = false;
-						if (prev_mag > mag)
-							bit = 1;
-						else
-							bit = 0;
-					}
-				}
-				
-				byte = bit | (byte << 1);
-				bit_count++;
-				if (!(bit_count & 7)) {
-					// Got one byte
-					frame.push_byte(byte);
-				}
-			}
-			sample_count++;
-		} else {
-			// Look for preamble
+		ADSBFrame frame { };
+		if (decode(m, frame) && correct(frame)) {
+			const ADSBFrameMessage message(frame);
+			shared_memory.application_queue.push(message);
 			
-			// Shift
-			for (c = 0; c < (ADSB_PREAMBLE_LENGTH - 1); c++)
-				shifter[c] = shifter[c + 1];
-			shifter[15] = std::make_pair(mag, level);
-			
-			// Compare
-			for (c = 0; c < ADSB_PREAMBLE_LENGTH; c++) {
-				if (shifter[c].second != adsb_preamble[c])
-					break;
-			}
-				
-			if (c == ADSB_PREAMBLE_LENGTH) {
-				decoding = true;
-				sample_count = 0;
-				null_count = 0;
-				bit_count = 0;
-				frame.clear();
-				
-				// Compute preamble pulses power to set thresholds
-				threshold = (shifter[0].first + shifter[2].first + shifter[7].first + shifter[9].first) / 4;
-				threshold_high = threshold * 1.414;		// +3dB
-				threshold_low = threshold * 0.707;		// -3dB
-			}
+			// The next sample would decode the same frame, half a bit late
+			holdoff = 1;
 		}
-		
-		prev_mag = mag;
 	}
 }
 
 void ADSBRXProcessor::on_message(const Message* const message) {
 	if (message->id == Message::ID::ADSBConfigure) {
-		null_count = 0;
-		bit_count = 0;
-		sample_count = 0;
-		decoding = false;
+		mag.fill(0);
+		last_count = 0;
+		holdoff = 0;
 		configured = true;
 	}
 }
@@ -29,36 +29,50 @@
 
 #include "adsb_frame.hpp"
 
-using namespace adsb;
+#include <array>
 
-#define ADSB_PREAMBLE_LENGTH 16
+using namespace adsb;
 
 class ADSBRXProcessor : public BasebandProcessor {
 public:
+	ADSBRXProcessor();
+
 	void execute(const buffer_c8_t& buffer) override;
 	
 	void on_message(const Message* const message) override;
 
 private:
-	static constexpr float k = 1.0f / 128.0f;
-	
 	static constexpr size_t baseband_fs = 2000000;
 	
+	// One pulse = 500ns = 1 sample, one bit = 1us = 2 samples
+	static constexpr size_t preamble_samples = 16;
+	static constexpr size_t frame_bits = 112;
+	static constexpr size_t frame_samples = preamble_samples + frame_bits * 2;
+	static constexpr size_t buffer_samples_max = 2048;
+	
+	// Squared magnitudes (re^2 + im^2 of int8 samples)
+	static constexpr uint32_t pulse_level_min = 38 * 38;	// Blank weak signals
+	static constexpr uint32_t preamble_snr_min = 4;			// Pulses vs. gaps, 6dB
+	
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 	
-	ADSBFrame frame { };
 	bool configured { false };
-	float prev_mag { 0 };
-	float threshold { }, threshold_low { }, threshold_high { };
-	size_t null_count { 0 }, bit_count { 0 }, sample_count { 0 };
-	std::pair<float, uint8_t> shifter[ADSB_PREAMBLE_LENGTH];
-	bool decoding { };
-	bool preamble { }, active { };
-    uint16_t bit_pos { 0 };
-    uint8_t cur_bit { 0 };
-	uint32_t sample { 0 };
-	int8_t re { }, im { };
+	
+	/* Magnitudes of the last frame_samples of the previous buffer, followed by
+	 * the current buffer. Each candidate is decoded straight from here, so
+	 * frames that overlap each other are all tried.
+	 */
+	std::array<uint16_t, frame_samples + buffer_samples_max> mag { };
+	size_t last_count { 0 };
+	size_t holdoff { 0 };
+	
+	// CRC remainder of each single bit error, for correction
+	std::array<uint32_t, frame_bits> bit_syndromes { };
+	
+	bool is_preamble(const uint16_t* const m) const;
+	bool decode(const uint16_t* const m, ADSBFrame& frame) const;
+	bool correct(ADSBFrame& frame) const;
 };
 
 #endif
@@ -25,6 +25,8 @@
 
 #include "event_m4.hpp"
 
+#include <algorithm>
+
 void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 	// This is called at 3072000 / 2048 = 1500Hz
 
@@ -81,30 +83,9 @@ void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 			
 			if (trigger_word) {
 				
-				// Continuous-stream value-triggered mode (AX.25) - UNTESTED
-				word_bits <<= 1;
-				word_bits |= (sample_bits & 1);
-				
-				bit_counter++;
-				
-				if (triggered) {
-					if (bit_counter == word_length) {
-						bit_counter = 0;
-						
-						data_message.is_data = true;
-						data_message.value = word_bits & word_mask;
-						shared_memory.application_queue.push(data_message);
-					}
-				} else {
-					if ((word_bits & word_mask) == trigger_value) {
-						triggered = !triggered;
-						bit_counter = 0;
-						
-						data_message.is_data = true;
-						data_message.value = trigger_value;
-						shared_memory.application_queue.push(data_message);
-					}
-				}
+				// Continuous-stream mode (AX.25): NRZI, then HDLC deframing
+				if (hdlc.execute(nrzi_decode(sample_bits & 1)))
+					on_frame(hdlc.frame(), hdlc.length());
 				
 			} else {
 				
@@ -141,6 +122,16 @@ void AFSKRxProcessor::execute(const buffer_c8_t& buffer) {
 	}
 }
 
+void AFSKRxProcessor::on_frame(const uint8_t* const frame, const size_t length) {
+	if (length > AX25PacketMessage::frame_size_max)
+		return;
+	
+	AX25PacketMessage message { };
+	message.length = length;
+	std::copy(&frame[0], &frame[length], message.frame.begin());
+	shared_memory.application_queue.push(message);
+}
+
 void AFSKRxProcessor::on_message(const Message* const message) {
 	if (message->id == Message::ID::AFSKRxConfigure)
 		configure(*reinterpret_cast<const AFSKRxConfigureMessage*>(message));
@@ -172,13 +163,11 @@ void AFSKRxProcessor::configure(const AFSKRxConfigureMessage& message) {
 	
 	trigger_word = message.trigger_word;
 	word_length = message.word_length;
-	trigger_value = message.trigger_value;
-	word_mask = (1 << word_length) - 1;
+	hdlc.reset();
 	
 	// Delay line
 	delay_line_index = 0;
 	
-	triggered = false;
 	state = WAIT_START;
 	
 	configured = true;
@@ -31,6 +31,8 @@
 #include "dsp_demodulate.hpp"
 
 #include "audio_output.hpp"
+#include "symbol_coding.hpp"
+#include "hdlc_deframer.hpp"
 
 #include "fifo.hpp"
 #include "message.hpp"
@@ -78,6 +80,9 @@ private:
 	
 	AudioOutput audio_output { };
 
+	symbol_coding::NRZIDecoder nrzi_decode { };
+	HDLCDeframer hdlc { };
+
 	State state { };
 	size_t delay_line_index { };
 	uint32_t bit_counter { 0 };
@@ -86,16 +91,14 @@ private:
 	uint32_t phase { }, phase_inc { };
 	int32_t sample_mixed { }, prev_mixed { }, sample_filtered { }, prev_filtered { };
 	uint32_t word_length { };
-	uint32_t word_mask { };
-	uint32_t trigger_value { };
 	
 	bool configured { false };
 	bool wait_start { };
 	bool bit_value { };
 	bool trigger_word { };
-	bool triggered { };
 	
 	void configure(const AFSKRxConfigureMessage& message);
+	void on_frame(const uint8_t* const frame, const size_t length);
 	
 	AFSKDataMessage data_message { false, 0 };
 };
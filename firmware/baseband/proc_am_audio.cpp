@@ -68,6 +68,10 @@ void NarrowbandAMAudio::on_message(const Message* const message) {
 	case Message::ID::CaptureConfig:
 		capture_config(*reinterpret_cast<const CaptureConfigMessage*>(message));
 		break;
+
+	case Message::ID::ChannelStatsConfig:
+		configure_channel_stats(*reinterpret_cast<const ChannelStatsConfigMessage*>(message));
+		break;
 		
 	default:
 		break;
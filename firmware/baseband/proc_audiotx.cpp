@@ -31,18 +31,11 @@ void AudioTXProcessor::execute(const buffer_c8_t& buffer){
 	
 	if (!configured) return;
 	
-	// Zero-order hold (poop)
+	// Whole blocks from the stream, interpolated up to the TX rate
+	feeder.execute(stream.get(), { audio.data(), buffer.count, baseband_fs });
+	
 	for (size_t i = 0; i < buffer.count; i++) {
-		resample_acc += resample_inc;
-		if (resample_acc >= 0x10000) {
-			resample_acc -= 0x10000;
-			if (stream) {
-				stream->read(&audio_sample, 1);
-				bytes_read++;
-			}
-		}
-		
-		sample = tone_gen.process(audio_sample - 0x80);
+		sample = tone_gen.process(audio[i] >> 8);
 		
 		// FM
 		delta = sample * fm_delta;
@@ -60,7 +53,7 @@ void AudioTXProcessor::execute(const buffer_c8_t& buffer){
 	if (progress_samples >= progress_interval_samples) {
 		progress_samples -= progress_interval_samples;
 		
-		txprogress_message.progress = bytes_read;	// Inform UI about progress
+		txprogress_message.progress = feeder.samples_read();	// Inform UI about progress
 		txprogress_message.done = false;
 		shared_memory.application_queue.push(txprogress_message);
 	}
@@ -74,7 +67,7 @@ void AudioTXProcessor::on_message(const Message* const message) {
 
 		case Message::ID::ReplayConfig:
 			configured = false;
-			bytes_read = 0;
+			feeder.reset();
 			replay_config(*reinterpret_cast<const ReplayConfigMessage*>(message));
 			break;
 		
@@ -95,7 +88,8 @@ void AudioTXProcessor::audio_config(const AudioTXConfigMessage& message) {
 	fm_delta = message.deviation_hz * (0xFFFFFFULL / baseband_fs);
 	tone_gen.configure(message.tone_key_delta, message.tone_key_mix_weight);
 	progress_interval_samples = message.divider;
-	resample_acc = 0;
+	bits_per_sample = message.bits_per_sample;
+	feeder.configure(sample_rate, baseband_fs, bits_per_sample);
 }
 
 void AudioTXProcessor::replay_config(const ReplayConfigMessage& message) {
@@ -111,7 +105,8 @@ void AudioTXProcessor::replay_config(const ReplayConfigMessage& message) {
 }
 
 void AudioTXProcessor::samplerate_config(const SamplerateConfigMessage& message) {
-	resample_inc = (((uint64_t)message.sample_rate) << 16) / baseband_fs;	// 16.16 fixed point message.sample_rate
+	sample_rate = message.sample_rate;
+	feeder.configure(sample_rate, baseband_fs, bits_per_sample);
 }
 
 int main() {
@@ -27,6 +27,9 @@
 #include "baseband_thread.hpp"
 #include "tone_gen.hpp"
 #include "stream_output.hpp"
+#include "audio_feeder.hpp"
+
+#include <array>
 
 class AudioTXProcessor : public BasebandProcessor {
 public:
@@ -41,19 +44,21 @@ private:
 	
 	std::unique_ptr<StreamOutput> stream { };
 	
+	AudioFeeder feeder { };
+	std::array<int16_t, 2048> audio { };
+	uint32_t sample_rate { 8000 };
+	uint32_t bits_per_sample { 8 };
+	
 	ToneGen tone_gen { };
 	
-	uint32_t resample_inc { }, resample_acc { };
 	uint32_t fm_delta { 0 };
 	uint32_t phase { 0 }, sphase { 0 };
-	uint8_t audio_sample { };
 	int32_t sample { 0 }, delta { };
 	int8_t re { 0 }, im { 0 };
 	
 	size_t progress_interval_samples, progress_samples = 0;
 	
 	bool configured { false };
-	uint32_t bytes_read { 0 };
 	
 	void samplerate_config(const SamplerateConfigMessage& message);
 	void audio_config(const AudioTXConfigMessage& message);
@@ -26,295 +26,61 @@
 
 #include "event_m4.hpp"
 
-void BTLERxProcessor::execute(const buffer_c8_t& buffer) {
-	if (!configured) return;
-	
-	// FM demodulation
+#include "crc.hpp"
 
-	/*const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	const auto channel = decim_1.execute(decim_0_out, dst_buffer);
+#include <algorithm>
 
-	feed_channel_stats(channel);
+size_t BLEAdvertisingFormat::frame_length(const uint8_t* frame) {
+	const size_t payload_length = frame[1] & 0x3F;
+	if (payload_length > BTLEPacketMessage::pdu_size_max - header_bytes)
+		return 0;
 	
-	auto audio_oversampled = demod.execute(channel, work_audio_buffer);*/
+	return header_bytes + payload_length + crc_length;
+}
 
-	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	feed_channel_stats(decim_0_out);
+bool BLEAdvertisingFormat::check(const uint8_t* frame, const size_t length) {
+	// CRC24 runs LSB first and is sent low byte first
+	const size_t pdu_length = length - crc_length;
+	TableCRC<24, 0x00065B, true, true> crc { 0x555555 };
+	crc.process_bytes(frame, pdu_length);
+	const uint32_t received_crc =
+		frame[pdu_length] | (frame[pdu_length + 1] << 8) | (frame[pdu_length + 2] << 16);
 	
-	auto audio_oversampled = demod.execute(decim_0_out, work_audio_buffer);
+	return crc.checksum() == received_crc;
+}
 
-	/*std::fill(spectrum.begin(), spectrum.end(), 0);
-	for(size_t i=0; i<spectrum.size(); i++) {
-		spectrum[i] += buffer.p[i];
-	}
-	const buffer_c16_t buffer_c16 {spectrum.data(),spectrum.size(),buffer.sampling_rate};
-	feed_channel_stats(buffer_c16);
+void BTLERxProcessor::execute(const buffer_c8_t& buffer) {
+	if (!configured) return;
 	
-	auto audio_oversampled = demod.execute(buffer_c16, work_audio_buffer);*/
-	// Audio signal processing
-	for (size_t c = 0; c < audio_oversampled.count; c++) {
-		int result;
-
-		/*const int32_t sample_int = audio_oversampled.p[c] * 32768.0f;
-		int32_t current_sample = __SSAT(sample_int, 16);
-		current_sample /= 128;*/
-                
-		int32_t current_sample = audio_oversampled.p[c]; //if I directly use this, some results can pass crc but not correct.
-                rb_head++;
-	        rb_head=(rb_head)%RB_SIZE;
-
-                rb_buf[rb_head] = current_sample;
-
-		skipSamples = skipSamples - 1;
-
-
-		if (skipSamples<1)
-		{
-				
-
-			int32_t threshold_tmp=0;
-			for (int c=0;c<8;c++)
-			{
-				threshold_tmp = threshold_tmp + (int32_t)rb_buf[(rb_head+c)%RB_SIZE];
-			}
-			g_threshold = (int32_t)threshold_tmp/8;
-
-				
-			int transitions=0;
-			if (rb_buf[(rb_head+9)%RB_SIZE] > g_threshold)
-			{
-				for (int c=0;c<8;c++)
-				{
-					if (rb_buf[(rb_head + c)%RB_SIZE] > rb_buf[(rb_head + c + 1)%RB_SIZE])
-					transitions = transitions + 1;
-				}
-			}
-			else
-			{
-				for (int c=0;c<8;c++)
-				{
-					if (rb_buf[(rb_head + c)%RB_SIZE] < rb_buf[(rb_head + c + 1)%RB_SIZE])
-					transitions = transitions + 1;
-				}
-			}
-			
-			bool packet_detected=false;
-			//if ( transitions==4 && abs(g_threshold)<15500)
-			if ( transitions==4)
-			{
-
-				
-				uint8_t packet_data[500];
-				int packet_length;
-				uint32_t packet_crc;
-				uint32_t calced_crc;
-				uint64_t packet_addr_l;
-				uint32_t result;
-				uint8_t crc[3];
-				uint8_t packet_header_arr[2];
-
-				packet_addr_l=0;
-				for (int i=0;i<4;i++) 
-				{                   
-				    bool current_bit;
-				    uint8_t byte=0;
-				    for (int c=0;c<8;c++)
-				    {
-				        if (rb_buf[(rb_head + (i+1)*8 + c)%RB_SIZE] > g_threshold)
-				            current_bit = true;
-				        else
-				            current_bit = false;
-				        byte |= current_bit << (7-c);
-				    }
-				    uint8_t byte_temp = (uint8_t) (((byte * 0x0802LU & 0x22110LU) | (byte * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				    packet_addr_l|=((uint64_t)byte_temp)<<(8*i);
-				}
-
-				channel_number = 38;
-
-				
-				for (int t=0;t<2;t++)
-				{
-				    bool current_bit;
-				    uint8_t byte=0;
-				    for (int c=0;c<8;c++)
-				    {
-				        if (rb_buf[(rb_head + 5*8+t*8 + c)%RB_SIZE] > g_threshold)
-				            current_bit = true;
-				        else
-				            current_bit = false;
-				        byte |= current_bit << (7-c);
-				    }
-
-				    packet_header_arr[t] = byte;
-				}
-
-				
-
-				uint8_t byte_temp2 = (uint8_t) (((channel_number * 0x0802LU & 0x22110LU) | (channel_number * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				uint8_t lfsr_1 = byte_temp2 | 2;
-				int header_length = 2;
-				int header_counter = 0;
-				while(header_length--)
-				{
-				    for(uint8_t i = 0x80; i; i >>= 1)
-				    {
-				        if(lfsr_1 & 0x80)
-				        {
-				            lfsr_1 ^= 0x11;
-				            (packet_header_arr[header_counter]) ^= i;
-				        }
-				        lfsr_1 <<= 1;
-				    }
-				    header_counter = header_counter + 1;
-				}
-
-				
-
-				if (packet_addr_l==0x8E89BED6)
-				{  
-
-				    uint8_t byte_temp3 = (uint8_t) (((packet_header_arr[1] * 0x0802LU & 0x22110LU) | (packet_header_arr[1] * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				    packet_length=byte_temp3&0x3F;
-				
-				} 
-				else 
-				{
-				    packet_length=0;
-				}
-
-				for (int t=0;t<packet_length+2+3;t++)
-				{
-				    bool current_bit;
-				    uint8_t byte=0;
-				    for (int c=0;c<8;c++)
-				    {
-				        if (rb_buf[(rb_head + 5*8+t*8 + c)%RB_SIZE] > g_threshold)
-				            current_bit = true;
-				        else
-				            current_bit = false;
-				        byte |= current_bit << (7-c);
-				    }
-
-				    packet_data[t] = byte;
-				}
-
-				
-
-				uint8_t byte_temp4 = (uint8_t) (((channel_number * 0x0802LU & 0x22110LU) | (channel_number * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				uint8_t lfsr_2 = byte_temp4 | 2;
-				int pdu_crc_length = packet_length+2+3;
-				int pdu_crc_counter = 0;
-				while(pdu_crc_length--)
-				{
-				    for(uint8_t i = 0x80; i; i >>= 1)
-				    {
-				        if(lfsr_2 & 0x80)
-				        {
-				            lfsr_2 ^= 0x11;
-				            (packet_data[pdu_crc_counter]) ^= i;
-				        }
-				        lfsr_2 <<= 1;
-				    }
-				    pdu_crc_counter = pdu_crc_counter + 1;
-				}
-
-				
-
-				if (packet_addr_l==0x8E89BED6)
-				{  
-				    crc[0]=crc[1]=crc[2]=0x55;
-				}
-				else 
-				{
-				    crc[0]=crc[1]=crc[2]=0;
-				}
-
-				uint8_t v, t, d, crc_length;
-				uint32_t crc_result=0;
-				crc_length = packet_length + 2;
-				int counter = 0;
-				while(crc_length--)
-				{
-				    uint8_t byte_temp5 = (uint8_t) (((packet_data[counter] * 0x0802LU & 0x22110LU) | (packet_data[counter] * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-				    d = byte_temp5;
-				    for(v = 0; v < 8; v++, d >>= 1)
-				    {
-				        t = crc[0] >> 7;
-				        crc[0] <<= 1;
-				        if(crc[1] & 0x80) crc[0] |= 1;
-				        crc[1] <<= 1;
-				        if(crc[2] & 0x80) crc[1] |= 1;
-				        crc[2] <<= 1;
-				        if(t != (d & 1))
-				        {
-				            crc[2] ^= 0x5B;
-				            crc[1] ^= 0x06;
-				        }
-				    }
-				    counter = counter + 1;
-				}
-				for (v=0;v<3;v++) crc_result=(crc_result<<8)|crc[v];
-				calced_crc = crc_result;
-
-				packet_crc=0;
-				for (int c=0;c<3;c++) packet_crc=(packet_crc<<8)|packet_data[packet_length+2+c];
-
-				if (packet_addr_l==0x8E89BED6)
-				//if (packet_crc==calced_crc)
-				{
-				    uint8_t mac_data[6];
-				    int counter = 0;
-				    for (int i = 7; i >= 2; i--) 
-				    {
-				        uint8_t byte_temp6 = (uint8_t) (((packet_data[i] * 0x0802LU & 0x22110LU) | (packet_data[i] * 0x8020LU & 0x88440LU)) * 0x10101LU >> 16);
-					//result = byte_temp6;
-					mac_data[counter] = byte_temp6;
-					counter = counter + 1;
-				    }
-
-				    data_message.is_data = false;
-			            data_message.value = 'A';
-				    shared_memory.application_queue.push(data_message);
-
-				    data_message.is_data = true;
-			            data_message.value = mac_data[0];
-				    shared_memory.application_queue.push(data_message);
-
-				    data_message.is_data = true;
-			            data_message.value = mac_data[1];
-				    shared_memory.application_queue.push(data_message);
-
-				    data_message.is_data = true;
-			            data_message.value = mac_data[2];
-				    shared_memory.application_queue.push(data_message);
-
-				    data_message.is_data = true;
-			            data_message.value = mac_data[3];
-				    shared_memory.application_queue.push(data_message);
-
-				    data_message.is_data = true;
-			            data_message.value = mac_data[4];
-				    shared_memory.application_queue.push(data_message);
-
-				    data_message.is_data = true;
-			            data_message.value = mac_data[5];
-				    shared_memory.application_queue.push(data_message);
+	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
+	feed_channel_stats(decim_0_out);
+	
+	const auto discriminator = demod.execute(decim_0_out, demod_buffer);
 
-				    data_message.is_data = false;
-			            data_message.value = 'B';
-				    shared_memory.application_queue.push(data_message);
+	framer.execute(discriminator, [this](const uint8_t* const frame, const size_t length) {
+		this->on_packet(frame, length);
+	});
+}
 
-				    packet_detected = true;
-				}
-				else
-				    packet_detected = false;
-			}
+void BTLERxProcessor::on_packet(const uint8_t* const pdu, const size_t length) {
+	BTLEPacketMessage message { };
+	message.channel_number = channel_number;
+	message.length = length - BLEAdvertisingFormat::crc_length;
+	std::copy(&pdu[0], &pdu[message.length], message.pdu.begin());
+	shared_memory.application_queue.push(message);
+}
 
-			if (packet_detected) 
-			{
-				skipSamples=20;
-			}
+void BTLERxProcessor::make_whitening() {
+	// x^7 + x^4 + 1, position 0 set and positions 1 to 6 loaded with the channel index
+	uint8_t lfsr = 0x40 | (channel_number & 0x3F);
+	for (auto& w : whitening) {
+		w = 0;
+		for (size_t b = 0; b < 8; b++) {
+			const uint8_t out = lfsr & 1;
+			w |= out << b;
+			lfsr >>= 1;
+			if (out)
+				lfsr ^= 0x44;
 		}
 	}
 }
@@ -324,10 +90,14 @@ void BTLERxProcessor::on_message(const Message* const message) {
 		configure(*reinterpret_cast<const BTLERxConfigureMessage*>(message));
 }
 
-void BTLERxProcessor::configure(const BTLERxConfigureMessage& message) {	
-	decim_0.configure(taps_200k_wfm_decim_0.taps, 33554432);
-	decim_1.configure(taps_200k_wfm_decim_1.taps, 131072);
-	demod.configure(audio_fs, 5000);
+void BTLERxProcessor::configure(const BTLERxConfigureMessage& message) {
+	demod.configure(demod_fs, 500000);
+	
+	channel_number = message.channel_number;
+	make_whitening();
+	// Air order is LSB first
+	framer.configure(samples_per_bit, gfsk::reverse_bits(adv_access_address, 32), 32,
+		access_address_errors_max, whitening.data());
 
 	configured = true;
 }
@@ -31,11 +31,27 @@
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
 
-#include "audio_output.hpp"
-
-#include "fifo.hpp"
+#include "gfsk_framer.hpp"
 #include "message.hpp"
 
+#include <array>
+
+/* BLE 1M PHY advertising channel PDU, as seen by GFSKFramer. */
+struct BLEAdvertisingFormat {
+	static constexpr size_t crc_length = 3;
+	static constexpr size_t frame_bytes_max = BTLEPacketMessage::pdu_size_max + crc_length;
+	static constexpr size_t header_bytes = 2;
+	static constexpr bool lsb_first = true;
+
+	static size_t frame_length(const uint8_t* frame);
+	static bool check(const uint8_t* frame, const size_t length);
+};
+
+/* BLE 1M PHY, advertising channels. The channel is brought to DC and
+ * decimated to 2 samples per bit, then FM demodulated and framed on the
+ * advertising access address. PDUs are dewhitened with a per-channel table
+ * and checked with CRC24 before they are sent to the application.
+ */
 class BTLERxProcessor : public BasebandProcessor {
 public:
 	void execute(const buffer_c8_t& buffer) override;
@@ -44,52 +60,39 @@ public:
 	
 private:
 	static constexpr size_t baseband_fs = 4000000;
-	static constexpr size_t audio_fs = baseband_fs / 8 / 8 / 2;
+	static constexpr size_t demod_fs = baseband_fs / 2;
+	static constexpr size_t samples_per_bit = 2;
+	
+	static constexpr uint32_t adv_access_address = 0x8E89BED6;
+	static constexpr size_t access_address_errors_max = 1;
 	
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 	
-	std::array<complex16_t, 512> dst { };
+	std::array<complex16_t, 1024> dst { };
 	const buffer_c16_t dst_buffer {
 		dst.data(),
 		dst.size()
 	};
 
-        std::array<complex16_t, 512> spectrum { };
-	const buffer_c16_t spectrum_buffer {
-		spectrum.data(),
-		spectrum.size()
+	std::array<int16_t, 1024> demod_samples { };
+	const buffer_s16_t demod_buffer {
+		demod_samples.data(),
+		demod_samples.size()
 	};
 
-	const buffer_s16_t work_audio_buffer {
-		(int16_t*)dst.data(),
-		sizeof(dst) / sizeof(int16_t)
-	};
-
-
-	// Array size ok down to 375 bauds (24000 / 375)
-	std::array<int32_t, 64> delay_line { 0 };
-	std::array<int16_t, 1000> rb_buf { 0 };
-
-	/*dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
-	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::decimate::FIRAndDecimateComplex channel_filter { };*/
-	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
-	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
-	
+	dsp::decimate::TranslateByFSOver4AndDecimateBy2CIC3 decim_0 { };
 	dsp::demodulate::FM demod { };
-	int rb_head {-1};
-	int32_t g_threshold {0};  
-	uint8_t channel_number {38};
-	int skipSamples {1000};
-	int RB_SIZE {1000};
+	GFSKFramer<BLEAdvertisingFormat> framer { };
+	
+	uint8_t channel_number { 37 };
+	std::array<uint8_t, BLEAdvertisingFormat::frame_bytes_max> whitening { };
 
 	bool configured { false };
 
-	
 	void configure(const BTLERxConfigureMessage& message);
-	
-	AFSKDataMessage data_message { false, 0 };
+	void make_whitening();
+	void on_packet(const uint8_t* const pdu, const size_t length);
 };
 
 #endif/*__PROC_BTLERX_H__*/
@@ -31,21 +31,42 @@
 CaptureProcessor::CaptureProcessor() {
 	decim_0.configure(taps_200k_decim_0.taps, 33554432);
 	decim_1.configure(taps_200k_decim_1.taps, 131072);
+	channel_filter.configure(taps_capture_narrow.taps, 1);
 	
 	channel_spectrum.set_decimation_factor(1);
 }
 
-void CaptureProcessor::execute(const buffer_c8_t& buffer) {
-	/* 2.4576MHz, 2048 samples */
-	const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-	const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
-	const auto& decimator_out = decim_1_out;
-	const auto& channel = decimator_out;
+buffer_c16_t CaptureProcessor::decimate(const buffer_c8_t& buffer) {
+	switch(decimation) {
+	case 2:
+		return decim_0_by_2.execute(buffer, dst_buffer);
+	
+	case 4:
+		return decim_0.execute(buffer, dst_buffer);
+	
+	case 8:
+	default:
+		return decim_1.execute(decim_0.execute(buffer, dst_buffer), dst_buffer);
+	}
+}
 
-	if( stream ) {
-		const size_t bytes_to_write = sizeof(*decimator_out.p) * decimator_out.count;
-		const auto result = stream->write(decimator_out.p, bytes_to_write);
+/* C16 to C8 in place, rounding rather than truncating. */
+static buffer_c8_t to_c8(const buffer_c16_t& src) {
+	const auto src_p = reinterpret_cast<const uint32_t*>(src.p);
+	const auto dst_p = reinterpret_cast<uint16_t*>(src.p);
+	for(size_t i=0; i<src.count; i++) {
+		const uint32_t q_i = src_p[i];
+		const int32_t i8 = __SSAT((static_cast<int16_t>(q_i & 0xffff) + 128) >> 8, 8);
+		const int32_t q8 = __SSAT((static_cast<int16_t>(q_i >> 16) + 128) >> 8, 8);
+		dst_p[i] = (i8 & 0xff) | ((q8 & 0xff) << 8);
 	}
+	return { reinterpret_cast<complex8_t*>(src.p), src.count, src.sampling_rate };
+}
+
+void CaptureProcessor::execute(const buffer_c8_t& buffer) {
+	/* 2.4576MHz, 2048 samples */
+	const auto decimator_out = decimate(buffer);
+	const auto channel = narrow_filter ? channel_filter.execute(decimator_out, dst_buffer) : decimator_out;
 
 	feed_channel_stats(channel);
 
@@ -54,6 +75,15 @@ void CaptureProcessor::execute(const buffer_c8_t& buffer) {
 		spectrum_samples -= spectrum_interval_samples;
 		channel_spectrum.feed(channel, channel_filter_pass_f, channel_filter_stop_f);
 	}
+
+	if( stream ) {
+		if( format == CaptureConfig::Format::C8 ) {
+			const auto c8 = to_c8(channel);
+			stream->write(c8.p, sizeof(*c8.p) * c8.count);
+		} else {
+			stream->write(channel.p, sizeof(*channel.p) * channel.count);
+		}
+	}
 }
 
 void CaptureProcessor::on_message(const Message* const message) {
@@ -71,6 +101,10 @@ void CaptureProcessor::on_message(const Message* const message) {
 		capture_config(*reinterpret_cast<const CaptureConfigMessage*>(message));
 		break;
 
+	case Message::ID::CaptureChainConfig:
+		capture_chain_config(*reinterpret_cast<const CaptureChainConfigMessage*>(message));
+		break;
+
 	default:
 		break;
 	}
@@ -79,22 +113,42 @@ void CaptureProcessor::on_message(const Message* const message) {
 void CaptureProcessor::samplerate_config(const SamplerateConfigMessage& message) {
 	baseband_fs = message.sample_rate;
 	baseband_thread.set_sampling_rate(baseband_fs);
-	
-	size_t decim_0_output_fs = baseband_fs / decim_0.decimation_factor;
+	update_rates();
+}
+
+void CaptureProcessor::capture_chain_config(const CaptureChainConfigMessage& message) {
+	decimation = message.decimation;
+	narrow_filter = message.narrow_filter;
+	update_rates();
+}
 
-	size_t decim_1_input_fs = decim_0_output_fs;
-	size_t decim_1_output_fs = decim_1_input_fs / decim_1.decimation_factor;
+void CaptureProcessor::update_rates() {
+	const size_t output_fs = baseband_fs / decimation;
 
-	channel_filter_pass_f = taps_200k_decim_1.pass_frequency_normalized * decim_1_input_fs;	// 162760.416666667
-	channel_filter_stop_f = taps_200k_decim_1.stop_frequency_normalized * decim_1_input_fs;	// 337239.583333333
+	if( narrow_filter ) {
+		channel_filter_pass_f = taps_capture_narrow.pass_frequency_normalized * output_fs;
+		channel_filter_stop_f = taps_capture_narrow.stop_frequency_normalized * output_fs;
+	} else if( decimation == 8 ) {
+		const size_t decim_1_input_fs = baseband_fs / decim_0.decimation_factor;
+		channel_filter_pass_f = taps_200k_decim_1.pass_frequency_normalized * decim_1_input_fs;	// 162760.416666667
+		channel_filter_stop_f = taps_200k_decim_1.stop_frequency_normalized * decim_1_input_fs;	// 337239.583333333
+	} else {
+		// The first stage only rejects aliases, the whole output band is passed
+		channel_filter_pass_f = output_fs * 2 / 5;
+		channel_filter_stop_f = output_fs / 2;
+	}
 
-	spectrum_interval_samples = decim_1_output_fs / spectrum_rate_hz;
+	spectrum_interval_samples = output_fs / spectrum_rate_hz;
 	spectrum_samples = 0;
 }
 
 void CaptureProcessor::capture_config(const CaptureConfigMessage& message) {
 	if( message.config ) {
-		stream = std::make_unique<StreamInput>(message.config);
+		format = message.config->format;
+		message.config->sampling_rate = baseband_fs / decimation;
+		// Release the old ring first so its memory counts as free.
+		stream.reset();
+		stream = std::make_unique<StreamInput>(message.config, true);
 	} else {
 		stream.reset();
 	}
@@ -52,17 +52,24 @@ private:
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 
-	std::array<complex16_t, 512> dst { };
+	// Large enough for the shallowest chain (decimation by 2)
+	std::array<complex16_t, 1024> dst { };
 	const buffer_c16_t dst_buffer {
 		dst.data(),
 		dst.size()
 	};
 
+	dsp::decimate::TranslateByFSOver4AndDecimateBy2CIC3 decim_0_by_2 { };
 	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
 	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
+	dsp::decimate::FIRAndDecimateComplex channel_filter { };
+	size_t decimation = 8;
+	bool narrow_filter = false;
 	uint32_t channel_filter_pass_f = 0;
 	uint32_t channel_filter_stop_f = 0;
 
+	CaptureConfig::Format format { CaptureConfig::Format::C16 };
+
 	std::unique_ptr<StreamInput> stream { };
 
 	SpectrumCollector channel_spectrum { };
@@ -71,6 +78,10 @@ private:
 
 	void samplerate_config(const SamplerateConfigMessage& message);
 	void capture_config(const CaptureConfigMessage& message);
+	void capture_chain_config(const CaptureChainConfigMessage& message);
+	void update_rates();
+
+	buffer_c16_t decimate(const buffer_c8_t& buffer);
 };
 
 #endif/*__PROC_CAPTURE_HPP__*/
@@ -53,37 +53,9 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
 			 * -> FIR filter, <300Hz pass, >300Hz stop, gain of 1
 			 * -> 12kHz int16_t[8] */
 			auto audio_ctcss = ctcss_filter.execute(audio, work_audio_buffer);
-			
-			// s16 to f32 for hpf
-			std::array<float, 8> audio_f;
-			for (size_t i = 0; i < audio_ctcss.count; i++) {
-				audio_f[i] = audio_ctcss.p[i] * ki;
-			}
-			
-			hpf.execute_in_place(buffer_f32_t {
-				audio_f.data(),
-				audio_ctcss.count,
-				audio_ctcss.sampling_rate
-				});
-			
-			// Zero-crossing detection
-			for (size_t c = 0; c < audio_ctcss.count; c++) {
-				cur_sample = audio_f[c];
-				if (cur_sample * prev_sample < 0.0) {
-					z_acc += z_timer;
-					z_timer = 0;
-					z_count++;
-				} else
-					z_timer++;
-				prev_sample = cur_sample;
-			}
-			
-			if (z_count >= 30) {
-				ctcss_message.value = (100 * 12000 / 2 * z_count) / z_acc;
-				shared_memory.application_queue.push(ctcss_message);
-				z_count = 0;
-				z_acc = 0;
-			}
+			coded_squelch.execute(audio_ctcss, [](const CodedSquelchMessage& message) {
+				shared_memory.application_queue.push(message);
+			});
 		}
 	} else {
 		// Direction-finding mode; output tone with pitch related to RSSI
@@ -117,6 +89,14 @@ void NarrowbandFMAudio::on_message(const Message* const message) {
 	case Message::ID::CaptureConfig:
 		capture_config(*reinterpret_cast<const CaptureConfigMessage*>(message));
 		break;
+
+	case Message::ID::ChannelStatsConfig:
+		configure_channel_stats(*reinterpret_cast<const ChannelStatsConfigMessage*>(message));
+		break;
+
+	case Message::ID::CodedSquelchReset:
+		coded_squelch.reset(reinterpret_cast<const CodedSquelchResetMessage*>(message)->epoch);
+		break;
 	
 	case Message::ID::PitchRSSIConfigure:
 		pitch_rssi_config(*reinterpret_cast<const PitchRSSIConfigureMessage*>(message));
@@ -148,8 +128,8 @@ void NarrowbandFMAudio::configure(const NBFMConfigureMessage& message) {
 	channel_spectrum.set_decimation_factor(std::floor(channel_filter_output_fs / (channel_filter_pass_f + channel_filter_stop_f)));
 	audio_output.configure(message.audio_hpf_config, message.audio_deemph_config, (float)message.squelch_level / 100.0);
 	
-	hpf.configure(audio_24k_hpf_30hz_config);
 	ctcss_filter.configure(taps_64_lp_025_025.taps);
+	coded_squelch.configure(demod_input_fs / 2);
 
 	configured = true;
 }
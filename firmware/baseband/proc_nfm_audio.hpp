@@ -31,6 +31,8 @@
 #include "dsp_demodulate.hpp"
 #include "dsp_iir.hpp"
 
+#include "coded_squelch.hpp"
+
 #include "audio_output.hpp"
 #include "spectrum_collector.hpp"
 
@@ -76,9 +78,9 @@ private:
 	uint32_t channel_filter_pass_f = 0;
 	uint32_t channel_filter_stop_f = 0;
 	
-	// For CTCSS decoding
+	// For CTCSS/DCS decoding
 	dsp::decimate::FIR64AndDecimateBy2Real ctcss_filter { };
-	IIRBiquadFilter hpf { };
+	CodedSquelchDecoder coded_squelch { };
 
 	dsp::demodulate::FM demod { };
 
@@ -90,11 +92,7 @@ private:
 	uint32_t tone_delta { 0 };
 	bool pitch_rssi_enabled { false };
 	
-	float cur_sample { }, prev_sample { };
-	uint32_t z_acc { 0}, z_timer { 0 }, z_count { 0 };
 	bool ctcss_detect_enabled { true };
-	static constexpr float k = 32768.0f;
-	static constexpr float ki = 1.0f / k;
 
 	bool configured { false };
 	void pitch_rssi_config(const PitchRSSIConfigureMessage& message);
@@ -102,7 +100,6 @@ private:
 	void capture_config(const CaptureConfigMessage& message);
 	
 	//RequestSignalMessage sig_message { RequestSignalMessage::Signal::Squelched };
-	CodedSquelchMessage ctcss_message { 0 };
 };
 
 #endif/*__PROC_NFM_AUDIO_H__*/
@@ -31,11 +31,30 @@
 #include "dsp_decimate.hpp"
 #include "dsp_demodulate.hpp"
 
-#include "audio_output.hpp"
-
-#include "fifo.hpp"
+#include "gfsk_framer.hpp"
 #include "message.hpp"
 
+#include <array>
+
+/* nRF24 Enhanced ShockBurst frame, as seen by GFSKFramer. The frame starts
+ * with 7 zero bits and the 5 byte address (the framer prefix), so the 9 bit
+ * packet control field leaves the payload and CRC16 byte aligned.
+ */
+struct ShockBurstFormat {
+	static constexpr size_t payload_offset = 7;
+	static constexpr size_t crc_length = 2;
+	static constexpr size_t frame_bytes_max = payload_offset + NRFPacketMessage::payload_size_max + crc_length;
+	static constexpr size_t header_bytes = payload_offset;
+	static constexpr bool lsb_first = false;
+
+	static size_t frame_length(const uint8_t* frame);
+	static bool check(const uint8_t* frame, const size_t length);
+};
+
+/* nRF24L01+ at 250kbps, 1Mbps or 2Mbps. The channel is brought to DC and
+ * decimated by 2, then FM demodulated and framed on the preamble and the
+ * configured address. 2Mbps runs the baseband at 8MHz.
+ */
 class NRFRxProcessor : public BasebandProcessor {
 public:
 	void execute(const buffer_c8_t& buffer) override;
@@ -43,54 +62,34 @@ public:
 	void on_message(const Message* const message) override;
 	
 private:
-	static constexpr size_t baseband_fs = 4000000;
-	static constexpr size_t audio_fs = baseband_fs / 8 / 8 / 2;
+	static constexpr size_t address_bits = 40;
+	static constexpr size_t sync_errors_max = 1;
 	
-	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive };
+	BasebandThread baseband_thread { 4000000, this, NORMALPRIO + 20, baseband::Direction::Receive };
 	RSSIThread rssi_thread { NORMALPRIO + 10 };
 	
-	std::array<complex16_t, 512> dst { };
+	std::array<complex16_t, 1024> dst { };
 	const buffer_c16_t dst_buffer {
 		dst.data(),
 		dst.size()
 	};
 
-        std::array<complex16_t, 512> spectrum { };
-	const buffer_c16_t spectrum_buffer {
-		spectrum.data(),
-		spectrum.size()
+	std::array<int16_t, 1024> demod_samples { };
+	const buffer_s16_t demod_buffer {
+		demod_samples.data(),
+		demod_samples.size()
 	};
 
-	const buffer_s16_t work_audio_buffer {
-		(int16_t*)dst.data(),
-		sizeof(dst) / sizeof(int16_t)
-	};
-
-
-	// Array size ok down to 375 bauds (24000 / 375)
-	std::array<int32_t, 64> delay_line { 0 };
-	std::array<int16_t, 1000> rb_buf { 0 };
-
-	/*dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0 { };
-	dsp::decimate::FIRC16xR16x32Decim8 decim_1 { };
-	dsp::decimate::FIRAndDecimateComplex channel_filter { };*/
-	dsp::decimate::FIRC8xR16x24FS4Decim4 decim_0 { };
-	dsp::decimate::FIRC16xR16x16Decim2 decim_1 { };
-	
+	dsp::decimate::TranslateByFSOver4AndDecimateBy2CIC3 decim_0 { };
 	dsp::demodulate::FM demod { };
-	int rb_head {-1};
-	int32_t g_threshold {0};  
-	//uint8_t g_srate {8}; 
-	uint8_t channel_number {38};
-	int skipSamples {1000};
-	int RB_SIZE {1000};
+	GFSKFramer<ShockBurstFormat> framer { };
+	
+	uint64_t address { 0 };
 
 	bool configured { false };
 
-	
 	void configure(const NRFRxConfigureMessage& message);
-	
-	AFSKDataMessage data_message { false, 0 };
+	void on_packet(const uint8_t* const frame, const size_t length);
 };
 
 #endif/*__PROC_NRFRX_H__*/
@@ -107,8 +107,7 @@ void POCSAGProcessor::execute(const buffer_c8_t& buffer) {
 							
 							// Got a complete codeword
 							
-							//pocsag_brute_repair(&s->l2.pocsag, &rx_data);
-							
+							packet.count_errors(pocsag::bch_repair(rx_data));
 							packet.set(codeword_count, rx_data);
 							
 							if (codeword_count < 15) {
@@ -36,6 +36,8 @@ ReplayProcessor::ReplayProcessor() {
 
 	channel_spectrum.set_decimation_factor(1);
 	
+	configure_interpolation(8);
+	
 	configured = false;
 }
 
@@ -44,28 +46,22 @@ void ReplayProcessor::execute(const buffer_c8_t& buffer) {
 	
 	if (!configured) return;
 	
-	// File data is in C16 format, we need C8
-	// File samplerate is 500kHz, we're at 4MHz
-	// iq_buffer can only be 512 C16 samples (RAM limitation)
-	// To fill up the 2048-sample C8 buffer, we need:
-	// 2048 samples * 2 bytes per sample = 4096 bytes
-	// Since we're oversampling by 4M/500k = 8, we only need 2048/8 = 256 samples from the file and duplicate them 8 times each
-	// So 256 * 4 bytes per sample (C16) = 1024 bytes from the file
+	// File data is in C16 format at baseband_fs / interpolation, we need C8 at baseband_fs
+	// Only buffer.count / interpolation samples are read from the file (1024 bytes at x8)
+	const size_t iq_count = buffer.count / interpolator.interpolation_factor();
+	const buffer_c16_t iq_buffer {
+		iq.data(),
+		iq_count,
+		baseband_fs / interpolator.interpolation_factor()
+	};
+	
 	if( stream ) {
-		const size_t bytes_to_read = sizeof(*buffer.p) * 2 * (buffer.count / 8);	// *2 (C16), /8 (oversampling) should be == 1024
+		const size_t bytes_to_read = sizeof(*iq_buffer.p) * iq_count;
 		bytes_read += stream->read(iq_buffer.p, bytes_to_read);
 	}
 	
-	// Fill and "stretch"
-	for (size_t i = 0; i < buffer.count; i++) {
-		if (i & 3) {
-			buffer.p[i] = buffer.p[i - 1];
-		} else {
-			auto re_out = iq_buffer.p[i >> 3].real() >> 8;
-			auto im_out = iq_buffer.p[i >> 3].imag() >> 8;
-			buffer.p[i] = { (int8_t)re_out, (int8_t)im_out };
-		}
-	}
+	// Polyphase FIR instead of sample-and-hold, rounded and dithered down to C8
+	interpolator.execute(iq_buffer, buffer);
 	
 	spectrum_samples += buffer.count;
 	if( spectrum_samples >= spectrum_interval_samples ) {
@@ -113,6 +109,7 @@ void ReplayProcessor::samplerate_config(const SamplerateConfigMessage& message)
 
 void ReplayProcessor::replay_config(const ReplayConfigMessage& message) {
 	if( message.config ) {
+		configure_interpolation(message.config->interpolation);
 		
 		stream = std::make_unique<StreamOutput>(message.config);
 		
@@ -123,6 +120,23 @@ void ReplayProcessor::replay_config(const ReplayConfigMessage& message) {
 	}
 }
 
+void ReplayProcessor::configure_interpolation(const size_t interpolation) {
+	switch(interpolation) {
+	case 4:
+		interpolator.configure(taps_interpolate_x4);
+		break;
+	
+	case 16:
+		interpolator.configure(taps_interpolate_x16);
+		break;
+	
+	case 8:
+	default:
+		interpolator.configure(taps_interpolate_x8);
+		break;
+	}
+}
+
 int main() {
 	EventDispatcher event_dispatcher { std::make_unique<ReplayProcessor>() };
 	event_dispatcher.run();
@@ -27,6 +27,7 @@
 #include "baseband_thread.hpp"
 
 #include "spectrum_collector.hpp"
+#include "polyphase_interpolator.hpp"
 
 #include "stream_output.hpp"
 
@@ -47,13 +48,12 @@ private:
 
 	BasebandThread baseband_thread { baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit };
 
-	std::array<complex16_t, 256> iq { };
-	const buffer_c16_t iq_buffer {
-		iq.data(),
-		iq.size(),
-		baseband_fs / 8
-	};
+	// File samples for one baseband buffer at the lowest interpolation (x4)
+	std::array<complex16_t, 512> iq { };
 	
+	dsp::interpolation::FIRInterpolateComplexC8 interpolator { };
+	
+
 	uint32_t channel_filter_pass_f = 0;
 	uint32_t channel_filter_stop_f = 0;
 
@@ -68,6 +68,7 @@ private:
 
 	void samplerate_config(const SamplerateConfigMessage& message);
 	void replay_config(const ReplayConfigMessage& message);
+	void configure_interpolation(const size_t interpolation);
 	
 	TXProgressMessage txprogress_message { };
 	RequestSignalMessage sig_message { RequestSignalMessage::Signal::FillRequest };
@@ -23,8 +23,13 @@
 
 #include "event_m4.hpp"
 
+#include "dsp_fft.hpp"
+#include "utility.hpp"
+
 #include <cstdint>
 #include <cstddef>
+#include <cmath>
+#include <algorithm>
 
 #include <array>
 
@@ -34,36 +39,184 @@ void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
 	
 	if (!configured) return;
 
+	if( settle ) {
+		settle--;
+		return;
+	}
+
 	if( phase == 0 ) {
-		std::fill(spectrum.begin(), spectrum.end(), 0);
+		slice_timestamp = Timestamp::now();
 	}
 
-	for(size_t i=0; i<spectrum.size(); i++) {
-		// TODO: Removed window-presum windowing, due to lack of available code RAM.
-		// TODO: Apply window to improve spectrum bin sidelobes.
-		spectrum[i] += buffer.p[i +    0];
-		spectrum[i] += buffer.p[i + 1024];
+	/* Finish the frame started at the end of the previous buffer. */
+	if( straddle_count ) {
+		std::copy(&buffer.p[0], &buffer.p[frame_size - straddle_count], &straddle[straddle_count]);
+		process_frame(straddle.data());
+		straddle_count = 0;
 	}
 
+	while( frame_offset + frame_size <= buffer.count ) {
+		process_frame(&buffer.p[frame_offset]);
+		frame_offset += frame_hop;
+	}
+
+	/* Keep the head of a frame running into the next buffer. With hops that
+	 * don't divide the buffer, a second frame may also start here: skipped.
+	 */
+	if( frame_offset < buffer.count ) {
+		straddle_count = buffer.count - frame_offset;
+		std::copy(&buffer.p[frame_offset], &buffer.p[buffer.count], straddle.begin());
+		while( frame_offset < buffer.count ) {
+			frame_offset += frame_hop;
+		}
+	}
+	frame_offset -= buffer.count;
+
 	if( phase == trigger ) {
-		const buffer_c16_t buffer_c16 {
-			spectrum.data(),
-			spectrum.size(),
-			buffer.sampling_rate
-		};
-		channel_spectrum.feed(
-			buffer_c16,
-			0, 0
-		);
+		publish();
 		phase = 0;
 	} else {
 		phase++;
 	}
 }
 
+void WidebandSpectrum::process_frame(const complex8_t* const src) {
+	/* Window, then fold (presum) the frame into fft_size points, written
+	 * straight into bit-reversed order for the FFT.
+	 * 8-bit samples * Q15 window * frame_size / fft_size folds, >> frame_shift
+	 * leaves 26 - log2(fft_size) bits: room for the FFT's growth in 32 bits.
+	 */
+	const size_t rev_shift = 32 - log_2(fft_size);
+	const int32_t round = 1 << (frame_shift - 1);
+	for(size_t k=0; k<fft_size; k++) {
+		int32_t re = 0;
+		int32_t im = 0;
+		for(size_t n=k; n<frame_size; n+=fft_size) {
+			re += src[n].real() * window[n];
+			im += src[n].imag() * window[n];
+		}
+		spectrum[__RBIT(k) >> rev_shift] = { (re + round) >> frame_shift, (im + round) >> frame_shift };
+	}
+
+	switch(fft_size) {
+	case 1024:	fft_fixed_preswapped<1024>(spectrum.data());	break;
+	case 512:	fft_fixed_preswapped<512>(spectrum.data());		break;
+	default:	fft_fixed_preswapped<256>(spectrum.data());		break;
+	}
+
+	/* Sum groups of FFT bins into the display bins, each group centered on
+	 * its display bin (DC stays in bin 0).
+	 */
+	const size_t bin_shift = log_2(fft_size / display_bins);
+	const size_t bin_center = (1U << bin_shift) >> 1;
+	for(size_t i=0; i<fft_size; i++) {
+		const float re = spectrum[i].real();
+		const float im = spectrum[i].imag();
+		power[((i + bin_center) & (fft_size - 1)) >> bin_shift] += re * re + im * im;
+	}
+	frames_count++;
+}
+
+void WidebandSpectrum::publish() {
+	if( frames_count == 0 ) {
+		return;
+	}
+
+	/* Replace the DC spike (bin 0 and dc_bins each side) by a straight line
+	 * between its neighbours.
+	 */
+	if( dc_bins ) {
+		const float left = power[display_bins - dc_bins - 1];
+		const float right = power[dc_bins + 1];
+		const size_t span = dc_bins * 2 + 2;
+		for(size_t j=1; j<span; j++) {
+			const size_t i = (display_bins - dc_bins - 1 + j) % display_bins;
+			power[i] = left + (right - left) * j / span;
+		}
+	}
+
+	ChannelSpectrum slice;
+	slice.sampling_rate = baseband_fs;
+	slice.timestamp = slice_timestamp;
+
+	/* Same display scale as SpectrumCollector: 5 units per dB, 0dBFS at 255. */
+	const float scale = power_full_scale_inv / frames_count;
+	for(size_t i=0; i<display_bins; i++) {
+		const int v = mag2_to_dbv_norm(power[i] * scale) * 5.0f + 255.0f;
+		slice.db[i] = std::max(0, std::min(255, v));
+	}
+
+	channel_spectrum.feed(slice);
+
+	std::fill(power.begin(), power.end(), 0.0f);
+	frames_count = 0;
+}
+
+void WidebandSpectrum::configure(const WidebandSpectrumConfigMessage& message) {
+	configured = false;
+
+	baseband_fs = message.sampling_rate;
+	trigger = message.trigger;
+	dc_bins = std::min(message.dc_bins, display_bins / 8);
+
+	fft_size = display_bins;
+	while( (fft_size * 2) <= std::min(message.fft_size, fft_size_max) ) {
+		fft_size *= 2;
+	}
+
+	frame_size = fft_size;
+	while( (frame_size * 2) <= std::min(fft_size * message.presum_factor, frame_size_max) ) {
+		frame_size *= 2;
+	}
+
+	/* Shortest hop within the frame rate cap. With overlap, grow the frame
+	 * (more presum) rather than the hop, so the hop stays at half a frame.
+	 * Only past frame_size_max (over 4MHz at 256 points) is the overlap lost.
+	 */
+	const size_t frames_per_second_max = fft_points_per_second_max / fft_size;
+	const size_t hop_min = (baseband_fs + frames_per_second_max - 1) / frames_per_second_max;
+	if( message.overlap ) {
+		while( ((frame_size / 2) < hop_min) && ((frame_size * 2) <= frame_size_max) ) {
+			frame_size *= 2;
+		}
+	}
+	const size_t presum_factor = frame_size / fft_size;
+	frame_shift = log_2(frame_size) - 4;
+
+	/* 4-term Blackman-Harris over the frame. When the frame is folded, also a
+	 * sinc with nulls at multiples of one bin so the resulting bins tile.
+	 */
+	float window_sum = 0.0f;
+	for(size_t n=0; n<frame_size; n++) {
+		const float x = 2.0f * pi * n / frame_size;
+		float w = 0.35875f - 0.48829f * cosf(x) + 0.14128f * cosf(2.0f * x) - 0.01168f * cosf(3.0f * x);
+		const float t = (static_cast<float>(n) - frame_size / 2) / fft_size;
+		if( (presum_factor > 1) && (t != 0.0f) ) {
+			w *= sinf(pi * t) / (pi * t);
+		}
+		window[n] = w * 32767.0f;
+		window_sum += window[n];
+	}
+
+	/* Bin power of a full-scale (128) tone through window, presum shift and FFT. */
+	const float full_scale = 128.0f * window_sum / (32768.0f * (1U << frame_shift));
+	power_full_scale_inv = 1.0f / (full_scale * full_scale);
+
+	frame_hop = message.overlap ? (frame_size / 2) : frame_size;
+	frame_hop = std::max(frame_hop, hop_min);
+	frame_offset = 0;
+	straddle_count = 0;
+
+	std::fill(power.begin(), power.end(), 0.0f);
+	frames_count = 0;
+	settle = settle_buffers;
+	phase = 0;
+
+	baseband_thread.set_sampling_rate(baseband_fs);
+	configured = true;
+}
+
 void WidebandSpectrum::on_message(const Message* const msg) {
-	const WidebandSpectrumConfigMessage message = *reinterpret_cast<const WidebandSpectrumConfigMessage*>(msg);
-	
 	switch(msg->id) {
 	case Message::ID::UpdateSpectrum:
 	case Message::ID::SpectrumStreamingConfig:
@@ -71,11 +224,7 @@ void WidebandSpectrum::on_message(const Message* const msg) {
 		break;
 		
 	case Message::ID::WidebandSpectrumConfig:
-		baseband_fs = message.sampling_rate;
-		trigger = message.trigger;
-		baseband_thread.set_sampling_rate(baseband_fs);
-		phase = 0;
-		configured = true;
+		configure(*reinterpret_cast<const WidebandSpectrumConfigMessage*>(msg));
 		break;
 
 	default:
@@ -41,6 +41,20 @@ public:
 	void on_message(const Message* const message) override;
 
 private:
+	/* Published bins, and the smallest FFT. */
+	static constexpr size_t display_bins = 256;
+	static constexpr size_t fft_size_max = 1024;
+	/* One baseband buffer. */
+	static constexpr size_t frame_size_max = 2048;
+
+	/* Buffers dropped after each (re)configuration, while the synthesizers settle. */
+	static constexpr size_t settle_buffers = 2;
+
+	/* FFT work cap (4000 256-point frames per second), keeps it to roughly
+	 * half of the M4.
+	 */
+	static constexpr size_t fft_points_per_second_max = 4000 * 256;
+
 	bool configured = false;
 	
 	size_t baseband_fs = 20000000;
@@ -50,9 +64,29 @@ private:
 
 	SpectrumCollector channel_spectrum { };
 
-	std::array<complex16_t, 256> spectrum { };
+	std::array<int16_t, frame_size_max> window { };
+	/* Frame straddling two buffers, assembled from both. */
+	std::array<complex8_t, frame_size_max> straddle { };
+	std::array<complex32_t, fft_size_max> spectrum { };
+	std::array<float, display_bins> power { };
+	float power_full_scale_inv { 1.0f };
+
+	size_t fft_size = display_bins;
+	size_t frame_size = display_bins;
+	size_t frame_shift = 4;
+	size_t frame_hop = display_bins;
+	size_t frame_offset = 0;
+	size_t straddle_count = 0;
+	size_t frames_count = 0;
+	size_t dc_bins = 2;
+	size_t settle = 0;
+	Timestamp slice_timestamp { };
 
 	size_t phase = 0, trigger = 127;
+
+	void configure(const WidebandSpectrumConfigMessage& message);
+	void process_frame(const complex8_t* const src);
+	void publish();
 };
 
 #endif/*__PROC_WIDEBAND_SPECTRUM_H__*/
@@ -22,6 +22,7 @@
 #include "spectrum_collector.hpp"
 
 #include "dsp_fft.hpp"
+#include "dsp_window.hpp"
 
 #include "utility.hpp"
 #include "event_m4.hpp"
@@ -48,12 +49,38 @@ void SpectrumCollector::on_message(const Message* const message) {
 
 void SpectrumCollector::set_state(const SpectrumStreamingConfigMessage& message) {
 	if( message.mode == SpectrumStreamingConfigMessage::Mode::Running ) {
+		set_window(message.window);
+		averaging = message.averaging;
+		averaging_shift = std::min(message.averaging_shift, SpectrumStreamingConfigMessage::averaging_shift_max);
+		averaged_count = 0;
+		averaging_primed = false;
 		start();
 	} else {
 		stop();
 	}
 }
 
+void SpectrumCollector::set_window(const SpectrumStreamingConfigMessage::Window new_window) {
+	static constexpr auto window_blackman_harris = dsp::window::blackman_harris<256>();
+	static constexpr auto window_flat_top = dsp::window::flat_top<256>();
+	static constexpr auto window_kaiser = dsp::window::kaiser<256>();
+
+	switch(new_window) {
+	case SpectrumStreamingConfigMessage::Window::BlackmanHarris:	window = &window_blackman_harris;	break;
+	case SpectrumStreamingConfigMessage::Window::FlatTop:			window = &window_flat_top;			break;
+	case SpectrumStreamingConfigMessage::Window::Kaiser:			window = &window_kaiser;			break;
+	default:														window = nullptr;					break;
+	}
+
+	/* Bring the window's coherent gain back to 0dB, in display units (5/dB, Q8). */
+	if( window ) {
+		const float gain = dsp::window::coherent_gain<256>(*window);
+		window_correction_q8 = -mag2_to_dbv_norm(gain * gain) * 5.0f * 256.0f;
+	} else {
+		window_correction_q8 = 0;
+	}
+}
+
 void SpectrumCollector::start() {
 	streaming = true;
 	ChannelSpectrumConfigMessage message { &fifo };
@@ -93,10 +120,21 @@ void SpectrumCollector::feed(
 	);
 }
 
+void SpectrumCollector::feed(const ChannelSpectrum& spectrum) {
+	// Called from baseband processing thread.
+	if( streaming ) {
+		fifo.in(spectrum);
+	}
+}
+
 void SpectrumCollector::post_message(const buffer_c16_t& data) {
 	// Called from baseband processing thread.
 	if( streaming && !channel_spectrum_request_update ) {
-		fft_swap(data, channel_spectrum);
+		if( window ) {
+			fft_swap_windowed(data, channel_spectrum, *window);
+		} else {
+			fft_swap(data, channel_spectrum);
+		}
 		channel_spectrum_sampling_rate = data.sampling_rate;
 		channel_spectrum_request_update = true;
 		EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
@@ -117,6 +155,20 @@ static typename T::value_type spectrum_window_hamming_3(const T& s, const size_t
 	return s[i] * 0.54f + (s[(i-1) & mask] + s[(i+1) & mask]) * -0.23f;
 };
 
+template<size_t N>
+static complex32_t spectrum_window_hamming_3(const std::array<complex32_t, N>& s, const size_t i) {
+	static_assert(power_of_two(N), "Array size must be power of 2");
+	constexpr size_t mask = N - 1;
+	// Three point Hamming window on fixed-point bins, 0.54 ~= 138/256, 0.23 ~= 59/256.
+	const auto a = s[i];
+	const auto b = s[(i-1) & mask];
+	const auto c = s[(i+1) & mask];
+	return {
+		static_cast<int32_t>((int64_t(a.real()) * 138 - (int64_t(b.real()) + c.real()) * 59) >> 8),
+		static_cast<int32_t>((int64_t(a.imag()) * 138 - (int64_t(b.imag()) + c.imag()) * 59) >> 8)
+	};
+};
+
 template<typename T>
 static typename T::value_type spectrum_window_blackman_3(const T& s, const size_t i) {
 	static_assert(power_of_two(s.size()), "Array size must be power of 2");
@@ -128,25 +180,58 @@ static typename T::value_type spectrum_window_blackman_3(const T& s, const size_
 	return s[i] * alpha - (s[(i-1) & mask] + s[(i+1) & mask]) * beta + (s[(i-2) & mask] + s[(i+2) & mask]) * gamma;
 };
 
+/* Bin magnitude in display units (5 per dB, 0dBFS at 255), Q8.
+ * Same scale as the old float path: 15.0515 * log2(mag2) - 196.545.
+ */
+static uint32_t spectrum_db_q8(const complex32_t bin, const int32_t correction_q8) {
+	const uint64_t mag2 = int64_t(bin.real()) * bin.real() + int64_t(bin.imag()) * bin.imag();
+	const int32_t v = ((static_cast<int32_t>(log2_q8(mag2)) * 3853) >> 8) - 50316 + correction_q8;
+	return std::max(0L, std::min(65535L, static_cast<long>(v)));
+}
+
 void SpectrumCollector::update() {
 	// Called from idle thread (after EVT_MASK_SPECTRUM is flagged)
 	if( streaming && channel_spectrum_request_update ) {
 		/* Decimated buffer is full. Compute spectrum. */
-		fft_c_preswapped(channel_spectrum, 0, 8);
-
-		ChannelSpectrum spectrum;
-		spectrum.sampling_rate = channel_spectrum_sampling_rate;
-		spectrum.channel_filter_pass_frequency = channel_filter_pass_frequency;
-		spectrum.channel_filter_stop_frequency = channel_filter_stop_frequency;
-		for(size_t i=0; i<spectrum.db.size(); i++) {
-			const auto corrected_sample = spectrum_window_hamming_3(channel_spectrum, i);
-			const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
-			const float db = mag2_to_dbv_norm(mag2);
-			constexpr float mag_scale = 5.0f;
-			const unsigned int v = (db * mag_scale) + 255.0f;
-			spectrum.db[i] = std::max(0U, std::min(255U, v));
+		fft_fixed_preswapped(channel_spectrum);
+
+		for(size_t i=0; i<averaged_db.size(); i++) {
+			const auto bin = window ? channel_spectrum[i] : spectrum_window_hamming_3(channel_spectrum, i);
+			const uint32_t v = spectrum_db_q8(bin, window_correction_q8);
+
+			switch(averaging) {
+			case SpectrumStreamingConfigMessage::Averaging::Exponential:
+				if( averaging_primed ) {
+					averaged_db[i] += (static_cast<int32_t>(v) - averaged_db[i]) >> averaging_shift;
+				} else {
+					averaged_db[i] = v;
+				}
+				break;
+
+			case SpectrumStreamingConfigMessage::Averaging::PeakHold:
+				averaged_db[i] = (averaged_count == 0) ? v : std::max<uint32_t>(averaged_db[i], v);
+				break;
+
+			default:
+				averaged_db[i] = v;
+				break;
+			}
+		}
+		averaging_primed = true;
+
+		const size_t averaging_span = (averaging == SpectrumStreamingConfigMessage::Averaging::None) ? 1 : (1U << averaging_shift);
+		if( ++averaged_count >= averaging_span ) {
+			averaged_count = 0;
+
+			ChannelSpectrum spectrum;
+			spectrum.sampling_rate = channel_spectrum_sampling_rate;
+			spectrum.channel_filter_pass_frequency = channel_filter_pass_frequency;
+			spectrum.channel_filter_stop_frequency = channel_filter_stop_frequency;
+			for(size_t i=0; i<spectrum.db.size(); i++) {
+				spectrum.db[i] = averaged_db[i] >> 8;
+			}
+			fifo.in(spectrum);
 		}
-		fifo.in(spectrum);
 	}
 
 	channel_spectrum_request_update = false;
@@ -26,6 +26,7 @@
 #include "complex.hpp"
 
 #include "block_decimator.hpp"
+#include "dsp_window.hpp"
 
 #include <cstdint>
 #include <array>
@@ -44,6 +45,9 @@ public:
 		const uint32_t filter_stop_frequency
 	);
 
+	/* For processors that compute finished spectrums themselves. */
+	void feed(const ChannelSpectrum& spectrum);
+
 private:
 	BlockDecimator<complex16_t, 256> channel_spectrum_decimator { 1 };
 	ChannelSpectrum fifo_data[1 << ChannelSpectrumConfigMessage::fifo_k] { };
@@ -51,14 +55,25 @@ private:
 
 	volatile bool channel_spectrum_request_update { false };
 	bool streaming { false };
-	std::array<std::complex<float>, 256> channel_spectrum { };
+	std::array<complex32_t, 256> channel_spectrum { };
 	uint32_t channel_spectrum_sampling_rate { 0 };
 	uint32_t channel_filter_pass_frequency { 0 };
 	uint32_t channel_filter_stop_frequency { 0 };
 
+	/* nullptr selects the frequency-domain Hamming3 window. */
+	const dsp::window::table_t<256>* window { nullptr };
+	int32_t window_correction_q8 { 0 };
+
+	SpectrumStreamingConfigMessage::Averaging averaging { SpectrumStreamingConfigMessage::Averaging::None };
+	size_t averaging_shift { 0 };
+	size_t averaged_count { 0 };
+	bool averaging_primed { false };
+	std::array<uint16_t, 256> averaged_db { };
+
 	void post_message(const buffer_c16_t& data);
 
 	void set_state(const SpectrumStreamingConfigMessage& message);
+	void set_window(const SpectrumStreamingConfigMessage::Window new_window);
 	void start();
 	void stop();
 
@@ -21,19 +21,54 @@
 
 #include "stream_input.hpp"
 
+#include <ch.h>
+
+#include <algorithm>
+
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
-StreamInput::StreamInput(CaptureConfig* const config) :
+size_t StreamInput::ring_size(const CaptureConfig* const config, const bool use_free_memory) {
+	size_t count = config->buffer_count;
+	if( use_free_memory ) {
+		// A ring freed by an earlier capture goes back on the heap's free
+		// list, not to core memory, so both count as free.
+		size_t heap_free = 0;
+		chHeapStatus(NULL, &heap_free);
+		const size_t free = chCoreStatus() + heap_free;
+		if( free > heap_reserve ) {
+			count = std::max(count, (free - heap_reserve) / config->write_size);
+		}
+	}
+	return std::min(count, buffer_count_max);
+}
+
+uint8_t* StreamInput::allocate(const CaptureConfig* const config, size_t& count) {
+	// The free total may be split between core and heap fragments, so step
+	// down until one block holds the ring. The minimum ring is required.
+	for(; count > config->buffer_count; count--) {
+		const auto p = chHeapAlloc(NULL, config->write_size * count);
+		if( p ) {
+			return static_cast<uint8_t*>(p);
+		}
+	}
+	return new uint8_t[config->write_size * count];
+}
+
+StreamInput::StreamInput(CaptureConfig* const config, const bool use_free_memory) :
 	fifo_buffers_empty { buffers_empty.data(), buffer_count_max_log2 },
 	fifo_buffers_full { buffers_full.data(), buffer_count_max_log2 },
 	config { config },
-	data { std::make_unique<uint8_t[]>(config->write_size * config->buffer_count) }
+	buffer_count { ring_size(config, use_free_memory) },
+	data { allocate(config, buffer_count) }
 {
 	config->fifo_buffers_empty = &fifo_buffers_empty;
 	config->fifo_buffers_full = &fifo_buffers_full;
+	config->buffers_allocated = buffer_count;
 
-	for(size_t i=0; i<config->buffer_count; i++) {
+	// Buffers are contiguous and queued in address order, so the application
+	// can merge runs of full buffers into a single write.
+	for(size_t i=0; i<buffer_count; i++) {
 		buffers[i] = { &(data.get()[i * config->write_size]), config->write_size };
 		fifo_buffers_empty.in(&buffers[i]);
 	}
@@ -65,12 +100,30 @@ size_t StreamInput::write(const void* const data, const size_t length) {
 				break;
 			}
 			active_buffer = nullptr;
+			config->buffers_full_max = std::max(config->buffers_full_max, fifo_buffers_full.len());
 			creg::m4txevent::assert();
 		}
 	}
 
 	config->baseband_bytes_received += length;
 	config->baseband_bytes_dropped += (length - written);
+	update_stall(length - written);
 
 	return written;
 }
+
+/* A stall is a run of writes that dropped samples, ending with the first
+ * write that fits completely.
+ */
+void StreamInput::update_stall(const size_t dropped) {
+	if( dropped ) {
+		if( stall_bytes == 0 ) {
+			config->stall_count++;
+		}
+		stall_bytes += dropped;
+		config->stall_bytes_max = std::max<uint32_t>(config->stall_bytes_max, stall_bytes);
+	} else if( stall_bytes ) {
+		config->stall_bytes_last = stall_bytes;
+		stall_bytes = 0;
+	}
+}
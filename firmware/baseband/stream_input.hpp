@@ -32,7 +32,10 @@
 
 class StreamInput {
 public:
-	StreamInput(CaptureConfig* const config);
+	/* With use_free_memory, the ring grows past config->buffer_count to fill
+	 * the free heap (less heap_reserve), up to buffer_count_max buffers.
+	 */
+	StreamInput(CaptureConfig* const config, const bool use_free_memory = false);
 
 	StreamInput(const StreamInput&) = delete;
 	StreamInput(StreamInput&&) = delete;
@@ -42,8 +45,9 @@ public:
 	size_t write(const void* const data, const size_t length);
 
 private:
-	static constexpr size_t buffer_count_max_log2 = 3;
+	static constexpr size_t buffer_count_max_log2 = 5;
 	static constexpr size_t buffer_count_max = 1U << buffer_count_max_log2;
+	static constexpr size_t heap_reserve = 4096;
 	
 	FIFO<StreamBuffer*> fifo_buffers_empty;
 	FIFO<StreamBuffer*> fifo_buffers_full;
@@ -52,7 +56,13 @@ private:
 	std::array<StreamBuffer*, buffer_count_max> buffers_full { };
 	StreamBuffer* active_buffer { nullptr };
 	CaptureConfig* const config { nullptr };
+	size_t buffer_count;
 	std::unique_ptr<uint8_t[]> data { };
+	size_t stall_bytes { 0 };
+
+	static size_t ring_size(const CaptureConfig* const config, const bool use_free_memory);
+	static uint8_t* allocate(const CaptureConfig* const config, size_t& count);
+	void update_stall(const size_t dropped);
 };
 
 #endif/*__STREAM_INPUT_H__*/
@@ -23,6 +23,10 @@
 #ifndef __ADSB_FRAME_H__
 #define __ADSB_FRAME_H__
 
+#include "crc.hpp"
+
+#include <cstdint>
+#include <cstddef>
 #include <cstring>
 #include <string>
 
@@ -31,6 +35,18 @@ namespace adsb {
 alignas(4) const uint8_t adsb_preamble[16] = { 1, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0 };
 alignas(4) const char icao_id_lut[65] = "#ABCDEFGHIJKLMNOPQRSTUVWXYZ##### ###############0123456789######";
 
+using mode_s_crc_t = TableCRC<24, 0xFFF409>;
+
+/* Mode S CRC remainder of a whole frame, parity included. Zero for a valid
+ * DF17/18 frame. The CRC is linear, so a single bit error gives the same
+ * remainder as a frame with only that bit set.
+ */
+inline uint32_t crc_residue(const uint8_t* const data, const size_t length) {
+	mode_s_crc_t crc { };
+	crc.process_bytes(data, length);
+	return crc.checksum();
+}
+
 class ADSBFrame {
 public:
 	uint8_t get_DF() {
@@ -99,26 +115,8 @@ private:
 	uint32_t rx_timestamp { };
 
 	uint32_t compute_CRC() {
-		uint8_t adsb_crc[14] = { 0 };	// Temp buffer
-		uint8_t b, c, s, bitn;
-		const uint32_t crc_poly = 0x1205FFF;
-		
-		// Copy frame data
-		memcpy(adsb_crc, raw_data, 11);
-		
-		// Compute CRC
-		for (c = 0; c < 11; c++) {
-			for (b = 0; b < 8; b++) {
-				if ((adsb_crc[c] << b) & 0x80) {
-					for (s = 0; s < 25; s++) {
-						bitn = (c * 8) + b + s;
-						if ((crc_poly >> s) & 1) adsb_crc[bitn >> 3] ^= (0x80 >> (bitn & 7));
-					}
-				}
-			}
-		}
-		
-		return (adsb_crc[11] << 16) + (adsb_crc[12] << 8) + adsb_crc[13];
+		// Parity over the first 88 bits
+		return crc_residue(raw_data, 11);
 	}
 };
 
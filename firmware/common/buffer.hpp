@@ -32,7 +32,7 @@
  * But yes, this is a hack, and something better is needed. It's too tangled of
  * a knot to tackle at the moment, though...
  */
-#if defined(LPC43XX_M4)
+#if defined(LPC43XX_M4) || defined(PORTAPACK_HOST)
 struct Timestamp {
 	uint32_t tv_date { 0 };
 	uint32_t tv_time { 0 };
@@ -26,6 +26,7 @@
 #include <cstdint>
 #include <limits>
 #include <array>
+#include <type_traits>
 
 /* Inspired by
  * http://www.barrgroup.com/Embedded-Systems/How-To/CRC-Calculation-C-Code
@@ -153,6 +154,185 @@ private:
 	}
 };
 
+/* Table-driven equivalent of CRC<>, with the polynomial fixed at compile time
+ * so the table is generated by the compiler and lives in flash.
+ *
+ * Whole bytes go through a 256-entry table. With Slices = 4 (32-bit CRCs
+ * only), aligned runs of four bytes use four tables at once (slice-by-4),
+ * at the cost of 4KB of tables. Odd bit counts fall back to bitwise updates.
+ *
+ * Reflected CRCs (RevIn and RevOut, e.g. CRC-32, X.25) keep the remainder
+ * reflected, so no reflection happens per byte or in checksum().
+ */
+template<size_t Width, uint32_t Polynomial, bool RevIn = false, bool RevOut = false, size_t Slices = 1>
+class TableCRC {
+public:
+	using value_type = uint32_t;
+
+	static_assert(Width >= 8 && Width <= 32, "TableCRC works on whole bytes");
+	static_assert(RevIn == RevOut, "TableCRC needs reflected input and output together");
+	static_assert((Slices == 1) || ((Slices == 4) && (Width == 32)), "Slice-by-4 is for 32-bit CRCs only");
+
+	constexpr TableCRC(
+		const value_type initial_remainder = 0,
+		const value_type final_xor_value = 0
+	) : initial_remainder { initial_remainder },
+		final_xor_value { final_xor_value },
+		remainder { to_register(initial_remainder) }
+	{
+	}
+
+	value_type get_initial_remainder() const {
+		return initial_remainder;
+	}
+
+	void reset(value_type new_initial_remainder) {
+		remainder = to_register(new_initial_remainder);
+	}
+
+	void reset() {
+		remainder = to_register(initial_remainder);
+	}
+
+	void process_bit(bool bit) {
+		if( RevIn ) {
+			remainder ^= (bit ? 1U : 0U);
+			remainder = (remainder & 1) ? ((remainder >> 1) ^ reflected_polynomial()) : (remainder >> 1);
+		} else {
+			remainder ^= (bit ? top_bit() : 0U);
+			remainder = (remainder & top_bit()) ? ((remainder << 1) ^ Polynomial) : (remainder << 1);
+		}
+	}
+
+	void process_bits(value_type bits, size_t bit_count) {
+		if( bit_count == 8 ) {
+			process_byte(bits);
+		} else if( RevIn ) {
+			for(size_t i=bit_count; i>0; --i, bits >>= 1) {
+				process_bit(static_cast<bool>(bits & 0x01));
+			}
+		} else {
+			for(size_t i=bit_count; i>0; --i) {
+				process_bit(static_cast<bool>((bits >> (i - 1)) & 0x01));
+			}
+		}
+	}
+
+	void process_byte(const uint8_t byte) {
+		if( RevIn ) {
+			remainder = (remainder >> 8) ^ tables[0][(remainder ^ byte) & 0xff];
+		} else {
+			remainder = ((remainder << 8) ^ tables[0][((remainder >> (Width - 8)) ^ byte) & 0xff]) & mask();
+		}
+	}
+
+	void process_bytes(const void* const data, const size_t length) {
+		const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+		const uint8_t* const end = p + length;
+
+		if constexpr( Slices == 4 ) {
+			while( (p != end) && (reinterpret_cast<uintptr_t>(p) & 3) ) {
+				process_byte(*(p++));
+			}
+			for(; (end - p) >= 4; p += 4) {
+				process_word(*reinterpret_cast<const uint32_t*>(p));
+			}
+		}
+
+		while( p != end ) {
+			process_byte(*(p++));
+		}
+	}
+
+	template<size_t N>
+	void process_bytes(const std::array<uint8_t, N>& data) {
+		process_bytes(data.data(), data.size());
+	}
+
+	value_type checksum() const {
+		return (remainder ^ final_xor_value) & mask();
+	}
+
+private:
+	using table_value_type = typename std::conditional<(Width <= 16), uint16_t, uint32_t>::type;
+	using table_t = std::array<table_value_type, 256>;
+
+	const value_type initial_remainder;
+	const value_type final_xor_value;
+	value_type remainder;
+
+	static constexpr value_type top_bit() {
+		return 1U << (Width - 1);
+	}
+
+	static constexpr value_type mask() {
+		return (Width == 32) ? 0xffffffffU : ((1U << Width) - 1);
+	}
+
+	static constexpr value_type reflect(value_type x) {
+		value_type reflection = 0;
+		for(size_t i=0; i<Width; ++i) {
+			reflection = (reflection << 1) | (x & 1);
+			x >>= 1;
+		}
+		return reflection;
+	}
+
+	static constexpr value_type reflected_polynomial() {
+		return reflect(Polynomial);
+	}
+
+	static constexpr value_type to_register(const value_type value) {
+		return RevIn ? reflect(value & mask()) : (value & mask());
+	}
+
+	static constexpr value_type next_byte(value_type r) {
+		// Remainder of one byte followed by Width zero bits
+		for(size_t i=0; i<8; i++) {
+			if( RevIn ) {
+				r = (r & 1) ? ((r >> 1) ^ reflected_polynomial()) : (r >> 1);
+			} else {
+				r = (r & top_bit()) ? ((r << 1) ^ Polynomial) : (r << 1);
+			}
+		}
+		return r & mask();
+	}
+
+	static constexpr std::array<table_t, Slices> make_tables() {
+		std::array<table_t, Slices> t { };
+		for(size_t i=0; i<256; i++) {
+			t[0][i] = next_byte(RevIn ? i : (i << (Width - 8)));
+		}
+		// Each further table advances its predecessor by one zero byte
+		for(size_t k=1; k<Slices; k++) {
+			for(size_t i=0; i<256; i++) {
+				const value_type r = t[k - 1][i];
+				t[k][i] = RevIn ?
+					((r >> 8) ^ t[0][r & 0xff]) :
+					(((r << 8) ^ t[0][r >> (Width - 8)]) & mask());
+			}
+		}
+		return t;
+	}
+
+	static constexpr std::array<table_t, Slices> tables = make_tables();
+
+	void process_word(const uint32_t word) {
+		// Words are read little-endian, byte 0 first on the wire.
+		if( RevIn ) {
+			const value_type r = remainder ^ word;
+			remainder =
+				tables[3][(r >>  0) & 0xff] ^ tables[2][(r >>  8) & 0xff] ^
+				tables[1][(r >> 16) & 0xff] ^ tables[0][(r >> 24) & 0xff];
+		} else {
+			const value_type r = remainder ^ __builtin_bswap32(word);
+			remainder =
+				tables[3][(r >> 24) & 0xff] ^ tables[2][(r >> 16) & 0xff] ^
+				tables[1][(r >>  8) & 0xff] ^ tables[0][(r >>  0) & 0xff];
+		}
+	}
+};
+
 class Adler32 {
 public:
 	void feed(const uint8_t v) {
@@ -23,14 +23,21 @@
 #ifndef __DCS_H_
 #define __DCS_H_
 
+#include <cstdint>
 #include <memory>
 
 #define DCS_CODES_NB 512
 
 namespace dcs {
 
+extern const uint16_t dcs_parity[DCS_CODES_NB];
+
 uint32_t dcs_word(uint32_t code);
 
+/* Code carried by a 23-bit word (first bit sent in bit 0), -1 if the marker
+ * or parity bits don't match. */
+int32_t dcs_code(const uint32_t word);
+
 }
 
 #endif/*__DCS_H_*/
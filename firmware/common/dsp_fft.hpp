@@ -28,10 +28,15 @@
 #include <cmath>
 #include <type_traits>
 #include <array>
+#include <utility>
 
 #include "dsp_types.hpp"
 #include "complex.hpp"
+#if defined(PORTAPACK_HOST)
+#include "simd_host.hpp"
+#else
 #include "hal.h"
+#endif
 #include "utility.hpp"
 
 namespace std {
@@ -62,6 +67,24 @@ void fft_swap(const buffer_c16_t src, std::array<T, N>& dst) {
 	}
 }
 
+/* Bit-reverse and apply a time-domain window in one pass. The window is
+ * periodic and stored as its first N/2 + 1 Q15 coefficients (see dsp_window.hpp).
+ */
+template<typename T, size_t N>
+void fft_swap_windowed(const buffer_c16_t src, std::array<T, N>& dst, const std::array<int16_t, N / 2 + 1>& window) {
+	static_assert(power_of_two(N), "only defined for N == power of two");
+
+	for(size_t i=0; i<N; i++) {
+		const size_t i_rev = __RBIT(i) >> (32 - log_2(N));
+		const int32_t w = (i <= N / 2) ? window[i] : window[N - i];
+		const auto s = src.p[i];
+		dst[i_rev] = {
+			static_cast<typename T::value_type>((s.real() * w + (1 << 14)) >> 15),
+			static_cast<typename T::value_type>((s.imag() * w + (1 << 14)) >> 15)
+		};
+	}
+}
+
 template<typename T, size_t N>
 void fft_swap(const std::array<complex16_t, N>& src, std::array<T, N>& dst) {
 	static_assert(power_of_two(N), "only defined for N == power of two");
@@ -135,4 +158,157 @@ void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to
 	}
 }
 
+/* Fixed-point FFT, radix-4 with one leading radix-2 pass when log2(N) is odd.
+ * Input is pre-swapped (bit-reversed) like fft_c_preswapped, output is in
+ * natural order, forward transform (exp(-j*2*pi*k*n/N)).
+ *
+ * T is complex16_t (Q15, scaled by 1/(2N) through the passes so it can't
+ * overflow, the extra 1/2 because a full-scale corner sample has magnitude
+ * sqrt(2)) or complex32_t (unscaled; 16-bit input grows by at most
+ * log2(N) + 1 bits, which fits for every supported N).
+ *
+ * Twiddles are Q15 and computed at compile time, so only the sizes that are
+ * actually instantiated cost any memory.
+ */
+
+namespace fft_fixed {
+
+constexpr size_t N_max = 2048;
+
+constexpr double sin_taylor(const double x) {
+	double term = x;
+	double sum = x;
+	for(size_t n=1; n<16; n++) {
+		term *= -x * x / ((2 * n) * (2 * n + 1));
+		sum += term;
+	}
+	return sum;
+}
+
+/* sin(2*pi*n/d) for 0 <= n < d, folded into [-pi/2, pi/2] for precision. */
+constexpr double sin_turns(const size_t n, const size_t d) {
+	const size_t q = (n * 4) / d;
+	const size_t r = (n * 4) % d;
+	const double x = (2.0 * 3.14159265358979323846 / 4.0) * r / d;
+	return (q == 0) ? sin_taylor(x)
+	     : (q == 1) ? sin_taylor(3.14159265358979323846 / 2.0 - x)
+	     : (q == 2) ? -sin_taylor(x)
+	     :            -sin_taylor(3.14159265358979323846 / 2.0 - x);
+}
+
+constexpr int16_t to_q15(const double v) {
+	const double scaled = v * 32767.0;
+	return static_cast<int16_t>((scaled < 0.0) ? (scaled - 0.5) : (scaled + 0.5));
+}
+
+/* W_N^n = cos(2*pi*n/N) - j*sin(2*pi*n/N) */
+template<size_t N>
+constexpr complex16_t twiddle(const size_t n) {
+	return {
+		to_q15(sin_turns((n + N / 4) % N, N)),
+		to_q15(-sin_turns(n, N))
+	};
+}
+
+template<size_t N, size_t... I>
+constexpr std::array<complex16_t, sizeof...(I)> make_twiddles(std::index_sequence<I...>) {
+	return { { twiddle<N>(I)... } };
+}
+
+/* Radix-4 passes need W^n for n < 3N/4. */
+template<size_t N>
+struct twiddles {
+	static constexpr std::array<complex16_t, N * 3 / 4> table = make_twiddles<N>(std::make_index_sequence<N * 3 / 4>());
+};
+
+template<typename T>
+using accum_t = typename std::conditional<(sizeof(typename T::value_type) > 2), int64_t, int32_t>::type;
+
+/* Samples shift down 2 bits per radix-4 pass (1 bit per radix-2 pass) if Q15,
+ * plus one more bit on the first pass.
+ */
+template<typename T>
+constexpr size_t pass_shift(const size_t radix_log2, const bool first) {
+	return (sizeof(typename T::value_type) > 2) ? 0 : (radix_log2 + (first ? 1 : 0));
+}
+
+/* Product stays in the accumulator type: a rotated Q15 sample may not fit
+ * back into 16 bits until the pass shift is applied.
+ */
+template<typename T>
+inline std::complex<accum_t<T>> mul(const T& a, const complex16_t w) {
+	using A = accum_t<T>;
+	constexpr A round = A(1) << 14;
+	const A re = A(a.real()) * w.real() - A(a.imag()) * w.imag();
+	const A im = A(a.real()) * w.imag() + A(a.imag()) * w.real();
+	return { (re + round) >> 15, (im + round) >> 15 };
+}
+
+template<typename T>
+inline T make(const accum_t<T> re, const accum_t<T> im, const size_t shift) {
+	using V = typename T::value_type;
+	return { static_cast<V>(re >> shift), static_cast<V>(im >> shift) };
+}
+
+} /* namespace fft_fixed */
+
+/* In place over data[0..N), already in bit-reversed order. */
+template<size_t N, typename T>
+void fft_fixed_preswapped(T* const data) {
+	static_assert(power_of_two(N), "only defined for N == power of two");
+	static_assert((N >= 4) && (N <= fft_fixed::N_max), "no fixed-point FFT twiddle factors for this N");
+	using namespace fft_fixed;
+	using A = accum_t<T>;
+	constexpr auto& w = twiddles<N>::table;
+
+	size_t m = 1;
+
+	if( log_2(N) & 1 ) {
+		/* Odd log2(N): one twiddle-free radix-2 pass first. */
+		constexpr size_t shift = pass_shift<T>(1, true);
+		for(size_t i=0; i<N; i+=2) {
+			const auto a = data[i + 0];
+			const auto b = data[i + 1];
+			data[i + 0] = make<T>(A(a.real()) + b.real(), A(a.imag()) + b.imag(), shift);
+			data[i + 1] = make<T>(A(a.real()) - b.real(), A(a.imag()) - b.imag(), shift);
+		}
+		m = 2;
+	}
+
+	/* Each radix-4 pass fuses two radix-2 DIT passes (spans m and 2m),
+	 * using W_4m^j, W_4m^2j, W_4m^3j == W_N^(j*N/4m) etc.
+	 */
+	for(; m<N; m*=4) {
+		const size_t shift = pass_shift<T>(2, m == 1);
+		const size_t stride = N / (m * 4);
+		for(size_t j=0; j<m; j++) {
+			const auto w1 = w[j * stride * 1];
+			const auto w2 = w[j * stride * 2];
+			const auto w3 = w[j * stride * 3];
+			for(size_t i=j; i<N; i+=m*4) {
+				const auto x0 = data[i + m * 0];
+				const auto b1 = mul(data[i + m * 1], w2);
+				const auto b2 = mul(data[i + m * 2], w1);
+				const auto b3 = mul(data[i + m * 3], w3);
+
+				const A s0r = A(x0.real()) + b1.real(), s0i = A(x0.imag()) + b1.imag();
+				const A d0r = A(x0.real()) - b1.real(), d0i = A(x0.imag()) - b1.imag();
+				const A s1r = A(b2.real()) + b3.real(), s1i = A(b2.imag()) + b3.imag();
+				const A d1r = A(b2.real()) - b3.real(), d1i = A(b2.imag()) - b3.imag();
+
+				data[i + m * 0] = make<T>(s0r + s1r, s0i + s1i, shift);
+				data[i + m * 2] = make<T>(s0r - s1r, s0i - s1i, shift);
+				/* -j * d1 == (d1i, -d1r) */
+				data[i + m * 1] = make<T>(d0r + d1i, d0i - d1r, shift);
+				data[i + m * 3] = make<T>(d0r - d1i, d0i + d1r, shift);
+			}
+		}
+	}
+}
+
+template<typename T, size_t N>
+void fft_fixed_preswapped(std::array<T, N>& data) {
+	fft_fixed_preswapped<N>(data.data());
+}
+
 #endif/*__DSP_FFT_H__*/
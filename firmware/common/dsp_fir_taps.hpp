@@ -381,4 +381,70 @@ static constexpr fir_taps_real<16> taps_200k_decim_1 = {
 	} },
 };
 
+// Capture narrow channel filter: pass=0.18*fs, stop=0.30*fs, decim=1
+constexpr fir_taps_real<32> taps_capture_narrow {
+	.pass_frequency_normalized = 0.18f,
+	.stop_frequency_normalized = 0.30f,
+	.taps = { {
+		   -49,     13,    180,      0,   -433,    -78,    858,    296,
+		 -1522,   -785,   2569,   1843,  -4485,  -4626,  10493,  28493,
+		 28493,  10493,  -4626,  -4485,   1843,   2569,   -785,  -1522,
+		   296,    858,    -78,   -433,      0,    180,     13,    -49,
+	} },
+};
+
+// IQ replay interpolation //////////////////////////////////////////////
+
+// Replay interpolator: x4, 8 taps/phase, pass=0.30*fs_in, stop=0.75*fs_in, Q14 (unity gain per phase)
+constexpr fir_taps_real<32> taps_interpolate_x4 {
+	.pass_frequency_normalized = 0.30f / 4.0f,
+	.stop_frequency_normalized = 0.75f / 4.0f,
+	.taps = { {
+		   -28,   -128,   -211,   -133,    193,    653,    889,    492,
+		  -649,  -2056,  -2705,  -1495,   2059,   7321,  12620,  15947,
+		 15947,  12620,   7321,   2059,  -1495,  -2705,  -2056,   -649,
+		   492,    889,    653,    193,   -133,   -211,   -128,    -28,
+	} },
+};
+
+// Replay interpolator: x8, 8 taps/phase, pass=0.30*fs_in, stop=0.75*fs_in, Q14 (unity gain per phase)
+constexpr fir_taps_real<64> taps_interpolate_x8 {
+	.pass_frequency_normalized = 0.30f / 8.0f,
+	.stop_frequency_normalized = 0.75f / 8.0f,
+	.taps = { {
+		   -14,    -56,   -112,   -172,   -217,   -229,   -187,    -79,
+		    95,    320,    564,    777,    903,    885,    681,    275,
+		  -315,  -1024,  -1752,  -2363,  -2705,  -2632,  -2028,   -827,
+		   968,   3276,   5938,   8738,  11419,  13719,  15402,  16291,
+		 16291,  15402,  13719,  11419,   8738,   5938,   3276,    968,
+		  -827,  -2028,  -2632,  -2705,  -2363,  -1752,  -1024,   -315,
+		   275,    681,    885,    903,    777,    564,    320,     95,
+		   -79,   -187,   -229,   -217,   -172,   -112,    -56,    -14,
+	} },
+};
+
+// Replay interpolator: x16, 8 taps/phase, pass=0.30*fs_in, stop=0.75*fs_in, Q14 (unity gain per phase)
+constexpr fir_taps_real<128> taps_interpolate_x16 {
+	.pass_frequency_normalized = 0.30f / 16.0f,
+	.stop_frequency_normalized = 0.75f / 16.0f,
+	.taps = { {
+		    -7,    -25,    -47,    -74,   -103,   -134,   -165,   -194,
+		  -217,   -233,   -239,   -232,   -210,   -172,   -116,    -43,
+		    47,    151,    267,    389,    514,    634,    742,    832,
+		   896,    927,    918,    863,    760,    605,    399,    144,
+		  -154,   -488,   -847,  -1218,  -1586,  -1934,  -2242,  -2493,
+		 -2666,  -2743,  -2707,  -2544,  -2241,  -1790,  -1187,   -433,
+		   468,   1505,   2663,   3921,   5257,   6642,   8046,   9437,
+		 10781,  12046,  13199,  14211,  15054,  15708,  16153,  16379,
+		 16379,  16153,  15708,  15054,  14211,  13199,  12046,  10781,
+		  9437,   8046,   6642,   5257,   3921,   2663,   1505,    468,
+		  -433,  -1187,  -1790,  -2241,  -2544,  -2707,  -2743,  -2666,
+		 -2493,  -2242,  -1934,  -1586,  -1218,   -847,   -488,   -154,
+		   144,    399,    605,    760,    863,    918,    927,    896,
+		   832,    742,    634,    514,    389,    267,    151,     47,
+		   -43,   -116,   -172,   -210,   -232,   -239,   -233,   -217,
+		  -194,   -165,   -134,   -103,    -74,    -47,    -25,     -7,
+	} },
+};
+
 #endif/*__DSP_FIR_TAPS_H__*/
@@ -0,0 +1,137 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_WINDOW_H__
+#define __DSP_WINDOW_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <utility>
+
+#include "dsp_fft.hpp"
+
+namespace dsp {
+namespace window {
+
+/* Time-domain FFT windows as Q15 tables, generated at compile time.
+ * Windows are periodic (DFT-even): w[n] == w[N - n], so only the first
+ * N/2 + 1 coefficients are stored. Use coefficient() to index the full span.
+ */
+
+template<size_t N>
+using table_t = std::array<int16_t, N / 2 + 1>;
+
+template<size_t N>
+constexpr int16_t coefficient(const table_t<N>& table, const size_t n) {
+	return (n <= N / 2) ? table[n] : table[N - n];
+}
+
+/* Coherent (DC) gain of a window, 1.0 for rectangular. */
+template<size_t N>
+float coherent_gain(const table_t<N>& table) {
+	int32_t sum = 0;
+	for(size_t n=0; n<N; n++) {
+		sum += coefficient<N>(table, n);
+	}
+	return static_cast<float>(sum) / (32768.0f * N);
+}
+
+namespace detail {
+
+constexpr double cos_turns(const size_t n, const size_t d) {
+	return fft_fixed::sin_turns((n + d / 4) % d, d);
+}
+
+/* Generalized cosine window, up to five terms. */
+template<size_t N>
+constexpr int16_t cosine_sum(const size_t n, const double a0, const double a1, const double a2, const double a3, const double a4) {
+	return fft_fixed::to_q15(
+		a0
+		- a1 * cos_turns((1 * n) % N, N)
+		+ a2 * cos_turns((2 * n) % N, N)
+		- a3 * cos_turns((3 * n) % N, N)
+		+ a4 * cos_turns((4 * n) % N, N)
+	);
+}
+
+constexpr double sqrt_newton(const double x) {
+	double r = (x > 1.0) ? x : 1.0;
+	for(size_t i=0; i<32; i++) {
+		r = 0.5 * (r + x / r);
+	}
+	return r;
+}
+
+/* Zeroth-order modified Bessel function of the first kind. */
+constexpr double bessel_i0(const double x) {
+	double term = 1.0;
+	double sum = 1.0;
+	for(size_t k=1; k<32; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+template<size_t N>
+constexpr int16_t kaiser(const size_t n, const double beta) {
+	const double r = (2.0 * n) / N - 1.0;
+	return fft_fixed::to_q15(bessel_i0(beta * sqrt_newton(1.0 - r * r)) / bessel_i0(beta));
+}
+
+template<size_t N, size_t... I>
+constexpr table_t<N> blackman_harris(std::index_sequence<I...>) {
+	return { { cosine_sum<N>(I, 0.35875, 0.48829, 0.14128, 0.01168, 0.0)... } };
+}
+
+template<size_t N, size_t... I>
+constexpr table_t<N> flat_top(std::index_sequence<I...>) {
+	return { { cosine_sum<N>(I, 0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368)... } };
+}
+
+template<size_t N, size_t... I>
+constexpr table_t<N> kaiser(std::index_sequence<I...>, const double beta) {
+	return { { kaiser<N>(I, beta)... } };
+}
+
+} /* namespace detail */
+
+/* 4-term Blackman-Harris: -92dB sidelobes, best for dynamic range. */
+template<size_t N>
+constexpr table_t<N> blackman_harris() {
+	return detail::blackman_harris<N>(std::make_index_sequence<N / 2 + 1>());
+}
+
+/* Flat-top: < 0.01dB scalloping, for reading carrier amplitudes. */
+template<size_t N>
+constexpr table_t<N> flat_top() {
+	return detail::flat_top<N>(std::make_index_sequence<N / 2 + 1>());
+}
+
+/* Kaiser, beta = 6: narrower main lobe than Blackman-Harris, -44dB sidelobes. */
+template<size_t N>
+constexpr table_t<N> kaiser() {
+	return detail::kaiser<N>(std::make_index_sequence<N / 2 + 1>(), 6.0);
+}
+
+} /* namespace window */
+} /* namespace dsp */
+
+#endif/*__DSP_WINDOW_H__*/
@@ -316,6 +316,18 @@ void ILI9341::render_box(const ui::Point p, const ui::Size s, const ui::Color* l
 	io.lcd_write_pixels(line_buffer, s.width() * s.height());
 }
 
+void ILI9341::start_pixels(const ui::Rect r) {
+	lcd_start_ram_write(r);
+}
+
+void ILI9341::stream_pixels(const ui::Color* const colors, const size_t count) {
+	io.lcd_write_pixels(colors, count);
+}
+
+void ILI9341::stream_pixels(const ui::Color color, const size_t count) {
+	io.lcd_write_pixels(color, count);
+}
+
 // RLE_4 BMP loader (delta not implemented)
 void ILI9341::drawBMP(const ui::Point p, const uint8_t * bitmap, const bool transparency) {
 	const bmp_header_t * bmp_header = (const bmp_header_t *)bitmap;
@@ -496,11 +508,7 @@ void ILI9341::draw_bitmap(
 ) {
 	lcd_start_ram_write(p, size);
 
-	const size_t count = size.width() * size.height();
-	for(size_t i=0; i<count; i++) {
-		const auto pixel = pixels[i >> 3] & (1U << (i & 0x7));
-		io.lcd_write_pixel(pixel ? foreground : background);
-	}
+	io.lcd_write_bitmap(pixels, size.width() * size.height(), foreground, background);
 }
 
 void ILI9341::draw_glyph(
@@ -62,6 +62,14 @@ public:
 	void drawBMP(const ui::Point p, const uint8_t * bitmap, const bool transparency);
 	void render_line(const ui::Point p, const uint8_t count, const ui::Color* line_buffer);
 	void render_box(const ui::Point p, const ui::Size s, const ui::Color* line_buffer);
+
+	/* Opens r for writing, the pixels then follow in any number of
+	 * stream_pixels() calls. For sources that produce a rectangle piece by
+	 * piece, such as run-length data.
+	 */
+	void start_pixels(const ui::Rect r);
+	void stream_pixels(const ui::Color* const colors, const size_t count);
+	void stream_pixels(const ui::Color color, const size_t count);
 	
 	template<size_t N>
 	void draw_pixels(
@@ -79,6 +87,9 @@ public:
 		read_pixels(r, colors.data(), colors.size());
 	}
 
+	/* Reads count pixels, which must not exceed the area of r. */
+	void read_pixels(const ui::Rect r, ui::ColorRGB888* const colors, const size_t count);
+
 	void draw_bitmap(
 		const ui::Point p,
 		const ui::Size size,
@@ -115,7 +126,6 @@ private:
 	scroll_t scroll_state;
 
 	void draw_pixels(const ui::Rect r, const ui::Color* const colors, const size_t count);
-	void read_pixels(const ui::Rect r, ui::ColorRGB888* const colors, const size_t count);
 };
 
 } /* namespace lcd */
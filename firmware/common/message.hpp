@@ -111,6 +111,12 @@ public:
 		AudioLevelReport = 51,
 		CodedSquelch = 52,
 		AudioSpectrum = 53,
+		ChannelStatsConfig = 54,
+		CaptureChainConfig = 55,
+		BTLEPacket = 56,
+		NRFPacket = 57,
+		AX25Packet = 58,
+		CodedSquelchReset = 59,
 		MAX
 	};
 
@@ -165,12 +171,15 @@ public:
 struct ChannelStatistics {
 	int32_t max_db;
 	size_t count;
+	uint32_t epoch;		// From the last ChannelStatsConfigMessage, so stale updates can be told apart.
 
 	constexpr ChannelStatistics(
 		int32_t max_db = -120,
-		size_t count = 0
+		size_t count = 0,
+		uint32_t epoch = 0
 	) : max_db { max_db },
-		count { count }
+		count { count },
+		epoch { epoch }
 	{
 	}
 };
@@ -187,6 +196,23 @@ public:
 	ChannelStatistics statistics;
 };
 
+class ChannelStatsConfigMessage : public Message {
+public:
+	static constexpr uint32_t update_interval_default_ms = 100;
+
+	constexpr ChannelStatsConfigMessage(
+		const uint32_t epoch,
+		const uint32_t update_interval_ms = update_interval_default_ms
+	) : Message { ID::ChannelStatsConfig },
+		epoch { epoch },
+		update_interval_ms { update_interval_ms }
+	{
+	}
+
+	const uint32_t epoch;
+	const uint32_t update_interval_ms;
+};
+
 class DisplayFrameSyncMessage : public Message {
 public:
 	constexpr DisplayFrameSyncMessage(
@@ -253,29 +279,83 @@ public:
 		Running = 1,
 	};
 
+	/* Hamming3 is the original frequency-domain 3-point window, the others
+	 * are applied to the samples before the FFT.
+	 */
+	enum class Window : uint8_t {
+		Hamming3 = 0,
+		BlackmanHarris = 1,
+		FlatTop = 2,
+		Kaiser = 3,
+	};
+
+	/* Averaging is done on the M4 over 2^averaging_shift spectrums, and only
+	 * one ChannelSpectrum per 2^averaging_shift is pushed to the M0.
+	 * PeakHold keeps the maximum of each bin over that span.
+	 */
+	enum class Averaging : uint8_t {
+		None = 0,
+		Exponential = 1,
+		PeakHold = 2,
+	};
+
+	static constexpr uint8_t averaging_shift_max = 5;
+
 	constexpr SpectrumStreamingConfigMessage(
-		Mode mode
+		Mode mode,
+		Window window = Window::Hamming3,
+		Averaging averaging = Averaging::None,
+		uint8_t averaging_shift = 0
 	) : Message { ID::SpectrumStreamingConfig },
-		mode { mode }
+		mode { mode },
+		window { window },
+		averaging { averaging },
+		averaging_shift { averaging_shift }
 	{
 	}
 
 	Mode mode { Mode::Stopped };
+	Window window { Window::Hamming3 };
+	Averaging averaging { Averaging::None };
+	uint8_t averaging_shift { 0 };
 };
 
 class WidebandSpectrumConfigMessage : public Message {
 public:
+	/* trigger: number of baseband buffers (minus one) averaged per slice.
+	 * presum_factor: FFT frame length in fft_size blocks (1, 2, 4 or 8, up to
+	 *   2048 samples). Longer frames are windowed and folded into the FFT
+	 *   (polyphase presum), giving flatter, steeper bins. The frame may be made
+	 *   longer than asked to keep the overlap within the frame rate cap.
+	 * overlap: advance frames by half their length instead of a full length.
+	 * dc_bins: display bins each side of DC replaced by interpolation of their
+	 *   neighbours.
+	 * fft_size: 256, 512 or 1024 points. Always published as 256 bins, each the
+	 *   power sum of fft_size / 256 FFT bins.
+	 */
 	constexpr WidebandSpectrumConfigMessage (
 		size_t sampling_rate,
-		size_t trigger
+		size_t trigger,
+		size_t presum_factor = 1,
+		bool overlap = true,
+		size_t dc_bins = 2,
+		size_t fft_size = 256
 	) : Message { ID::WidebandSpectrumConfig },
 		sampling_rate { sampling_rate },
-		trigger { trigger }
+		trigger { trigger },
+		presum_factor { presum_factor },
+		overlap { overlap },
+		dc_bins { dc_bins },
+		fft_size { fft_size }
 	{
 	}
 
 	size_t sampling_rate { 0 };
 	size_t trigger { 0 };
+	size_t presum_factor { 1 };
+	bool overlap { true };
+	size_t dc_bins { 2 };
+	size_t fft_size { 256 };
 };
 
 struct AudioSpectrum {
@@ -300,6 +380,7 @@ struct ChannelSpectrum {
 	uint32_t sampling_rate { 0 };
 	uint32_t channel_filter_pass_frequency { 0 };
 	uint32_t channel_filter_stop_frequency { 0 };
+	Timestamp timestamp { };	// Start of the samples integrated, set by the wideband sweep only.
 };
 
 using ChannelSpectrumFIFO = FIFO<ChannelSpectrum>;
@@ -396,16 +477,59 @@ public:
 	uint32_t value;
 };
 
+/* An AX.25 frame that passed its FCS, flags and FCS removed. */
+class AX25PacketMessage : public Message {
+public:
+	static constexpr size_t frame_size_max = 10 * 7 + 2 + 256;
+
+	constexpr AX25PacketMessage(
+	) : Message { ID::AX25Packet }
+	{
+	}
+
+	uint16_t length { 0 };
+	std::array<uint8_t, frame_size_max> frame { };
+};
+
+/* Sent while a tone or code is held, and once with Type::None when it's lost.
+ * CTCSS values are in 1/100 Hz, DCS values are the 9-bit code (octal digits).
+ */
 class CodedSquelchMessage : public Message {
 public:
+	enum class Type : uint8_t {
+		None = 0,
+		CTCSS = 1,
+		DCS = 2,
+		DCSInverted = 3,
+	};
+
 	constexpr CodedSquelchMessage(
-		const uint32_t value
+		const Type type = Type::None,
+		const uint32_t value = 0,
+		const uint32_t epoch = 0
 	) : Message { ID::CodedSquelch },
-		value { value }
+		type { type },
+		value { value },
+		epoch { epoch }
 	{
 	}
 	
+	Type type;
 	uint32_t value;
+	uint32_t epoch;		// From the last CodedSquelchResetMessage
+};
+
+/* Forgets any tone, code or partial vote, e.g. after a retune. */
+class CodedSquelchResetMessage : public Message {
+public:
+	constexpr CodedSquelchResetMessage(
+		const uint32_t epoch
+	) : Message { ID::CodedSquelchReset },
+		epoch { epoch }
+	{
+	}
+
+	const uint32_t epoch;
 };
 
 class ShutdownMessage : public Message {
@@ -620,20 +744,41 @@ public:
 };
 
 struct CaptureConfig {
+	enum class Format : uint32_t {
+		C16 = 0,
+		C8 = 1,
+	};
+
 	const size_t write_size;
-	const size_t buffer_count;
+	const size_t buffer_count;		// Minimum, the baseband may allocate more
+	const Format format;			// IQ sample format written by the capture processor
+	uint32_t sampling_rate;			// Achieved output rate, filled in by the baseband
 	uint64_t baseband_bytes_received;
 	uint64_t baseband_bytes_dropped;
+	// Filled in by the baseband
+	size_t buffers_allocated;
+	size_t buffers_full_max;		// High-water mark of buffers waiting for the application
+	uint32_t stall_count;			// Runs of consecutive dropped writes
+	uint32_t stall_bytes_last;
+	uint32_t stall_bytes_max;
 	FIFO<StreamBuffer*>* fifo_buffers_empty;
 	FIFO<StreamBuffer*>* fifo_buffers_full;
 
 	constexpr CaptureConfig(
 		const size_t write_size,
-		const size_t buffer_count
+		const size_t buffer_count,
+		const Format format = Format::C16
 	) : write_size { write_size },
 		buffer_count { buffer_count },
+		format { format },
+		sampling_rate { 0 },
 		baseband_bytes_received { 0 },
 		baseband_bytes_dropped { 0 },
+		buffers_allocated { 0 },
+		buffers_full_max { 0 },
+		stall_count { 0 },
+		stall_bytes_last { 0 },
+		stall_bytes_max { 0 },
 		fifo_buffers_empty { nullptr },
 		fifo_buffers_full { nullptr }
 	{
@@ -661,18 +806,36 @@ public:
 	CaptureConfig* const config;
 };
 
+class CaptureChainConfigMessage : public Message {
+public:
+	constexpr CaptureChainConfigMessage(
+		const size_t decimation,
+		const bool narrow_filter
+	) : Message { ID::CaptureChainConfig },
+		decimation { decimation },
+		narrow_filter { narrow_filter }
+	{
+	}
+
+	const size_t decimation;		// Baseband rate / output rate: 2, 4 or 8
+	const bool narrow_filter;		// Extra channel filter, passband 0.18 of the output rate
+};
+
 struct ReplayConfig {
 	const size_t read_size;
 	const size_t buffer_count;
+	const size_t interpolation;		// Baseband rate / file rate, used by the IQ replay processor
 	uint64_t baseband_bytes_received;
 	FIFO<StreamBuffer*>* fifo_buffers_empty;
 	FIFO<StreamBuffer*>* fifo_buffers_full;
 
 	constexpr ReplayConfig(
 		const size_t read_size,
-		const size_t buffer_count
+		const size_t buffer_count,
+		const size_t interpolation = 8
 	) : read_size { read_size },
 		buffer_count { buffer_count },
+		interpolation { interpolation },
 		baseband_bytes_received { 0 },
 		fifo_buffers_empty { nullptr },
 		fifo_buffers_full { nullptr }
@@ -703,6 +866,10 @@ public:
 	bool done = false;
 };
 
+/* trigger_word selects the continuous AX.25 mode, which sends one
+ * AX25PacketMessage per good frame. Otherwise words of word_length bits are
+ * framed by start and stop bits, one AFSKDataMessage each.
+ */
 class AFSKRxConfigureMessage : public Message {
 public:
 	constexpr AFSKRxConfigureMessage(
@@ -730,18 +897,38 @@ public:
 		const uint32_t baudrate,
 		const uint32_t word_length,
 		const uint32_t trigger_value,
-		const bool trigger_word
+		const bool trigger_word,
+		const uint8_t channel_number = 37
 	) : Message { ID::BTLERxConfigure },
 		baudrate(baudrate),
 		word_length(word_length),
 		trigger_value(trigger_value),
-		trigger_word(trigger_word)
+		trigger_word(trigger_word),
+		channel_number(channel_number)
 	{
     }
 	const uint32_t baudrate;
 	const uint32_t word_length;
 	const uint32_t trigger_value;
 	const bool trigger_word;
+	const uint8_t channel_number;	// BLE channel index, seeds the dewhitening
+};
+
+/* A BLE advertising channel PDU that passed its CRC: 2 byte header, then
+ * up to 37 bytes of payload (AdvA first, little-endian).
+ */
+class BTLEPacketMessage : public Message {
+public:
+	static constexpr size_t pdu_size_max = 2 + 37;
+
+	constexpr BTLEPacketMessage(
+	) : Message { ID::BTLEPacket }
+	{
+	}
+
+	uint8_t channel_number { 0 };
+	uint8_t length { 0 };			// Header + payload bytes
+	std::array<uint8_t, pdu_size_max> pdu { };
 };
 
 class NRFRxConfigureMessage : public Message {
@@ -750,18 +937,37 @@ public:
 		const uint32_t baudrate,
 		const uint32_t word_length,
 		const uint32_t trigger_value,
-		const bool trigger_word
+		const bool trigger_word,
+		const uint64_t address = 0xE7E7E7E7E7
 	) : Message { ID::NRFRxConfigure },
 		baudrate(baudrate),
 		word_length(word_length),
 		trigger_value(trigger_value),
-		trigger_word(trigger_word)
+		trigger_word(trigger_word),
+		address(address)
 	{
     }
-	const uint32_t baudrate;
+	const uint32_t baudrate;		// 250000, 1000000 or 2000000
 	const uint32_t word_length;
 	const uint32_t trigger_value;
 	const bool trigger_word;
+	const uint64_t address;			// 5 byte pipe address
+};
+
+/* An nRF24 Enhanced ShockBurst packet that passed its CRC16. */
+class NRFPacketMessage : public Message {
+public:
+	static constexpr size_t payload_size_max = 32;
+
+	constexpr NRFPacketMessage(
+	) : Message { ID::NRFPacket }
+	{
+	}
+
+	uint64_t address { 0 };
+	uint8_t length { 0 };
+	uint8_t pid { 0 };
+	std::array<uint8_t, payload_size_max> payload { };
 };
 
 class PitchRSSIConfigureMessage : public Message {
@@ -855,13 +1061,15 @@ public:
 		const float deviation_hz,
 		const float audio_gain,
 		const uint32_t tone_key_delta,
-		const float tone_key_mix_weight
+		const float tone_key_mix_weight,
+		const uint32_t bits_per_sample
 	) : Message { ID::AudioTXConfig },
 		divider(divider),
 		deviation_hz(deviation_hz),
 		audio_gain(audio_gain),
 		tone_key_delta(tone_key_delta),
-		tone_key_mix_weight(tone_key_mix_weight)
+		tone_key_mix_weight(tone_key_mix_weight),
+		bits_per_sample(bits_per_sample)
 	{
 	}
 
@@ -870,6 +1078,7 @@ public:
 	const float audio_gain;
 	const uint32_t tone_key_delta;
 	const float tone_key_mix_weight;
+	const uint32_t bits_per_sample;
 };
 
 class SigGenConfigMessage : public Message {
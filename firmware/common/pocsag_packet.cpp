@@ -24,4 +24,72 @@
 
 namespace pocsag {
 
+namespace {
+
+// g(x) = x^10 + x^9 + x^8 + x^6 + x^5 + x^3 + 1
+constexpr uint32_t bch_generator = 0x769;
+
+/* Remainder of the 31-bit code word (parity bit shifted out) by g(x). */
+constexpr uint32_t bch_syndrome(const uint32_t word) {
+	uint32_t r = word;
+	for (int32_t b = 30; b >= 10; b--) {
+		if (r & (1U << b))
+			r ^= bch_generator << (b - 10);
+	}
+	return r;
+}
+
+/* Syndrome -> error positions (in the 32-bit codeword, plus one), packed as
+ * two 6 bit fields. Zero means no error, or too many to correct.
+ */
+struct SyndromeTable {
+	uint16_t entries[1024] { };
+	
+	constexpr SyndromeTable() {
+		for (uint32_t i = 0; i < 31; i++) {
+			entries[bch_syndrome(1U << i)] = i + 2;
+			for (uint32_t j = i + 1; j < 31; j++)
+				entries[bch_syndrome((1U << i) | (1U << j))] = (i + 2) | ((j + 2) << 6);
+		}
+	}
+};
+
+constexpr SyndromeTable syndrome_table { };
+
+bool even_parity(const uint32_t codeword) {
+	return (__builtin_popcount(codeword) & 1) == 0;
+}
+
+} /* namespace */
+
+int32_t bch_repair(uint32_t& codeword) {
+	const uint32_t syndrome = bch_syndrome(codeword >> 1);
+	uint32_t repaired = codeword;
+	int32_t bits_fixed = 0;
+	
+	if (syndrome) {
+		const uint32_t entry = syndrome_table.entries[syndrome];
+		if (!entry)
+			return -1;
+		
+		repaired ^= 1U << ((entry & 63) - 1);
+		bits_fixed++;
+		if (entry >> 6) {
+			repaired ^= 1U << ((entry >> 6) - 1);
+			bits_fixed++;
+		}
+	}
+	
+	if (!even_parity(repaired)) {
+		// The parity bit itself, unless the budget is spent
+		if (bits_fixed == 2)
+			return -1;
+		repaired ^= 1;
+		bits_fixed++;
+	}
+	
+	codeword = repaired;
+	return bits_fixed;
+}
+
 } /* namespace pocsag */
@@ -28,6 +28,8 @@
 
 #include "baseband.hpp"
 
+#include <array>
+
 namespace pocsag {
 
 enum BitRate : uint32_t {
@@ -43,6 +45,12 @@ enum PacketFlag : uint32_t {
 	TOO_LONG
 };
 
+/* Checks a codeword (21 data bits, BCH(31,21) check bits, even parity) and
+ * fixes up to 2 bit errors in place. Returns the number of bits fixed, or -1
+ * if the codeword can't be corrected (then it is left untouched).
+ */
+int32_t bch_repair(uint32_t& codeword);
+
 class POCSAGPacket {
 public:
 	void set_timestamp(const Timestamp& value) {
@@ -77,16 +85,36 @@ public:
 	PacketFlag flag() const {
 		return flag_;
 	}
+	
+	// Codewords repaired by bch_repair(), and codewords beyond repair
+	void count_errors(const int32_t bits_fixed) {
+		if (bits_fixed > 0)
+			corrected_++;
+		else if (bits_fixed < 0)
+			uncorrectable_++;
+	}
+	
+	uint8_t corrected() const {
+		return corrected_;
+	}
+	
+	uint8_t uncorrectable() const {
+		return uncorrectable_;
+	}
 
 	void clear() {
 		codewords.fill(0);
 		bitrate_ = UNKNOWN;
 		flag_ = NORMAL;
+		corrected_ = 0;
+		uncorrectable_ = 0;
 	}
 
 private:
 	BitRate bitrate_ { UNKNOWN };
 	PacketFlag flag_ { NORMAL };
+	uint8_t corrected_ { 0 };
+	uint8_t uncorrectable_ { 0 };
 	std::array <uint32_t, 16> codewords;
 	Timestamp timestamp_ { };
 };
@@ -29,6 +29,7 @@ using namespace lpc43xx;
 #include <ch.h>
 
 #include <cstdint>
+#include <algorithm>
 
 namespace portapack {
 
@@ -75,6 +76,81 @@ void IO::reference_oscillator(const bool enable) {
 	io_write(1, io_reg);
 }
 
+void IO::lcd_write_pixels(const ui::Color pixel, size_t n) {
+	// NOTE: Assumes DIR=0 and ADDR=1 from command phase.
+	const auto bus = lcd_write_bus();
+	const uint32_t v = pixel.v;
+
+	if( (v >> 8) == (v & 0xff) ) {
+		/* Black, white and greys: both bytes are the same, so the bus
+		 * holds its value and only WR toggles.
+		 */
+		*bus.data = v;
+		while(n >= 4) {
+			bus.strobe();
+			bus.strobe();
+			bus.strobe();
+			bus.strobe();
+			n -= 4;
+		}
+		while(n--) {
+			bus.strobe();
+		}
+	} else {
+		while(n >= 4) {
+			bus.write(v);
+			bus.write(v);
+			bus.write(v);
+			bus.write(v);
+			n -= 4;
+		}
+		while(n--) {
+			bus.write(v);
+		}
+	}
+}
+
+void IO::lcd_write_pixels_unrolled8(const ui::Color pixel, size_t n) {
+	lcd_write_pixels(pixel, n & ~7U);
+}
+
+void IO::lcd_write_pixels(const ui::Color* const pixels, size_t n) {
+	const auto bus = lcd_write_bus();
+	auto p = pixels;
+
+	while(n >= 4) {
+		bus.write(p[0].v);
+		bus.write(p[1].v);
+		bus.write(p[2].v);
+		bus.write(p[3].v);
+		p += 4;
+		n -= 4;
+	}
+	while(n--) {
+		bus.write((p++)->v);
+	}
+}
+
+void IO::lcd_write_bitmap(
+	const uint8_t* const bits,
+	const size_t n,
+	const ui::Color foreground,
+	const ui::Color background
+) {
+	const auto bus = lcd_write_bus();
+	const uint32_t fg = foreground.v;
+	const uint32_t bg = background.v;
+
+	for(size_t i=0; i<n; i+=8) {
+		uint32_t b = bits[i >> 3];
+		const size_t count = std::min(n - i, size_t(8));
+		for(size_t j=0; j<count; j++) {
+			bus.write((b & 1) ? fg : bg);
+			b >>= 1;
+		}
+	}
+}
+
 uint32_t IO::io_update(const TouchPinsConfig write_value) {
 	/* Very touchy code to save context of PortaPack data bus while the
 	 * resistive touch pin drive is changed. Order of operations is
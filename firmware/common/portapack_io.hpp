@@ -153,32 +153,20 @@ public:
 		return lcd_read_data();
 	}
 
-	void lcd_write_pixels(const ui::Color pixel, size_t n) {
-		while(n--) {
-			lcd_write_data(pixel.v);
-		}
-	}
-
-	void lcd_write_pixels_unrolled8(const ui::Color pixel, size_t n) {
-		auto v = pixel.v;
-		n >>= 3;
-		while(n--) {
-			lcd_write_data(v);
-			lcd_write_data(v);
-			lcd_write_data(v);
-			lcd_write_data(v);
-			lcd_write_data(v);
-			lcd_write_data(v);
-			lcd_write_data(v);
-			lcd_write_data(v);
-		}
-	}
-	
-	void lcd_write_pixels(const ui::Color* const pixels, size_t n) {
-		for(size_t i=0; i<n; i++) {
-			lcd_write_pixel(pixels[i]);
-		}
-	}
+	/* Bulk pixel writes. These keep the bus registers in hand for the whole
+	 * run instead of looking them up for every strobe.
+	 */
+	void lcd_write_pixels(const ui::Color pixel, size_t n);
+	void lcd_write_pixels_unrolled8(const ui::Color pixel, size_t n);
+	void lcd_write_pixels(const ui::Color* const pixels, size_t n);
+
+	/* 1bpp bitmap, LSB first, as used by glyphs. */
+	void lcd_write_bitmap(
+		const uint8_t* const bits,
+		const size_t n,
+		const ui::Color foreground,
+		const ui::Color background
+	);
 
 	void lcd_read_bytes(uint8_t* byte, size_t byte_count) {
 		size_t word_count = byte_count / 2;
@@ -314,6 +302,51 @@ private:
 		addr(1);				/* Set up for data phase (most likely after a command) */
 	}
 
+	/* LCD data write cycle with the GPIO registers resolved up front. Same
+	 * timing as lcd_write_data().
+	 */
+	struct LCDWriteBus {
+		volatile uint32_t* const data;
+		volatile uint32_t* const wr_clear;
+		volatile uint32_t* const wr_set;
+		const uint32_t wr_mask;
+
+		void write(const uint32_t value) const __attribute__((always_inline)) {
+			*data = value;							/* Drive high byte */
+			__asm__("nop");
+			*wr_clear = wr_mask;					/* Latch high byte */
+
+			*data = value << gpio_data_shift;		/* Drive low byte (pass-through) */
+			__asm__("nop");
+			__asm__("nop");
+			__asm__("nop");
+			*wr_set = wr_mask;						/* Complete write operation */
+		}
+
+		/* For words whose two bytes are equal: the bus is driven once and
+		 * only WR is strobed.
+		 */
+		void strobe() const __attribute__((always_inline)) {
+			*wr_clear = wr_mask;
+			__asm__("nop");
+			__asm__("nop");
+			__asm__("nop");
+			__asm__("nop");
+			*wr_set = wr_mask;
+			__asm__("nop");
+			__asm__("nop");
+		}
+	};
+
+	LCDWriteBus lcd_write_bus() const {
+		return {
+			&LPC_GPIO->MPIN[gpio_data_port_id],
+			&LPC_GPIO->CLR[gpio_lcd_wrx.port()],
+			&LPC_GPIO->SET[gpio_lcd_wrx.port()],
+			1U << gpio_lcd_wrx.pad()
+		};
+	}
+
 	void lcd_write_data(const uint32_t value) __attribute__((always_inline)) {
 		// NOTE: Assumes and DIR=0 and ADDR=1 from command phase.
 		data_write_high(value);	/* Drive high byte */
@@ -91,6 +91,9 @@ struct data_t {
 	uint32_t pocsag_ignore_address;
 	
 	int32_t tone_mix;
+
+	// Waterfall: window (bits 0-1), averaging (bits 2-3), averaging shift (bits 4-6)
+	uint32_t spectrum_config;
 };
 
 static_assert(sizeof(data_t) <= backup_ram.size(), "Persistent memory structure too large for VBAT-maintained region");
@@ -140,6 +143,22 @@ void set_tone_mix(const int32_t new_value) {
 	data->tone_mix = tone_mix_range.clip(new_value);
 }
 
+uint8_t spectrum_window() {
+	return data->spectrum_config & 0x3;
+}
+
+uint8_t spectrum_averaging() {
+	return (data->spectrum_config >> 2) & 0x3;
+}
+
+uint8_t spectrum_averaging_shift() {
+	return (data->spectrum_config >> 4) & 0x7;
+}
+
+void set_spectrum_config(const uint8_t window, const uint8_t averaging, const uint8_t averaging_shift) {
+	data->spectrum_config = (window & 0x3) | ((averaging & 0x3) << 2) | ((averaging_shift & 0x7) << 4);
+}
+
 int32_t afsk_mark_freq() {
 	afsk_freq_range.reset_if_outside(data->afsk_mark_freq, afsk_mark_reset_value);
 	return data->afsk_mark_freq;
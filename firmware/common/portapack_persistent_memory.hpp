@@ -53,6 +53,14 @@ void set_serial_format(const serial_format_t new_value);
 int32_t tone_mix();
 void set_tone_mix(const int32_t new_value);
 
+/* Values of SpectrumStreamingConfigMessage::Window and ::Averaging. The
+ * baseband treats out of range values as the defaults.
+ */
+uint8_t spectrum_window();
+uint8_t spectrum_averaging();
+uint8_t spectrum_averaging_shift();
+void set_spectrum_config(const uint8_t window, const uint8_t averaging, const uint8_t averaging_shift);
+
 int32_t afsk_mark_freq();
 void set_afsk_mark(const int32_t new_value);
 
@@ -22,9 +22,13 @@
 #ifndef __SIMD_H__
 #define __SIMD_H__
 
-#if defined(LPC43XX_M4)
+#if defined(LPC43XX_M4) || defined(PORTAPACK_HOST)
 
+#if defined(LPC43XX_M4)
 #include <hal.h>
+#else
+#include "simd_host.hpp"
+#endif
 
 #include <cstdint>
 
@@ -109,6 +113,6 @@ static inline int32_t smlad(const vec2_s16 v1, const vec2_s16 v2, const int32_t
 	return __SMLAD(v1.w, v2.w, accum);
 }
 
-#endif /* defined(LPC43XX_M4) */
+#endif /* defined(LPC43XX_M4) || defined(PORTAPACK_HOST) */
 
 #endif/*__SIMD_H__*/
@@ -0,0 +1,217 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SIMD_HOST_H__
+#define __SIMD_HOST_H__
+
+/* Portable C++ versions of the Cortex-M4 DSP intrinsics used by the baseband
+ * kernels, so dsp_decimate, dsp_demodulate and friends can be compiled and
+ * checked on a PC (define PORTAPACK_HOST).
+ *
+ * Results must stay bit-exact with the instructions, including the extra
+ * ROR arguments added by lpc43xx_m4.h. Nothing here is tuned for speed.
+ */
+
+#if defined(PORTAPACK_HOST)
+
+#include <cstdint>
+#include <cstddef>
+
+#define __SIMD32_TYPE int32_t
+#define __SIMD32(addr)  (*(__SIMD32_TYPE **) & (addr))
+#define _SIMD32_OFFSET(addr) (*(__SIMD32_TYPE *) (addr))
+
+namespace simd_host {
+
+static inline uint32_t ror(const uint32_t v, const uint32_t n) {
+	return (n & 31) ? ((v >> (n & 31)) | (v << (32 - (n & 31)))) : v;
+}
+
+static inline int32_t lo(const uint32_t v) {
+	return static_cast<int16_t>(v & 0xffff);
+}
+
+static inline int32_t hi(const uint32_t v) {
+	return static_cast<int16_t>(v >> 16);
+}
+
+static inline uint32_t pack(const int32_t l, const int32_t h) {
+	return (static_cast<uint32_t>(l) & 0xffff) | (static_cast<uint32_t>(h) << 16);
+}
+
+static inline int32_t sat(const int64_t v, const int32_t bits) {
+	const int64_t max = (int64_t(1) << (bits - 1)) - 1;
+	const int64_t min = -(int64_t(1) << (bits - 1));
+	return static_cast<int32_t>((v > max) ? max : ((v < min) ? min : v));
+}
+
+} /* namespace simd_host */
+
+static inline uint32_t __REV16(const uint32_t v) {
+	return ((v & 0xff00ff00) >> 8) | ((v & 0x00ff00ff) << 8);
+}
+
+static inline uint32_t __RBIT(uint32_t v) {
+	uint32_t result = 0;
+	for(size_t i=0; i<32; i++) {
+		result = (result << 1) | (v & 1);
+		v >>= 1;
+	}
+	return result;
+}
+
+static inline uint8_t __CLZ(const uint32_t v) {
+	return v ? __builtin_clz(v) : 32;
+}
+
+static inline uint32_t __BFI(const uint32_t rd, const uint32_t rn, const uint32_t lsb, const uint32_t width) {
+	const uint32_t mask = ((width >= 32) ? 0xffffffff : ((1U << width) - 1)) << lsb;
+	return (rd & ~mask) | ((rn << lsb) & mask);
+}
+
+static inline int32_t __SSAT(const int32_t v, const uint32_t bits) {
+	return simd_host::sat(v, bits);
+}
+
+static inline uint32_t __USAT(const int32_t v, const uint32_t bits) {
+	const int32_t max = (bits >= 32) ? 0x7fffffff : ((1 << bits) - 1);
+	return (v < 0) ? 0 : ((v > max) ? max : v);
+}
+
+static inline int32_t __QADD(const int32_t a, const int32_t b) {
+	return simd_host::sat(int64_t(a) + b, 32);
+}
+
+static inline int32_t __QSUB(const int32_t a, const int32_t b) {
+	return simd_host::sat(int64_t(a) - b, 32);
+}
+
+static inline uint32_t __QADD16(const uint32_t a, const uint32_t b) {
+	using namespace simd_host;
+	return pack(sat(lo(a) + lo(b), 16), sat(hi(a) + hi(b), 16));
+}
+
+static inline uint32_t __QSUB16(const uint32_t a, const uint32_t b) {
+	using namespace simd_host;
+	return pack(sat(lo(a) - lo(b), 16), sat(hi(a) - hi(b), 16));
+}
+
+static inline int32_t __SXTB16(const uint32_t rm, const uint32_t ror = 0) {
+	const uint32_t v = simd_host::ror(rm, ror);
+	return simd_host::pack(static_cast<int8_t>(v & 0xff), static_cast<int8_t>((v >> 16) & 0xff));
+}
+
+static inline int32_t __SXTH(const uint32_t rm, const uint32_t ror = 0) {
+	return simd_host::lo(simd_host::ror(rm, ror));
+}
+
+static inline int32_t __SXTAH(const uint32_t rn, const uint32_t rm, const uint32_t ror = 0) {
+	return static_cast<int32_t>(rn + static_cast<uint32_t>(simd_host::lo(simd_host::ror(rm, ror))));
+}
+
+static inline uint32_t __PKHBT(const uint32_t a, const uint32_t b, const uint32_t sh) {
+	return (a & 0x0000ffff) | ((b << sh) & 0xffff0000);
+}
+
+static inline uint32_t __PKHTB(const uint32_t a, const uint32_t b, const uint32_t sh) {
+	/* ASR #0 is not encodable; the instruction treats it as no shift. */
+	return (a & 0xffff0000) | (static_cast<uint32_t>(static_cast<int32_t>(b) >> sh) & 0x0000ffff);
+}
+
+static inline int32_t __SMULBB(const uint32_t a, const uint32_t b) {
+	return simd_host::lo(a) * simd_host::lo(b);
+}
+
+static inline int32_t __SMULBT(const uint32_t a, const uint32_t b) {
+	return simd_host::lo(a) * simd_host::hi(b);
+}
+
+static inline int32_t __SMULTB(const uint32_t a, const uint32_t b) {
+	return simd_host::hi(a) * simd_host::lo(b);
+}
+
+static inline int32_t __SMULTT(const uint32_t a, const uint32_t b) {
+	return simd_host::hi(a) * simd_host::hi(b);
+}
+
+static inline int32_t __SMLABB(const uint32_t rm, const uint32_t rs, const uint32_t rn) {
+	return static_cast<int32_t>(rn + static_cast<uint32_t>(__SMULBB(rm, rs)));
+}
+
+static inline int32_t __SMLATB(const uint32_t rm, const uint32_t rs, const uint32_t rn) {
+	return static_cast<int32_t>(rn + static_cast<uint32_t>(__SMULTB(rm, rs)));
+}
+
+/* Dual multiplies wrap like the hardware (which only sets the Q flag). */
+
+static inline uint32_t __SMUAD(const uint32_t a, const uint32_t b) {
+	return static_cast<uint32_t>(__SMULBB(a, b)) + static_cast<uint32_t>(__SMULTT(a, b));
+}
+
+static inline uint32_t __SMUADX(const uint32_t a, const uint32_t b) {
+	return static_cast<uint32_t>(__SMULBT(a, b)) + static_cast<uint32_t>(__SMULTB(a, b));
+}
+
+static inline uint32_t __SMUSD(const uint32_t a, const uint32_t b) {
+	return static_cast<uint32_t>(__SMULBB(a, b)) - static_cast<uint32_t>(__SMULTT(a, b));
+}
+
+static inline uint32_t __SMUSDX(const uint32_t a, const uint32_t b) {
+	return static_cast<uint32_t>(__SMULBT(a, b)) - static_cast<uint32_t>(__SMULTB(a, b));
+}
+
+static inline uint32_t __SMLAD(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return __SMUAD(a, b) + acc;
+}
+
+static inline uint32_t __SMLADX(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return __SMUADX(a, b) + acc;
+}
+
+static inline uint32_t __SMLSD(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return __SMUSD(a, b) + acc;
+}
+
+static inline uint32_t __SMLSDX(const uint32_t a, const uint32_t b, const uint32_t acc) {
+	return __SMUSDX(a, b) + acc;
+}
+
+static inline int64_t __SMLALD(const uint32_t a, const uint32_t b, const int64_t acc) {
+	return acc + int64_t(__SMULBB(a, b)) + int64_t(__SMULTT(a, b));
+}
+
+static inline int64_t __SMLALDX(const uint32_t a, const uint32_t b, const int64_t acc) {
+	return acc + int64_t(__SMULBT(a, b)) + int64_t(__SMULTB(a, b));
+}
+
+static inline int64_t __SMLSLD(const uint32_t a, const uint32_t b, const int64_t acc) {
+	return acc + int64_t(__SMULBB(a, b)) - int64_t(__SMULTT(a, b));
+}
+
+static inline int64_t __SMULL(const int32_t a, const int32_t b) {
+	return int64_t(a) * b;
+}
+
+static inline int32_t __SMMULR(const int32_t a, const int32_t b) {
+	return static_cast<int32_t>((int64_t(a) * b + 0x80000000LL) >> 32);
+}
+
+#endif /* defined(PORTAPACK_HOST) */
+
+#endif/*__SIMD_HOST_H__*/
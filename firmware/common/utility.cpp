@@ -82,6 +82,28 @@ float fast_pow2(const float val) {
 	return u.f;
 }
 
+uint32_t log2_q8(const uint64_t v) {
+	/* round(log2(1 + i / 64) * 256) */
+	static constexpr uint8_t mantissa_log2_q8[64] {
+		  0,   6,  11,  17,  22,  28,  33,  38,
+		 44,  49,  54,  59,  63,  68,  73,  78,
+		 82,  87,  92,  96, 100, 105, 109, 113,
+		118, 122, 126, 130, 134, 138, 142, 146,
+		150, 154, 157, 161, 165, 169, 172, 176,
+		179, 183, 186, 190, 193, 197, 200, 203,
+		207, 210, 213, 216, 220, 223, 226, 229,
+		232, 235, 238, 241, 244, 247, 250, 253,
+	};
+
+	if( v == 0 ) {
+		return 0;
+	}
+
+	const uint32_t msb = 63 - __builtin_clzll(v);
+	const uint32_t mantissa = (msb >= 6) ? (v >> (msb - 6)) : (v << (6 - msb));
+	return (msb << 8) + mantissa_log2_q8[mantissa & 0x3f];
+}
+
 float mag2_to_dbv_norm(const float mag2) {
 	constexpr float mag2_log2_max = 0.0f; //std::log2(1.0f);
 	constexpr float log_mag2_mag_factor = 0.5f;
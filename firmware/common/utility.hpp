@@ -80,6 +80,9 @@ constexpr size_t log_2(const size_t n, const size_t p = 0) {
 float fast_log2(const float val);
 float fast_pow2(const float val);
 
+/* Integer log2 in Q8 fixed point (log2(v) * 256), table-based. Returns 0 for v == 0. */
+uint32_t log2_q8(const uint64_t v);
+
 float mag2_to_dbv_norm(const float mag2);
 
 inline float magnitude_squared(const std::complex<float> c) {
@@ -0,0 +1,141 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Checks TableCRC against the bitwise CRC for the configurations the
+ * firmware uses, then times both.
+ *
+ *   bench_crc [--verify]
+ *
+ * --verify only compares checksums, for ctest.
+ */
+
+#include "crc.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+static int failures = 0;
+
+template<typename Reference, typename Table>
+static void run(const char* const name, Reference reference, Table table, const bool timed) {
+	// Lengths around the slice-by-4 alignment and word loop edges
+	std::vector<uint8_t> data(65536 + 3);
+	uint32_t lcg = 1;
+	for(auto& byte : data) {
+		lcg = lcg * 1664525 + 1013904223;
+		byte = lcg >> 24;
+	}
+
+	for(const size_t offset : { 0, 1, 2, 3 }) {
+		for(const size_t length : { 0, 1, 3, 4, 5, 7, 8, 13, 64, 1000, 65536 }) {
+			reference.reset();
+			table.reset();
+			reference.process_bytes(&data[offset], length);
+			table.process_bytes(&data[offset], length);
+			if( reference.checksum() != table.checksum() ) {
+				std::printf("%s: offset %zu length %zu: %08x != %08x\n", name, offset, length,
+					static_cast<unsigned>(table.checksum()), static_cast<unsigned>(reference.checksum()));
+				failures++;
+			}
+		}
+	}
+
+	// Odd bit counts, as the packet decoders feed them
+	reference.reset();
+	table.reset();
+	for(size_t i=0; i<100; i++) {
+		const auto bits = 1 + (data[i] % 16);
+		reference.process_bits(data[i + 100] | (data[i + 200] << 8), bits);
+		table.process_bits(data[i + 100] | (data[i + 200] << 8), bits);
+	}
+	if( reference.checksum() != table.checksum() ) {
+		std::printf("%s: process_bits: %08x != %08x\n", name,
+			static_cast<unsigned>(table.checksum()), static_cast<unsigned>(reference.checksum()));
+		failures++;
+	}
+
+	if( !timed ) {
+		return;
+	}
+
+	using clock = std::chrono::steady_clock;
+	const auto measure = [&data](auto& crc) {
+		size_t bytes = 0;
+		static volatile uint32_t sink = 0;
+		const auto start = clock::now();
+		auto elapsed = clock::duration::zero();
+		do {
+			// Change the data so no pass can be hoisted out of the loop
+			data[0]++;
+			crc.reset();
+			crc.process_bytes(data.data(), 65536);
+			sink = sink ^ crc.checksum();
+			bytes += 65536;
+			elapsed = clock::now() - start;
+		} while( elapsed < std::chrono::milliseconds(200) );
+		return bytes / std::chrono::duration<double, std::micro>(elapsed).count();
+	};
+	const auto reference_mbs = measure(reference);
+	const auto table_mbs = measure(table);
+	std::printf("%-24s %10.1f %10.1f %8.1fx\n", name, reference_mbs, table_mbs, table_mbs / reference_mbs);
+}
+
+int main(int argc, char** argv) {
+	const bool timed = !((argc > 1) && (std::strcmp(argv[1], "--verify") == 0));
+
+	if( timed ) {
+		std::printf("%-24s %10s %10s %9s\n", "crc", "CRC MB/s", "Table MB/s", "speedup");
+	}
+
+	// PNG chunks
+	run("CRC-32", CRC<32, true, true> { 0x04c11db7, 0xffffffff, 0xffffffff },
+		TableCRC<32, 0x04c11db7, true, true> { 0xffffffff, 0xffffffff }, timed);
+	run("CRC-32 slice-by-4", CRC<32, true, true> { 0x04c11db7, 0xffffffff, 0xffffffff },
+		TableCRC<32, 0x04c11db7, true, true, 4> { 0xffffffff, 0xffffffff }, timed);
+	// ADS-B
+	run("CRC-24 Mode S", CRC<24> { 0xfff409 },
+		TableCRC<24, 0xfff409> { }, timed);
+	// BTLE
+	run("CRC-24 BTLE", CRC<24, true, true> { 0x00065b, 0x555555 },
+		TableCRC<24, 0x00065b, true, true> { 0x555555 }, timed);
+	// ERT, AIS, ACARS, nRF
+	run("CRC-16 CCITT", CRC<16> { 0x1021, 0xffff, 0x1d0f },
+		TableCRC<16, 0x1021> { 0xffff, 0x1d0f }, timed);
+	// AX.25 FCS
+	run("CRC-16 X.25", CRC<16, true, true> { 0x1021, 0xffff, 0xffff },
+		TableCRC<16, 0x1021, true, true> { 0xffff, 0xffff }, timed);
+	// ERT BCH
+	run("CRC-16 0x6f63", CRC<16> { 0x6f63 },
+		TableCRC<16, 0x6f63> { }, timed);
+	// TPMS
+	run("CRC-8 0x01", CRC<8> { 0x01 },
+		TableCRC<8, 0x01> { }, timed);
+
+	if( failures ) {
+		std::printf("%d mismatch(es)\n", failures);
+		return 1;
+	}
+	if( !timed ) {
+		std::printf("all checksums match\n");
+	}
+	return 0;
+}
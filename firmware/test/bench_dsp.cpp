@@ -0,0 +1,401 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Runs the baseband decimators and demodulators over 2048-sample buffers
+ * and reports throughput and output checksums. The M4 has 102.4 us per
+ * buffer at 20 MHz sampling, so ns/buf on the host is only comparable
+ * between runs on the same machine; the checksums must not change unless
+ * a kernel's output is meant to.
+ *
+ *   bench_dsp [--c8 FILE | --c16 FILE] [--buffers N] [--verify FILE]
+ *
+ * Without a file the input is a synthetic FM-modulated carrier in noise.
+ * --verify compares the checksums with a "name checksum" list and skips
+ * the timing runs.
+ */
+
+#include "dsp_decimate.hpp"
+#include "dsp_demodulate.hpp"
+#include "channel_decimator.hpp"
+#include "dsp_fir_taps.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+#include <array>
+
+constexpr size_t buffer_samples = 2048;
+constexpr uint32_t sampling_rate = 3072000;
+
+using c8_block = std::array<complex8_t, buffer_samples>;
+using c16_block = std::array<complex16_t, buffer_samples>;
+using s16_block = std::array<int16_t, buffer_samples>;
+
+struct Inputs {
+	std::vector<c8_block> c8;
+	std::vector<c16_block> c16;
+	std::vector<s16_block> s16;
+};
+
+/* FNV-1a over the raw bytes of every output buffer */
+class Checksum {
+public:
+	template<typename T>
+	void add(const buffer_t<T>& buffer) {
+		const auto p = reinterpret_cast<const uint8_t*>(buffer.p);
+		for(size_t i=0; i<buffer.count * sizeof(T); i++) {
+			hash = (hash ^ p[i]) * 0x100000001b3ULL;
+		}
+	}
+
+	uint64_t value() const {
+		return hash;
+	}
+
+private:
+	uint64_t hash { 0xcbf29ce484222325ULL };
+};
+
+static Inputs synthetic_inputs(const size_t buffers) {
+	// FM carrier at +fs/4 + 10 kHz, 1 kHz tone at 5 kHz deviation, in noise
+	Inputs inputs;
+	uint32_t lcg = 12345;
+	const auto noise = [&lcg]() {
+		lcg = lcg * 1664525 + 1013904223;
+		return static_cast<int32_t>(lcg >> 20) - 2048;
+	};
+	double phase = 0;
+	size_t n = 0;
+	for(size_t b=0; b<buffers; b++) {
+		c16_block block;
+		for(auto& sample : block) {
+			const double t = static_cast<double>(n++) / sampling_rate;
+			const double f = sampling_rate / 4.0 + 10000.0 + 5000.0 * std::sin(2.0 * M_PI * 1000.0 * t);
+			phase += 2.0 * M_PI * f / sampling_rate;
+			sample = {
+				static_cast<int16_t>(std::lround(12000.0 * std::cos(phase)) + noise()),
+				static_cast<int16_t>(std::lround(12000.0 * std::sin(phase)) + noise())
+			};
+		}
+		inputs.c16.push_back(block);
+	}
+	return inputs;
+}
+
+static bool file_inputs(Inputs& inputs, const char* const path, const bool c16, const size_t buffers) {
+	FILE* f = std::fopen(path, "rb");
+	if( !f ) {
+		return false;
+	}
+	for(size_t b=0; b<buffers; b++) {
+		c16_block block;
+		if( c16 ) {
+			if( std::fread(block.data(), sizeof(complex16_t), buffer_samples, f) != buffer_samples ) {
+				break;
+			}
+		} else {
+			std::array<int8_t, buffer_samples * 2> raw;
+			if( std::fread(raw.data(), 1, raw.size(), f) != raw.size() ) {
+				break;
+			}
+			for(size_t i=0; i<buffer_samples; i++) {
+				block[i] = { static_cast<int16_t>(raw[i * 2 + 0] * 256), static_cast<int16_t>(raw[i * 2 + 1] * 256) };
+			}
+		}
+		inputs.c16.push_back(block);
+	}
+	std::fclose(f);
+	return !inputs.c16.empty();
+}
+
+static void derive_inputs(Inputs& inputs) {
+	for(const auto& block : inputs.c16) {
+		c8_block c8;
+		s16_block s16;
+		for(size_t i=0; i<buffer_samples; i++) {
+			c8[i] = { static_cast<int8_t>(block[i].real() >> 8), static_cast<int8_t>(block[i].imag() >> 8) };
+			s16[i] = block[i].real();
+		}
+		inputs.c8.push_back(c8);
+		inputs.s16.push_back(s16);
+	}
+}
+
+struct Result {
+	std::string name;
+	uint64_t checksum;
+	double ns_per_buffer;
+};
+
+/* Make() returns fresh kernel state; Step(state, i, checksum) processes
+ * input buffer i. The checksum pass and each timed pass start from fresh
+ * state, so results do not depend on the pass count.
+ */
+template<typename Make, typename Step>
+static Result run(const char* const name, const size_t buffers, const bool timed, Make make, Step step) {
+	Result result { name, 0, 0 };
+	{
+		auto state = make();
+		Checksum checksum;
+		for(size_t i=0; i<buffers; i++) {
+			step(*state, i, &checksum);
+		}
+		result.checksum = checksum.value();
+	}
+
+	if( timed ) {
+		using clock = std::chrono::steady_clock;
+		size_t passes = 0;
+		const auto start = clock::now();
+		auto elapsed = clock::duration::zero();
+		do {
+			auto state = make();
+			for(size_t i=0; i<buffers; i++) {
+				step(*state, i, nullptr);
+			}
+			passes++;
+			elapsed = clock::now() - start;
+		} while( elapsed < std::chrono::milliseconds(200) );
+		const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+		result.ns_per_buffer = ns / (passes * buffers);
+	}
+	return result;
+}
+
+template<typename T>
+static void add(Checksum* const checksum, const buffer_t<T>& buffer) {
+	if( checksum ) {
+		checksum->add(buffer);
+	}
+}
+
+template<typename Kernel>
+struct Stage {
+	Kernel kernel { };
+	c16_block work { };
+};
+
+static std::vector<Result> run_all(Inputs& inputs, const bool timed) {
+	using namespace dsp::decimate;
+	using namespace dsp::demodulate;
+	std::vector<Result> results;
+	const auto buffers = inputs.c16.size();
+
+	const auto c8 = [&inputs](const size_t i) {
+		return buffer_c8_t { inputs.c8[i].data(), buffer_samples, sampling_rate };
+	};
+	const auto c16 = [&inputs](const size_t i) {
+		return buffer_c16_t { inputs.c16[i].data(), buffer_samples, sampling_rate };
+	};
+	const auto s16 = [&inputs](const size_t i) {
+		return buffer_s16_t { inputs.s16[i].data(), buffer_samples, sampling_rate };
+	};
+
+	#define C8_TO_C16(NAME, KERNEL, CONFIGURE) \
+		results.push_back(run(NAME, buffers, timed, \
+			[]() { auto s = std::make_unique<Stage<KERNEL>>(); auto& k = s->kernel; (void)k; CONFIGURE; return s; }, \
+			[&](Stage<KERNEL>& s, const size_t i, Checksum* const sum) { \
+				add(sum, s.kernel.execute(c8(i), { s.work.data(), s.work.size() })); \
+			}))
+	#define C16_TO_C16(NAME, KERNEL, CONFIGURE) \
+		results.push_back(run(NAME, buffers, timed, \
+			[]() { auto s = std::make_unique<Stage<KERNEL>>(); auto& k = s->kernel; (void)k; CONFIGURE; return s; }, \
+			[&](Stage<KERNEL>& s, const size_t i, Checksum* const sum) { \
+				add(sum, s.kernel.execute(c16(i), { s.work.data(), s.work.size() })); \
+			}))
+
+	C8_TO_C16("TranslateByFSOver4AndDecimateBy2CIC3", TranslateByFSOver4AndDecimateBy2CIC3, );
+	C8_TO_C16("Complex8DecimateBy2CIC3", Complex8DecimateBy2CIC3, );
+	C8_TO_C16("FIRC8xR16x24FS4Decim4", FIRC8xR16x24FS4Decim4, k.configure(taps_200k_wfm_decim_0.taps, 33554432));
+	C8_TO_C16("FIRC8xR16x24FS4Decim8", FIRC8xR16x24FS4Decim8, k.configure(taps_16k0_decim_0.taps, 33554432));
+	C16_TO_C16("DecimateBy2CIC3", DecimateBy2CIC3, );
+	C16_TO_C16("FIRC16xR16x16Decim2", FIRC16xR16x16Decim2, k.configure(taps_200k_wfm_decim_1.taps, 131072));
+	C16_TO_C16("FIRC16xR16x32Decim8", FIRC16xR16x32Decim8, k.configure(taps_16k0_decim_1.taps, 131072));
+	C16_TO_C16("FIRAndDecimateComplex/64/2", FIRAndDecimateComplex, k.configure(taps_6k0_dsb_channel.taps, 2));
+
+	#undef C8_TO_C16
+	#undef C16_TO_C16
+
+	results.push_back(run("FIR64AndDecimateBy2Real", buffers, timed,
+		[]() { auto s = std::make_unique<std::pair<FIR64AndDecimateBy2Real, s16_block>>(); s->first.configure(taps_64_lp_025_025.taps); return s; },
+		[&](std::pair<FIR64AndDecimateBy2Real, s16_block>& s, const size_t i, Checksum* const sum) {
+			add(sum, s.first.execute(s16(i), { s.second.data(), s.second.size() }));
+		}));
+
+	results.push_back(run("DecimateBy2CIC4Real", buffers, timed,
+		[]() { return std::make_unique<std::pair<DecimateBy2CIC4Real, s16_block>>(); },
+		[&](std::pair<DecimateBy2CIC4Real, s16_block>& s, const size_t i, Checksum* const sum) {
+			add(sum, s.first.execute(s16(i), { s.second.data(), s.second.size() }));
+		}));
+
+	const std::array<std::pair<const char*, ChannelDecimator::DecimationFactor>, 5> factors { {
+		{ "ChannelDecimator/2", ChannelDecimator::DecimationFactor::By2 },
+		{ "ChannelDecimator/4", ChannelDecimator::DecimationFactor::By4 },
+		{ "ChannelDecimator/8", ChannelDecimator::DecimationFactor::By8 },
+		{ "ChannelDecimator/16", ChannelDecimator::DecimationFactor::By16 },
+		{ "ChannelDecimator/32", ChannelDecimator::DecimationFactor::By32 },
+	} };
+	for(const auto& factor : factors) {
+		results.push_back(run(factor.first, buffers, timed,
+			[&factor]() { return std::make_unique<ChannelDecimator>(factor.second); },
+			[&](ChannelDecimator& s, const size_t i, Checksum* const sum) {
+				add(sum, s.execute(c8(i)));
+			}));
+	}
+
+	using f32_block = std::array<float, buffer_samples>;
+	results.push_back(run("AM", buffers, timed,
+		[]() { return std::make_unique<std::pair<AM, f32_block>>(); },
+		[&](std::pair<AM, f32_block>& s, const size_t i, Checksum* const sum) {
+			add(sum, s.first.execute(c16(i), { s.second.data(), s.second.size() }));
+		}));
+	results.push_back(run("SSB", buffers, timed,
+		[]() { return std::make_unique<std::pair<SSB, f32_block>>(); },
+		[&](std::pair<SSB, f32_block>& s, const size_t i, Checksum* const sum) {
+			add(sum, s.first.execute(c16(i), { s.second.data(), s.second.size() }));
+		}));
+	results.push_back(run("FM/f32", buffers, timed,
+		[]() { auto s = std::make_unique<std::pair<FM, f32_block>>(); s->first.configure(sampling_rate, 5000); return s; },
+		[&](std::pair<FM, f32_block>& s, const size_t i, Checksum* const sum) {
+			add(sum, s.first.execute(c16(i), { s.second.data(), s.second.size() }));
+		}));
+	results.push_back(run("FM/s16", buffers, timed,
+		[]() { auto s = std::make_unique<std::pair<FM, s16_block>>(); s->first.configure(sampling_rate, 5000); return s; },
+		[&](std::pair<FM, s16_block>& s, const size_t i, Checksum* const sum) {
+			add(sum, s.first.execute(c16(i), { s.second.data(), s.second.size() }));
+		}));
+
+	// The NBFM receive chain, as in proc_nfm_audio
+	struct NBFM {
+		FIRC8xR16x24FS4Decim8 decim_0 { };
+		FIRC16xR16x32Decim8 decim_1 { };
+		FIRAndDecimateComplex channel_filter { };
+		FM demod { };
+		c16_block work { };
+		std::array<float, 32> audio { };
+	};
+	results.push_back(run("NBFMChain", buffers, timed,
+		[]() {
+			auto s = std::make_unique<NBFM>();
+			s->decim_0.configure(taps_16k0_decim_0.taps, 33554432);
+			s->decim_1.configure(taps_16k0_decim_1.taps, 131072);
+			s->channel_filter.configure(taps_16k0_channel.taps, 2);
+			s->demod.configure(sampling_rate / 128, 5000);
+			return s;
+		},
+		[&](NBFM& s, const size_t i, Checksum* const sum) {
+			const buffer_c16_t work { s.work.data(), s.work.size() };
+			const auto decim_0_out = s.decim_0.execute(c8(i), work);
+			const auto decim_1_out = s.decim_1.execute(decim_0_out, work);
+			const auto channel_out = s.channel_filter.execute(decim_1_out, work);
+			add(sum, s.demod.execute(channel_out, { s.audio.data(), s.audio.size() }));
+		}));
+
+	return results;
+}
+
+static bool verify(const std::vector<Result>& results, const char* const path) {
+	FILE* f = std::fopen(path, "r");
+	if( !f ) {
+		std::printf("cannot open %s\n", path);
+		return false;
+	}
+	std::map<std::string, uint64_t> expected;
+	char line[256];
+	while( std::fgets(line, sizeof(line), f) ) {
+		char name[128];
+		unsigned long long checksum;
+		if( (line[0] != '#') && (std::sscanf(line, "%127s %llx", name, &checksum) == 2) ) {
+			expected[name] = checksum;
+		}
+	}
+	std::fclose(f);
+
+	bool ok = true;
+	for(const auto& result : results) {
+		const auto it = expected.find(result.name);
+		if( it == expected.end() ) {
+			std::printf("%-40s %016llx  no expected checksum\n", result.name.c_str(), static_cast<unsigned long long>(result.checksum));
+			ok = false;
+		} else if( it->second != result.checksum ) {
+			std::printf("%-40s %016llx  expected %016llx\n", result.name.c_str(),
+				static_cast<unsigned long long>(result.checksum), static_cast<unsigned long long>(it->second));
+			ok = false;
+		}
+	}
+	std::printf(ok ? "all %zu checksums match\n" : "checksum mismatch (of %zu kernels)\n", results.size());
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	const char* file = nullptr;
+	bool file_c16 = false;
+	const char* verify_path = nullptr;
+	size_t buffers = 64;
+
+	for(int i=1; i<argc; i++) {
+		if( (std::strcmp(argv[i], "--c8") == 0) && (i + 1 < argc) ) {
+			file = argv[++i];
+			file_c16 = false;
+		} else if( (std::strcmp(argv[i], "--c16") == 0) && (i + 1 < argc) ) {
+			file = argv[++i];
+			file_c16 = true;
+		} else if( (std::strcmp(argv[i], "--buffers") == 0) && (i + 1 < argc) ) {
+			buffers = std::strtoul(argv[++i], nullptr, 0);
+		} else if( (std::strcmp(argv[i], "--verify") == 0) && (i + 1 < argc) ) {
+			verify_path = argv[++i];
+		} else {
+			std::printf("usage: %s [--c8 FILE | --c16 FILE] [--buffers N] [--verify FILE]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	Inputs inputs;
+	if( file ) {
+		if( !file_inputs(inputs, file, file_c16, buffers) ) {
+			std::printf("cannot read %s\n", file);
+			return 1;
+		}
+	} else {
+		inputs = synthetic_inputs(buffers);
+	}
+	derive_inputs(inputs);
+
+	const auto results = run_all(inputs, verify_path == nullptr);
+
+	if( verify_path ) {
+		return verify(results, verify_path) ? 0 : 1;
+	}
+
+	std::printf("%-40s %10s %10s  %s\n", "kernel", "Msample/s", "ns/buf", "checksum");
+	for(const auto& result : results) {
+		std::printf("%-40s %10.1f %10.0f  %016llx\n",
+			result.name.c_str(),
+			buffer_samples * 1e3 / result.ns_per_buffer,
+			result.ns_per_buffer,
+			static_cast<unsigned long long>(result.checksum)
+		);
+	}
+	return 0;
+}
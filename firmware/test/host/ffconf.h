@@ -0,0 +1,35 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* The firmware's FatFs configuration, without the RTOS locking and with
+ * f_mkfs() so tests can format their own images.
+ */
+
+#ifndef __HOST_FFCONF_H__
+#define __HOST_FFCONF_H__
+
+#include "../../application/ffconf.h"
+
+#undef _FS_REENTRANT
+#define _FS_REENTRANT	0
+
+#undef _USE_MKFS
+#define _USE_MKFS		1
+
+#endif/*__HOST_FFCONF_H__*/
@@ -0,0 +1,98 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "ram_disk.hpp"
+
+#include "ff.h"
+#include "diskio.h"
+
+#include <cstring>
+
+static RAMDisk* disk { nullptr };
+
+RAMDisk::RAMDisk(
+	const size_t sector_count
+) : data(sector_count * sector_size, 0)
+{
+	disk = this;
+}
+
+RAMDisk::~RAMDisk() {
+	disk = nullptr;
+}
+
+extern "C" {
+
+DSTATUS disk_initialize(BYTE) {
+	return disk ? 0 : STA_NOINIT;
+}
+
+DSTATUS disk_status(BYTE) {
+	return disk ? 0 : STA_NOINIT;
+}
+
+DRESULT disk_read(BYTE, BYTE* buff, DWORD sector, UINT count) {
+	if( !disk || (sector + count > disk->sector_count()) ) {
+		return RES_PARERR;
+	}
+	disk->count(sector, count);
+	memcpy(buff, disk->sector(sector), count * RAMDisk::sector_size);
+	return RES_OK;
+}
+
+DRESULT disk_write(BYTE, const BYTE* buff, DWORD sector, UINT count) {
+	if( !disk || (sector + count > disk->sector_count()) ) {
+		return RES_PARERR;
+	}
+	disk->count(sector, count);
+	memcpy(disk->sector(sector), buff, count * RAMDisk::sector_size);
+	return RES_OK;
+}
+
+DRESULT disk_ioctl(BYTE, BYTE cmd, void* buff) {
+	if( !disk ) {
+		return RES_NOTRDY;
+	}
+	switch(cmd) {
+	case CTRL_SYNC:
+		return RES_OK;
+
+	case GET_SECTOR_COUNT:
+		*static_cast<DWORD*>(buff) = disk->sector_count();
+		return RES_OK;
+
+	case GET_SECTOR_SIZE:
+		*static_cast<WORD*>(buff) = RAMDisk::sector_size;
+		return RES_OK;
+
+	case GET_BLOCK_SIZE:
+		*static_cast<DWORD*>(buff) = 1;
+		return RES_OK;
+
+	default:
+		return RES_PARERR;
+	}
+}
+
+DWORD get_fattime() {
+	// 2017-01-01 00:00:00
+	return (37UL << 25) | (1UL << 21) | (1UL << 16);
+}
+
+} /* extern "C" */
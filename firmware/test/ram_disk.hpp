@@ -0,0 +1,69 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RAM_DISK_H__
+#define __RAM_DISK_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/* A FatFs drive held in memory, for running the firmware's file code on
+ * the host. Counts the sector accesses that fall in a watched range, e.g.
+ * the FATs of the mounted volume.
+ */
+class RAMDisk {
+public:
+	static constexpr size_t sector_size = 512;
+
+	explicit RAMDisk(const size_t sector_count);
+	~RAMDisk();
+
+	void watch(const uint32_t first, const uint32_t end) {
+		watch_first = first;
+		watch_end = end;
+		watched_accesses = 0;
+	}
+
+	size_t accesses() const {
+		return watched_accesses;
+	}
+
+	size_t sector_count() const {
+		return data.size() / sector_size;
+	}
+
+	uint8_t* sector(const uint32_t n) {
+		return &data[n * sector_size];
+	}
+
+	void count(const uint32_t first, const size_t count) {
+		if( (first < watch_end) && (first + count > watch_first) ) {
+			watched_accesses++;
+		}
+	}
+
+private:
+	std::vector<uint8_t> data;
+	uint32_t watch_first { 0 };
+	uint32_t watch_end { 0 };
+	size_t watched_accesses { 0 };
+};
+
+#endif/*__RAM_DISK_H__*/
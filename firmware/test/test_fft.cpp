@@ -0,0 +1,195 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* fft_fixed_preswapped() at every size from 4 to 2048 points, for
+ * complex16_t and complex32_t samples:
+ * - output checksums must match the table below bit for bit,
+ * - output must stay within a few LSB of a double precision DFT,
+ * - the twiddle tables must be within 1 LSB of sin/cos in Q15.
+ *
+ *   test_fft [--print]
+ *
+ * --print lists the checksums in the form of the table, for when the FFT
+ * output is meant to change.
+ */
+
+#include "dsp_fft.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <complex>
+#include <string>
+
+struct Expected {
+	const char* name;
+	uint64_t checksum;
+};
+
+static constexpr Expected expected[] {
+	{ "c16/4", 0xc740633b0c6f689cULL },
+	{ "c16/8", 0x373f173aa6158e30ULL },
+	{ "c16/16", 0xc4279a849c4460c4ULL },
+	{ "c16/32", 0xdab1453359611234ULL },
+	{ "c16/64", 0x3f7eaf50a099e5abULL },
+	{ "c16/128", 0x36ee31608e30e760ULL },
+	{ "c16/256", 0xfba3c9e2d05e7355ULL },
+	{ "c16/512", 0x77584c21725e27e4ULL },
+	{ "c16/1024", 0x9633dedca8ab4b49ULL },
+	{ "c16/2048", 0x6e55573edcce6138ULL },
+	{ "c32/4", 0xd880cecaf6b942eaULL },
+	{ "c32/8", 0x66f3375a671d02d5ULL },
+	{ "c32/16", 0x1c7c88ab160aeeceULL },
+	{ "c32/32", 0x516f03eb37f1d3c7ULL },
+	{ "c32/64", 0x26d16fc4aec17ff8ULL },
+	{ "c32/128", 0xf317e27320830116ULL },
+	{ "c32/256", 0xf52cf7992a339d2aULL },
+	{ "c32/512", 0xc90a14c5ace54cbaULL },
+	{ "c32/1024", 0xb2bbebbd5b4d4e1dULL },
+	{ "c32/2048", 0x2922af53ca6d4f04ULL },
+};
+
+static int failures = 0;
+static bool print = false;
+
+static uint64_t expected_checksum(const std::string& name, bool& found) {
+	for(const auto& e : expected) {
+		if( name == e.name ) {
+			found = true;
+			return e.checksum;
+		}
+	}
+	found = false;
+	return 0;
+}
+
+template<typename T, size_t N>
+static void test_size(const char* const type_name) {
+	using V = typename T::value_type;
+	const std::string name = std::string(type_name) + "/" + std::to_string(N);
+
+	// Half-scale noise, from integers only so the checksums are portable
+	std::array<T, N> input;
+	uint32_t lcg = N;
+	for(size_t i=0; i<N; i++) {
+		lcg = lcg * 1664525 + 1013904223;
+		const int32_t re = static_cast<int16_t>(lcg >> 16);
+		lcg = lcg * 1664525 + 1013904223;
+		const int32_t im = static_cast<int16_t>(lcg >> 16);
+		input[i] = { static_cast<V>(re / 2), static_cast<V>(im / 2) };
+	}
+
+	// Bit-reversed order, as fft_swap() feeds it
+	std::array<T, N> data;
+	for(size_t i=0; i<N; i++) {
+		data[__RBIT(i) >> (32 - log_2(N))] = input[i];
+	}
+	fft_fixed_preswapped(data);
+
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for(const auto& bin : data) {
+		for(const int32_t v : { static_cast<int32_t>(bin.real()), static_cast<int32_t>(bin.imag()) }) {
+			for(size_t b=0; b<4; b++) {
+				hash = (hash ^ ((static_cast<uint32_t>(v) >> (b * 8)) & 0xff)) * 0x100000001b3ULL;
+			}
+		}
+	}
+
+	// Compare with a double precision DFT, at the same output scale
+	const double scale = (sizeof(V) > 2) ? 1.0 : 1.0 / (2.0 * N);
+	double error_max = 0;
+	for(size_t k=0; k<N; k++) {
+		std::complex<double> sum { 0, 0 };
+		for(size_t n=0; n<N; n++) {
+			const double a = -2.0 * M_PI * static_cast<double>((k * n) % N) / N;
+			sum += std::complex<double>(input[n].real(), input[n].imag()) * std::polar(1.0, a);
+		}
+		sum *= scale;
+		error_max = std::max(error_max, std::abs(sum - std::complex<double>(data[k].real(), data[k].imag())));
+	}
+	// Unscaled output is limited by the Q15 twiddles: about 2^-15 of the
+	// output magnitude (2^14 * sqrt(N)) per radix-2 stage. Q15 output loses
+	// about half an LSB per stage to rounding.
+	const double error_limit = (sizeof(V) > 2)
+		? (std::log2(N) * std::sqrt(N) * 16384.0 / 32768.0)
+		: (1.0 + std::log2(N) / 2.0);
+	if( error_max > error_limit ) {
+		std::printf("%s: error %.2f > %.2f\n", name.c_str(), error_max, error_limit);
+		failures++;
+	}
+
+	if( print ) {
+		std::printf("\t{ \"%s\", 0x%016llxULL },\t// error %.2f\n", name.c_str(), static_cast<unsigned long long>(hash), error_max);
+		return;
+	}
+
+	bool found = false;
+	const auto checksum = expected_checksum(name, found);
+	if( !found || (checksum != hash) ) {
+		std::printf("%s: checksum %016llx, expected %016llx\n", name.c_str(),
+			static_cast<unsigned long long>(hash), static_cast<unsigned long long>(checksum));
+		failures++;
+	}
+}
+
+template<size_t N>
+static void test_twiddles() {
+	const auto& table = fft_fixed::twiddles<N>::table;
+	for(size_t n=0; n<table.size(); n++) {
+		const double a = -2.0 * M_PI * n / N;
+		const int32_t re = std::lround(std::cos(a) * 32767.0);
+		const int32_t im = std::lround(std::sin(a) * 32767.0);
+		if( (std::abs(table[n].real() - re) > 1) || (std::abs(table[n].imag() - im) > 1) ) {
+			std::printf("twiddle %zu/%zu: (%d, %d) != (%d, %d)\n", n, N,
+				table[n].real(), table[n].imag(), re, im);
+			failures++;
+			return;
+		}
+	}
+}
+
+template<typename T, size_t... Log2N>
+static void test_sizes(const char* const type_name, std::index_sequence<Log2N...>) {
+	(test_size<T, (size_t(4) << Log2N)>(type_name), ...);
+}
+
+template<size_t... Log2N>
+static void test_all_twiddles(std::index_sequence<Log2N...>) {
+	(test_twiddles<(size_t(4) << Log2N)>(), ...);
+}
+
+int main(int argc, char** argv) {
+	print = (argc > 1) && (std::strcmp(argv[1], "--print") == 0);
+
+	// 4 to 2048 points
+	constexpr auto sizes = std::make_index_sequence<10>();
+	test_all_twiddles(sizes);
+	test_sizes<complex16_t>("c16", sizes);
+	test_sizes<complex32_t>("c32", sizes);
+
+	if( failures ) {
+		std::printf("%d failure(s)\n", failures);
+		return 1;
+	}
+	if( !print ) {
+		std::printf("OK\n");
+	}
+	return 0;
+}
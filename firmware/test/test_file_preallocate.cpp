@@ -0,0 +1,185 @@
+/*
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* File::preallocate() on a FAT32 image: writes inside the reservation
+ * must not touch the FAT, the file must end at the last byte written,
+ * and writing past the reservation or onto a fragmented volume must
+ * still produce the right data.
+ */
+
+#include "ram_disk.hpp"
+#include "file.hpp"
+
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <string>
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+	if( !(cond) ) { \
+		std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+		failures++; \
+	} \
+} while(0)
+
+static const TCHAR* tstr(const char16_t* s) {
+	return reinterpret_cast<const TCHAR*>(s);
+}
+
+static uint8_t pattern(const uint64_t offset) {
+	return (offset * 7 + (offset >> 12)) & 0xff;
+}
+
+static bool write_pattern(File& file, const uint64_t size, const size_t chunk) {
+	std::array<uint8_t, 16384> buffer;
+	for(uint64_t offset=0; offset<size; offset+=chunk) {
+		for(size_t i=0; i<chunk; i++) {
+			buffer[i] = pattern(offset + i);
+		}
+		if( file.write(buffer.data(), chunk).is_error() ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool verify_pattern(const std::filesystem::path& path, const uint64_t size) {
+	File file;
+	if( file.open(path).is_valid() || (file.size() != size) ) {
+		return false;
+	}
+	std::array<uint8_t, 4096> buffer;
+	for(uint64_t offset=0; offset<size; offset+=buffer.size()) {
+		const auto length = std::min<uint64_t>(size - offset, buffer.size());
+		const auto result = file.read(buffer.data(), length);
+		if( result.is_error() || (result.value() != length) ) {
+			return false;
+		}
+		for(size_t i=0; i<length; i++) {
+			if( buffer[i] != pattern(offset + i) ) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static DWORD free_clusters() {
+	DWORD clusters = 0;
+	FATFS* fs = nullptr;
+	f_getfree(tstr(u""), &clusters, &fs);
+	return clusters;
+}
+
+static void test_within_reservation(RAMDisk& disk, FATFS& fs) {
+	const uint64_t reserved = 1024 * 1024;
+	const uint64_t written = 768 * 1024;
+	const auto clusters_before = free_clusters();
+
+	{
+		File file;
+		CHECK(!file.create(u"INSIDE.C16").is_valid());
+		CHECK(!file.preallocate(reserved).is_valid());
+		CHECK(file.size() == reserved);
+
+		disk.watch(fs.fatbase, fs.database);
+		CHECK(write_pattern(file, written, 16384));
+		CHECK(disk.accesses() == 0);
+		disk.watch(0, 0);
+	}
+
+	CHECK(verify_pattern(u"INSIDE.C16", written));
+	const DWORD cluster_size = fs.csize * RAMDisk::sector_size;
+	CHECK(free_clusters() == clusters_before - (written + cluster_size - 1) / cluster_size);
+}
+
+static void test_past_reservation() {
+	const uint64_t written = 256 * 1024;
+	{
+		File file;
+		CHECK(!file.create(u"OUTSIDE.C16").is_valid());
+		CHECK(!file.preallocate(64 * 1024).is_valid());
+		// Odd chunks, so writes straddle the end of the reservation
+		CHECK(write_pattern(file, written, 4096 + 512));
+	}
+	CHECK(verify_pattern(u"OUTSIDE.C16", (written / (4096 + 512) + 1) * (4096 + 512)));
+}
+
+static void test_fragmented() {
+	// Fill the volume with 64 KiB files, then free every other one
+	CHECK(f_mkdir(tstr(u"FILL")) == FR_OK);
+	std::array<uint8_t, 16384> buffer { };
+	size_t count = 0;
+	for(bool full=false; !full; count++) {
+		const auto name = u"FILL/" + std::u16string(std::begin(std::to_string(count)), std::end(std::to_string(count)));
+		File file;
+		if( file.create(name).is_valid() ) {
+			break;
+		}
+		for(size_t i=0; i<4; i++) {
+			const auto result = file.write(buffer.data(), buffer.size());
+			if( result.is_error() || (result.value() != buffer.size()) ) {
+				full = true;
+				break;
+			}
+		}
+	}
+	for(size_t i=0; i<count; i+=2) {
+		const auto name = u"FILL/" + std::u16string(std::begin(std::to_string(i)), std::end(std::to_string(i)));
+		f_unlink(tstr(name.c_str()));
+	}
+
+	// No run is long enough, so the file grows cluster by cluster
+	const uint64_t written = 512 * 1024;
+	{
+		File file;
+		CHECK(!file.create(u"FRAG.C16").is_valid());
+		CHECK(!file.preallocate(written).is_valid());
+		CHECK(file.size() == 0);
+		CHECK(write_pattern(file, written, 16384));
+	}
+	CHECK(verify_pattern(u"FRAG.C16", written));
+}
+
+int main() {
+	RAMDisk disk { 128 * 1024 };
+
+	std::array<uint8_t, 4096> work;
+	CHECK(f_mkfs(tstr(u""), FM_FAT32, 512, work.data(), work.size()) == FR_OK);
+
+	FATFS fs { };
+	CHECK(f_mount(&fs, tstr(u""), 1) == FR_OK);
+	CHECK(fs.fs_type == FS_FAT32);
+
+	test_within_reservation(disk, fs);
+	test_past_reservation();
+	test_fragmented();
+
+	f_mount(nullptr, tstr(u""), 0);
+
+	if( failures ) {
+		std::printf("%d check(s) failed\n", failures);
+		return 1;
+	}
+	std::printf("OK\n");
+	return 0;
+}
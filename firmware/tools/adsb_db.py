@@ -18,24 +18,82 @@
 # Boston, MA 02110-1301, USA.
 #
 
+# Builds the sorted lookup databases read by adsb_db.cpp.
+#
+#	adsb_db.py airlines [airlines.txt | airlines.db]
+#		3 letter ICAO airline codes, 32 byte name and 32 byte country
+#	adsb_db.py icao24 aircraftDatabase.csv
+#		24 bit addresses (big-endian), 8 byte registration, 8 byte type code
+#		and 16 byte owner, from an OpenSky style CSV
+#
+# All values little-endian:
+#	char[4]		"PPDB"
+#	u16			version (1)
+#	u16			key size
+#	u16			record size
+#	u16			reserved
+#	u32			record count
+#	keys		sorted
+#	records		same order as the keys
+
+from __future__ import print_function
 import sys
+import csv
 import struct
 
-outfile = open("airlines.db", "w")
-
-lines = [line.rstrip('\n') for line in open('../../sdcard/ADSB/airlines.txt', 'r')]
-n = 0
-
-for line in lines:
-	if line:
-		nd = line.find('(')
-		if (nd == -1):
-			nd = None
-		else:
-			nd -= 1
-		nline = line[4:7] + '\0' + line[10:nd] + '\0'
-		print nline
-		b = bytearray(nline)
-		pad_len = 32 - len(b)
-		b += "\0" * pad_len
-		outfile.write(b)
+def field(text, size):
+	data = text.strip().encode('latin-1', 'replace')[:size]
+	return data + b'\0' * (size - len(data))
+
+def write_db(path, key_size, record_size, entries):
+	entries = sorted(entries.items())
+	outfile = open(path, 'wb')
+	outfile.write(b'PPDB' + struct.pack('<HHHHI', 1, key_size, record_size, 0, len(entries)))
+	for key, record in entries:
+		outfile.write(key)
+	for key, record in entries:
+		outfile.write(record)
+	outfile.close()
+	print('%s: %d records' % (path, len(entries)))
+
+def airlines(path):
+	entries = {}
+	data = open(path, 'rb').read()
+	if data[:4] != b'PPDB' and path.endswith('.db'):
+		# Original layout: codes up to 0x2000, then 64 byte records
+		for c in range(0, 0x2000 // 4):
+			key = data[c * 4:c * 4 + 4]
+			if not key[:1].strip(b'\0'):
+				break
+			entries[key] = data[0x2000 + c * 64:0x2000 + c * 64 + 64]
+	else:
+		for line in data.decode('latin-1').splitlines():
+			if len(line) < 8:
+				continue
+			nd = line.find(' (')
+			name = line[10:nd] if nd != -1 else line[10:]
+			country = line[nd + 2:line.find(')', nd)] if nd != -1 else ''
+			entries[field(line[4:7], 3) + b'\0'] = field(name, 32) + field(country, 32)
+	write_db('airlines.db', 4, 64, entries)
+
+def icao24(path):
+	entries = {}
+	reader = csv.DictReader(open(path, 'r'))
+	for row in reader:
+		try:
+			address = int(row['icao24'], 16)
+		except (KeyError, ValueError):
+			continue
+		owner = row.get('operator') or row.get('owner') or ''
+		entries[struct.pack('>I', address)[1:]] = field(row.get('registration', ''), 8) + field(row.get('typecode', ''), 8) + field(owner, 16)
+	write_db('icao24.db', 3, 32, entries)
+
+if len(sys.argv) < 2 or sys.argv[1] not in ('airlines', 'icao24'):
+	print('Usage: adsb_db.py airlines [airlines.txt | airlines.db]')
+	print('       adsb_db.py icao24 aircraftDatabase.csv')
+	sys.exit(1)
+
+if sys.argv[1] == 'airlines':
+	airlines(sys.argv[2] if len(sys.argv) > 2 else '../../sdcard/ADSB/airlines.txt')
+else:
+	icao24(sys.argv[2])
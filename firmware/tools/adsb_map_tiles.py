@@ -0,0 +1,113 @@
+#!/usr/bin/env python
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 2, or (at your option)
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; see the file COPYING.  If not, write to
+# the Free Software Foundation, Inc., 51 Franklin Street,
+# Boston, MA 02110-1301, USA.
+#
+
+# Tiled, run-length compressed version of world_map.bin for GeoMap.
+#
+# All values little-endian:
+#	char[4]		"PPTM"
+#	u16			version (1)
+#	u16			tile size (pixels, tiles are square)
+#	u16, u16	map width, map height (pixels)
+#	u16, u16	tiles across, tiles down
+#	u32[n + 1]	file offset of each tile (row by row), then end of data
+#	tile data
+#
+# Tiles are RGB565, row by row, padded with black past the map edges. Each
+# tile is a sequence of u16 headers: bit 15 set means the next word repeats
+# (header & 0x7FFF) times, clear means that many literal words follow.
+
+from __future__ import print_function
+import sys
+import struct
+from PIL import Image
+
+Image.MAX_IMAGE_PIXELS = None
+
+TILE_SIZE = 32
+RUN_MIN = 3
+COUNT_MAX = 0x7FFF
+
+def encode_tile(pixels):
+	out = []
+	literals = []
+
+	def flush_literals():
+		while literals:
+			chunk = literals[:COUNT_MAX]
+			del literals[:COUNT_MAX]
+			out.append(len(chunk))
+			out.extend(chunk)
+
+	i = 0
+	while i < len(pixels):
+		run = 1
+		while (i + run < len(pixels)) and (pixels[i + run] == pixels[i]) and (run < COUNT_MAX):
+			run += 1
+		if run >= RUN_MIN:
+			flush_literals()
+			out.append(0x8000 | run)
+			out.append(pixels[i])
+		else:
+			literals.extend(pixels[i:i + run])
+		i += run
+	flush_literals()
+
+	# Never larger than one literal block
+	if len(out) > len(pixels) + 1:
+		out = [len(pixels)] + pixels
+
+	return struct.pack('<%dH' % len(out), *out)
+
+im = Image.open("../../sdcard/ADSB/world_map.jpg").convert('RGB')
+pix = im.load()
+width, height = im.size
+
+tiles_x = (width + TILE_SIZE - 1) // TILE_SIZE
+tiles_y = (height + TILE_SIZE - 1) // TILE_SIZE
+
+header = b'PPTM' + struct.pack('<HHHHHH', 1, TILE_SIZE, width, height, tiles_x, tiles_y)
+offset = len(header) + (tiles_x * tiles_y + 1) * 4
+
+offsets = []
+tiles = []
+for ty in range(0, tiles_y):
+	for tx in range(0, tiles_x):
+		pixels = []
+		for y in range(ty * TILE_SIZE, (ty + 1) * TILE_SIZE):
+			for x in range(tx * TILE_SIZE, (tx + 1) * TILE_SIZE):
+				if (x < width) and (y < height):
+					r, g, b = pix[x, y]
+					pixels.append(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3))
+				else:
+					pixels.append(0)
+		data = encode_tile(pixels)
+		offsets.append(offset)
+		tiles.append(data)
+		offset += len(data)
+	print(str(ty + 1) + '/' + str(tiles_y) + '\r', end="")
+offsets.append(offset)
+
+outfile = open('../../sdcard/ADSB/world_map.tiles', 'wb')
+outfile.write(header)
+outfile.write(struct.pack('<%dI' % len(offsets), *offsets))
+for data in tiles:
+	outfile.write(data)
+outfile.close()
+
+print('')
+print('%d tiles, %d bytes (raw %d)' % (tiles_x * tiles_y, offset, 4 + width * height * 2))